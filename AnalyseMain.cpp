@@ -0,0 +1,119 @@
+/* This file contains the main function of the analyse tool, which analyses
+   a file of positions at once with a BatchAnalyzer. Usage:
+   >> analyse positions.epd
+   >> analyse positions.epd 6 8
+   Each line of the file is a position, whose first four fields are read
+   as in Extended Position Description. Empty lines and lines starting with
+   '#' are skipped. The number after the file is the depth each position is
+   searched to, 4 if it is left out, and the number after that is the
+   number of threads. If it is left out, one thread is used for every core.
+   For each position the status, the number of legal moves and the best
+   line found are printed. */
+
+#include "BatchAnalyzer.h"
+#include "GameState.h"
+#include "San.h"
+#include "Search.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Reads every position of the file with the input name into positions and
+   the line each one is on into lineNumbers. Returns false if the file
+   cannot be opened. */
+static bool readPositions(string const& fileName, vector<string>& positions,
+			  vector<int>& lineNumbers) {
+  ifstream file{fileName};
+  if (!file) {
+    return false;
+  }
+
+  string line;
+  int lineNumber = 0;
+  while (getline(file, line)) {
+    lineNumber++;
+    istringstream fields{line};
+    string placement, side, castling, enPassant;
+    if (!(fields >> placement) || placement[0] == '#') {
+      continue;
+    }
+    fields >> side >> castling >> enPassant;
+    positions.push_back(placement + " " + side + " " + castling + " " +
+			enPassant);
+    lineNumbers.push_back(lineNumber);
+  }
+  return true;
+}
+
+/* Outputs the line of the file the position is on and what result
+   found. */
+static void printResult(string const& fen, int lineNumber,
+			AnalysisResult const& result) {
+  cout << "Line " << lineNumber << ": ";
+  if (!result.isValid) {
+    cout << result.error << endl;
+    return;
+  }
+  cout << result.status << ", " << result.legalMoveCount << " legal moves";
+  if (result.search.hasBestMove) {
+    cout << ", score " << result.search.score << " at depth ";
+    cout << result.search.depth << ":";
+    for (string const& san : toSanLine(GameState{fen},
+				       result.search.principalVariation)) {
+      cout << " " << san;
+    }
+  }
+  cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 4) {
+    cerr << "Usage: analyse <position file> [depth] [threads]" << endl;
+    return 1;
+  }
+
+  vector<string> positions;
+  vector<int> lineNumbers;
+  if (!readPositions(argv[1], positions, lineNumbers)) {
+    cerr << "Position file " << argv[1] << " could not be opened" << endl;
+    return 1;
+  }
+  SearchLimits limits;
+  limits.depth = 4;
+  int threadCount = 0;
+  try {
+    limits.depth = (argc >= 3) ? stoi(argv[2]) : limits.depth;
+    threadCount = (argc == 4) ? stoi(argv[3]) : 0;
+  } catch (exception const& e) {
+    cerr << "The depth and threads must be numbers!" << endl;
+    return 1;
+  }
+  if (limits.depth < 1 || limits.depth > MAX_DEPTH) {
+    cerr << "The depth must be from 1 to " << MAX_DEPTH << "!" << endl;
+    return 1;
+  }
+
+  BatchAnalyzer analyzer{threadCount};
+  cout << "Analysing " << positions.size() << " positions with ";
+  cout << analyzer.getThreadCount() << " thread(s)" << endl;
+  auto start = chrono::steady_clock::now();
+  vector<AnalysisResult> results = analyzer.analyse(positions, limits);
+  long long milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  long long nodes = 0;
+  for (size_t i = 0; i < positions.size(); i++) {
+    printResult(positions[i], lineNumbers[i], results[i]);
+    nodes += results[i].search.nodes;
+  }
+  cout << positions.size() << " positions, " << nodes << " nodes in ";
+  cout << milliseconds << " ms, " << static_cast<long long>(positions.size()) *
+    1000 / max(milliseconds, 1LL) << " positions per second" << endl;
+  return 0;
+}
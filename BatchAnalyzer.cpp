@@ -0,0 +1,134 @@
+/* This file contains the member functions of the BatchAnalyzer class. */
+
+#include "BatchAnalyzer.h"
+#include "ChessBoard.h"
+#include "Search.h"
+#include "GameStatus.h"
+#include "constants.h"
+#include "errors.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+BatchAnalyzer::BatchAnalyzer(int threadCount) {
+  if (threadCount < 1) {
+    threadCount = static_cast<int>(thread::hardware_concurrency());
+  }
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  for (int i = 0; i < threadCount; i++) {
+    workers.emplace_back(&BatchAnalyzer::runWorker, this);
+  }
+}
+
+BatchAnalyzer::~BatchAnalyzer() {
+  {
+    lock_guard<std::mutex> lock{mutex};
+    isStopping = true;
+  }
+  batchStarted.notify_all();
+  for (thread& worker : workers) {
+    worker.join();
+  }
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+int BatchAnalyzer::getThreadCount() const {
+  return static_cast<int>(workers.size());
+}
+
+// ---------- Other functions --------------------------------------------------
+
+vector<AnalysisResult> BatchAnalyzer::analyse(vector<string> const& positions,
+					      SearchLimits limits) {
+  vector<AnalysisResult> results(positions.size());
+  if (positions.empty()) {
+    return results;
+  }
+
+  lock_guard<std::mutex> batchLock{batchMutex};
+  unique_lock<std::mutex> lock{mutex};
+  this->positions = &positions;
+  this->results = &results;
+  this->limits = limits;
+  nextPosition.store(0);
+  finishedCount = 0;
+  batchNumber++;
+  batchStarted.notify_all();
+
+  // Wait until every position is done and no worker is still looking at
+  // this batch, so that none of them can pick up the next batch's
+  // positions through this batch's pointers
+  batchFinished.wait(lock, [&] {
+    return finishedCount == positions.size() && activeWorkers == 0;
+  });
+  this->positions = nullptr;
+  this->results = nullptr;
+  return results;
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+void BatchAnalyzer::runWorker() {
+  // Each worker reuses one board and one Search for every position
+  ChessBoard board{START_FEN};
+  Search search{WORKER_TABLE_MEGABYTES};
+  unsigned lastBatch = 0;
+
+  while (true) {
+    vector<string> const* batchPositions;
+    vector<AnalysisResult>* batchResults;
+    SearchLimits batchLimits;
+    {
+      unique_lock<std::mutex> lock{mutex};
+      batchStarted.wait(lock, [&] {
+	return isStopping || batchNumber != lastBatch;
+      });
+      if (isStopping) {
+	return;
+      }
+      lastBatch = batchNumber;
+      if (positions == nullptr) {
+	// This batch has already been finished by the other workers
+	continue;
+      }
+      activeWorkers++;
+      batchPositions = positions;
+      batchResults = results;
+      batchLimits = limits;
+    }
+
+    size_t analysedCount = 0;
+    size_t i;
+    while ((i = nextPosition.fetch_add(1)) < batchPositions->size()) {
+      AnalysisResult& result = (*batchResults)[i];
+      try {
+	board.setPosition((*batchPositions)[i]);
+	result.isValid = true;
+	result.status = board.getStatus();
+	result.legalMoveCount = static_cast<int>(board.getLegalMoves().size());
+	result.search = search.run(board, batchLimits);
+      } catch (FenError const& e) {
+	result.error = e.what();
+      }
+      analysedCount++;
+    }
+
+    {
+      lock_guard<std::mutex> lock{mutex};
+      finishedCount += analysedCount;
+      activeWorkers--;
+      if (finishedCount == batchPositions->size() && activeWorkers == 0) {
+	batchFinished.notify_all();
+      }
+    }
+  }
+}
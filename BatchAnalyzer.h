@@ -0,0 +1,95 @@
+#ifndef BATCHANALYZER_H
+#define BATCHANALYZER_H
+
+#include "Search.h"
+#include "GameStatus.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Size of the TranspositionTable of each worker's Search, in megabytes. It
+// is kept small because there is one for every thread.
+const std::size_t WORKER_TABLE_MEGABYTES = 2;
+
+/* The AnalysisResult struct holds the analysis of one position.
+   isValid is false if the position could not be read, and error then holds
+   the reason. Otherwise status is whether the player to move is in check, 
+   checkmate or stalemate, legalMoveCount is the number of legal moves and 
+   search is the result of searching the position. */
+
+struct AnalysisResult {
+  bool isValid = false;
+  std::string error;
+  GameStatus status = InProgress;
+  int legalMoveCount = 0;
+  SearchResult search;
+};
+
+/* The BatchAnalyzer class owns a fixed pool of worker threads which analyse
+   batches of positions. Each worker keeps its own ChessBoard and Search for 
+   as long as the BatchAnalyzer exists, so no threads or boards are created
+   for each position. */
+
+class BatchAnalyzer {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a BatchAnalyzer object and starts threadCount workers. If 
+     threadCount is less than 1, one worker is started for every core. */
+  BatchAnalyzer(int threadCount = 0);
+
+  /* Destructor. Stops the workers and waits for them to finish. */
+  ~BatchAnalyzer();
+
+  BatchAnalyzer(BatchAnalyzer const&) = delete;
+  BatchAnalyzer& operator=(BatchAnalyzer const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of worker threads. */
+  int getThreadCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Analyses every position in positions, which are in Forsyth-Edwards
+     Notation, searching each one within limits. The positions are shared
+     out between the workers and the results are returned in the same order
+     as the positions. Only one batch is analysed at a time; a second caller
+     waits until the first batch is finished. */
+  std::vector<AnalysisResult> analyse(std::vector<std::string> const& positions,
+				      SearchLimits limits);
+
+private:
+  std::vector<std::thread> workers;
+
+  // The batch being analysed. These are only changed while batchMutex and
+  // mutex are both held, and no batch is in progress.
+  std::vector<std::string> const* positions = nullptr;
+  std::vector<AnalysisResult>* results = nullptr;
+  SearchLimits limits;
+  unsigned batchNumber = 0;
+  bool isStopping = false;
+
+  // Index of the next position to hand out, the number finished and the
+  // number of workers still working on the batch
+  std::atomic<std::size_t> nextPosition{0};
+  std::size_t finishedCount = 0;
+  int activeWorkers = 0;
+
+  std::mutex batchMutex;
+  std::mutex mutex;
+  std::condition_variable batchStarted;
+  std::condition_variable batchFinished;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* The function run by each worker thread. Waits for a batch, analyses 
+     positions until there are none left, and then waits for the next batch.*/
+  void runWorker();
+};
+
+#endif
@@ -0,0 +1,70 @@
+/* This file contains the main function of the bench tool, which times each
+   primitive of the rules engine over a fixed corpus of positions and
+   prints a table of nanoseconds per operation. Usage:
+   >> bench
+   >> bench 50
+   >> bench 50 latency.csv
+   The first input is the number of timed runs of each primitive. If it is
+   left out, BENCH_DEFAULT_RUNS runs are made. In a build with CHESS_STATS
+   defined, the counters and latencies of "Stats.h" and "Latency.h" are
+   printed after the table, and the second input, if given, is a file to
+   write the latency histograms to for other programs to read. */
+
+#include "Benchmark.h"
+#include "Stats.h"
+#include "Latency.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  if (argc > 3) {
+    cerr << "Usage: bench [runs] [latency file]" << endl;
+    return 1;
+  }
+
+  int runs = BENCH_DEFAULT_RUNS;
+  if (argc >= 2) {
+    try {
+      runs = stoi(argv[1]);
+    } catch (exception const& e) {
+      runs = 0;
+    }
+    if (runs < 1) {
+      cerr << "The number of runs must be a positive number!" << endl;
+      return 1;
+    }
+  }
+
+  Benchmark benchmark;
+  cout << benchmark.getPositionCount() << " positions, " << runs;
+  cout << " runs of each primitive, after " << BENCH_WARMUP_RUNS;
+  cout << " warm-up runs, in nanoseconds per operation" << endl << endl;
+  cout << left << setw(28) << "primitive" << right << setw(9) << "ops/run";
+  cout << setw(10) << "min" << setw(10) << "p10" << setw(10) << "median";
+  cout << setw(10) << "p90" << endl;
+
+  for (BenchmarkResult const& result : benchmark.run(runs)) {
+    cout << result << endl;
+  }
+  cout << endl << "Checksum: " << benchmark.getChecksum() << endl;
+
+  // The counters cover every run, including the warm-up runs
+  if (isStatsEnabled()) {
+    EngineLatencies latencies = getLatencies();
+    cout << endl << getStats() << endl << latencies;
+    if (argc == 3) {
+      ofstream latencyFile{argv[2]};
+      printLatencyCsv(latencyFile, latencies);
+      if (!latencyFile) {
+	cerr << argv[2] << " could not be written!" << endl;
+	return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,243 @@
+/* This file contains the member functions of the Benchmark class. */
+
+#include "Benchmark.h"
+#include "ChessBoard.h"
+#include "Piece.h"
+#include "PieceType.h"
+#include "Player.h"
+#include "Square.h"
+#include "Move.h"
+#include "NullBuffer.h"
+#include "constants.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* The corpus of positions, in Forsyth-Edwards Notation. The first six are
+   middlegames, including a checkmate and a check, and the rest are
+   endgames. */
+static const vector<string> CORPUS_FENS = {
+  "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+  "r2q1rk1/pp2bppp/2n1pn2/3p4/3P4/2NBPN2/PP3PPP/R2Q1RK1 w - - 0 1",
+  "2rq1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PN1PN2/PB1QBPPP/2R2RK1 b - - 0 1",
+  "rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3",
+  "r1bqk2r/pppp1ppp/2n2n2/4p3/1b2P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 4 4",
+  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+  "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+  "8/8/4k3/8/2P5/8/4K3/8 w - - 0 1",
+  "8/5k2/8/8/3R4/8/8/4K3 b - - 0 1",
+  "8/8/8/3q4/8/8/1K6/7k w - - 0 1",
+  "4k3/8/8/8/8/8/4r3/R3K3 w Q - 0 1"
+};
+
+/* Returns the value at fraction of the way through the sorted values. */
+static double getPercentile(vector<double> const& sorted, double fraction) {
+  size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+ostream& operator<<(ostream& os, const BenchmarkResult& result) {
+  os << left << setw(28) << result.name << right << setw(9);
+  os << result.operations << fixed << setprecision(1);
+  os << setw(10) << result.minimum << setw(10) << result.p10;
+  os << setw(10) << result.median << setw(10) << result.p90;
+  os.unsetf(ios::fixed);
+  return os;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Benchmark::Benchmark() {
+  // The Pieces refer to their board, so the boards must not be moved once
+  // the moves have been worked out
+  boards.reserve(CORPUS_FENS.size());
+  for (string const& fen : CORPUS_FENS) {
+    boards.emplace_back(fen);
+  }
+
+  for (int position = 0; position < getPositionCount(); position++) {
+    ChessBoard& board = boards[position];
+    for (int i = 0; i < 64; i++) {
+      Square source{i / BOARD_WIDTH, i % BOARD_WIDTH};
+      Piece* piece = board.getPiece(source);
+      if (piece == nullptr) {
+	continue;
+      }
+      for (int j = 0; j < 64; j++) {
+	if (i == j) {
+	  continue;
+	}
+	Square destination{j / BOARD_WIDTH, j % BOARD_WIDTH};
+	Move move{source, destination};
+	possibleMoves[piece->getType()].push_back({position, move});
+	if (piece->getColour() == board.getPlayer() &&
+	    piece->isMovePossible(source, destination)) {
+	  legalityMoves.push_back({position, move});
+	}
+      }
+    }
+
+    for (Move const& move : board.getLegalMoves()) {
+      submitMoves.push_back({position, move});
+      CorpusInput input{position, "", ""};
+      if (move.isCastle()) {
+	input.source = (board.getPlayer() == White) ? "W" : "B";
+	input.destination = (move.isKingsideCastle()) ? "O-O" : "O-O-O";
+      } else {
+	ostringstream source, destination;
+	source << move.getSource();
+	destination << move.getDestination();
+	input.source = source.str();
+	input.destination = destination.str();
+      }
+      submitInputs.push_back(input);
+    }
+  }
+}
+
+Benchmark::~Benchmark() {}
+
+// ---------- Getter functions -------------------------------------------------
+
+int Benchmark::getPositionCount() const {
+  return static_cast<int>(boards.size());
+}
+
+long long Benchmark::getChecksum() const {
+  return checksum;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+vector<BenchmarkResult> Benchmark::run(int runs) {
+  vector<BenchmarkResult> results;
+
+  for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+    ostringstream name;
+    name << "isMovePossible " << static_cast<PieceType>(type);
+    vector<CorpusMove> const& moves = possibleMoves[type];
+    results.push_back(measure(name.str(), moves.size(), runs, [&] {
+      long long count = 0;
+      for (CorpusMove const& entry : moves) {
+	ChessBoard& board = boards[entry.position];
+	Square source = entry.move.getSource();
+	count += board.getPiece(source)->isMovePossible(
+	  source, entry.move.getDestination());
+      }
+      return count;
+    }));
+  }
+
+  results.push_back(measure("isMoveLegal", legalityMoves.size(), runs, [&] {
+    long long count = 0;
+    for (CorpusMove const& entry : legalityMoves) {
+      count += boards[entry.position].isMoveLegal(entry.move.getSource(),
+						  entry.move.getDestination());
+    }
+    return count;
+  }));
+
+  results.push_back(measure("ChessBoard copy constructor", boards.size(),
+			    runs, [&] {
+    long long count = 0;
+    for (ChessBoard const& board : boards) {
+      ChessBoard copy{board};
+      count += copy.getPlayer();
+    }
+    return count;
+  }));
+
+  results.push_back(measure("isPlayerInCheck", 2 * boards.size(), runs, [&] {
+    long long count = 0;
+    for (ChessBoard const& board : boards) {
+      count += board.isPlayerInCheck(White) + board.isPlayerInCheck(Black);
+    }
+    return count;
+  }));
+
+  results.push_back(measure("isPlayerInCheckmate", boards.size(), runs, [&] {
+    long long count = 0;
+    for (ChessBoard& board : boards) {
+      count += board.isPlayerInCheckmate(board.getPlayer());
+    }
+    return count;
+  }));
+
+  // submitMove() writes a message for every move
+  NullBuffer nullBuffer;
+  streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+  results.push_back(measure("submitMove + takeback", submitInputs.size(),
+			    runs, [&] {
+    long long count = 0;
+    for (CorpusInput const& input : submitInputs) {
+      ChessBoard& board = boards[input.position];
+      board.submitMove(input.source, input.destination);
+      count += board.takeback();
+    }
+    return count;
+  }));
+  results.push_back(measure("submitMove(Move) + takeback", submitMoves.size(),
+			    runs, [&] {
+    long long count = 0;
+    for (CorpusMove const& entry : submitMoves) {
+      ChessBoard& board = boards[entry.position];
+      board.submitMove(entry.move);
+      count += board.takeback();
+    }
+    return count;
+  }));
+  cout.rdbuf(coutBuffer);
+
+  return results;
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+template <typename Operation>
+BenchmarkResult Benchmark::measure(string const& name, long long operations,
+				   int runs, Operation operation) {
+  typedef chrono::steady_clock Clock;
+  checksum += operation();
+  auto timeRun = [&](long long repeats) {
+    auto start = Clock::now();
+    for (long long i = 0; i < repeats; i++) {
+      sink += operation();
+    }
+    return chrono::duration_cast<chrono::nanoseconds>(
+      Clock::now() - start).count();
+  };
+
+  // Find how many times the operations must be repeated for a run to be
+  // long enough, which also warms up
+  long long repeats = 1;
+  while (timeRun(repeats) < BENCH_MIN_RUN_NANOSECONDS) {
+    repeats *= 2;
+  }
+  for (int i = 0; i < BENCH_WARMUP_RUNS; i++) {
+    timeRun(repeats);
+  }
+
+  vector<double> timings;
+  for (int i = 0; i < runs; i++) {
+    timings.push_back(static_cast<double>(timeRun(repeats)) /
+		      (repeats * max(operations, 1LL)));
+  }
+  sort(timings.begin(), timings.end());
+
+  BenchmarkResult result;
+  result.name = name;
+  result.operations = operations;
+  result.minimum = timings.front();
+  result.p10 = getPercentile(timings, 0.1);
+  result.median = getPercentile(timings, 0.5);
+  result.p90 = getPercentile(timings, 0.9);
+  return result;
+}
@@ -0,0 +1,128 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "ChessBoard.h"
+#include "Move.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Number of runs made before the timed runs of each primitive, so that the
+// caches and the branch predictors are warm
+const int BENCH_WARMUP_RUNS = 3;
+
+// Number of timed runs of each primitive if no other number is given
+const int BENCH_DEFAULT_RUNS = 25;
+
+// Shortest time a single run should take, in nanoseconds. A run repeats the
+// operations of a primitive until it takes at least this long, so that the
+// resolution of the clock does not matter.
+const long long BENCH_MIN_RUN_NANOSECONDS = 2000000;
+
+/* The BenchmarkResult struct holds the timings of one primitive, each in
+   nanoseconds per operation.
+   name is the name of the primitive, e.g. "isMoveLegal".
+   operations is the number of operations timed in each run.
+   minimum, p10, median and p90 are the fastest run, the 10th percentile,
+   the median and the 90th percentile of the runs. */
+
+struct BenchmarkResult {
+  std::string name;
+  long long operations = 0;
+  double minimum = 0.0;
+  double p10 = 0.0;
+  double median = 0.0;
+  double p90 = 0.0;
+};
+
+/* This function allows a BenchmarkResult to be output to the output stream
+   specified, as one row of a table whose columns are the name, the
+   operations per run, and the minimum, 10th percentile, median and 90th
+   percentile in nanoseconds per operation. */
+std::ostream& operator<<(std::ostream& os, const BenchmarkResult& result);
+
+/* The Benchmark class times the primitives of the rules engine one at a
+   time, so that a change which slows one of them down can be found even if
+   the whole game does not get noticeably slower. The primitives are
+   Piece::isMovePossible() for each PieceType, ChessBoard::isMoveLegal(),
+   the ChessBoard copy constructor, isPlayerInCheck(), isPlayerInCheckmate()
+   and submitMove(). Each one is timed over the same fixed corpus of
+   middlegame and endgame positions:
+   - isMovePossible() from every square with a Piece of the type to every
+     other square,
+   - isMoveLegal() for every move which isMovePossible() allows the player
+     to move,
+   - isPlayerInCheck() for both players, isPlayerInCheckmate() for the
+     player to move and the copy constructor for each position,
+   - submitMove() for every legal move, each followed by a takeback() to
+     get the position back, once with the squares as strings and once as
+     a Move. Its messages are thrown away.
+   A primitive is run BENCH_WARMUP_RUNS times before it is timed, and the
+   spread of the timed runs is reported as well as the median. */
+
+class Benchmark {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a Benchmark object and sets up the corpus of positions. */
+  Benchmark();
+
+  /* Destructor. */
+  ~Benchmark();
+
+  Benchmark(Benchmark const&) = delete;
+  Benchmark& operator=(Benchmark const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of positions in the corpus. */
+  int getPositionCount() const;
+
+  /* Returns the sum of what the primitives returned over one pass of the
+     corpus. It is the same for every build of the same rules, so a
+     different checksum means the primitives being timed now do something
+     else. */
+  long long getChecksum() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Times every primitive with runs timed runs each, and returns their
+     results in the order listed above. */
+  std::vector<BenchmarkResult> run(int runs);
+
+private:
+  /* A move in one of the positions of the corpus. */
+  struct CorpusMove {
+    int position;
+    Move move;
+  };
+
+  /* A move in one of the positions of the corpus, as the inputs of
+     submitMove(). */
+  struct CorpusInput {
+    int position;
+    std::string source;
+    std::string destination;
+  };
+
+  std::vector<ChessBoard> boards;
+  std::vector<CorpusMove> possibleMoves[PIECE_TYPE_COUNT];
+  std::vector<CorpusMove> legalityMoves;
+  std::vector<CorpusInput> submitInputs;
+  std::vector<CorpusMove> submitMoves;
+  long long checksum = 0;
+  long long sink = 0;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Runs operation, which carries out operations operations and returns
+     the sum of their results, once for the checksum and BENCH_WARMUP_RUNS
+     times to warm up. Then runs it runs more times, timing each run, and
+     returns the timings. The results of the timed runs are added to sink,
+     so that the calls cannot be left out by the compiler. */
+  template <typename Operation>
+  BenchmarkResult measure(std::string const& name, long long operations,
+			  int runs, Operation operation);
+};
+
+#endif
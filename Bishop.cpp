@@ -4,10 +4,12 @@
 #include "Piece.h"
 #include "Player.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
@@ -15,46 +17,29 @@ using namespace std;
 // ---------- Contructors, destructors and operator overloads ------------------
 
 Bishop::Bishop(Player colour, ChessBoard& board) :
-    Piece(colour, board, "Bishop") {}
+    Piece(colour, board, BishopType) {}
 
 Bishop::Bishop(Bishop const& otherBishop, ChessBoard& board) :
-  Piece(otherBishop.colour, board, otherBishop.name) {}
+  Piece(otherBishop, board) {}
 
 Bishop::~Bishop() {}
 
 // ---------- Checker functions ------------------------------------------------
 
 bool Bishop::isMovePossible(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(BishopMovePossibleCount);
+
   int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
   int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
 
   bool isAlongDiagonal = (abs(rankChange) == abs(fileChange) &&
 			  !(rankChange == 0 && fileChange == 0));
 
-  bool pathIsClear = true;
-
-  // If it is a move along the diagonal, set the number of squares
-  // in the path to the absolute change in rank (could also be set to
-  // the absolute change in file as they are equal). If isAlongDiagonal is
-  // false then don't need to check path because move is not possible anyway.
-  int pathSteps = (isAlongDiagonal) ? abs(rankChange) : 0;
+  // The squares in between must be empty. If the move is not along a
+  // diagonal then it is not possible anyway, so the path is not checked.
+  bool pathIsClear = (isAlongDiagonal &&
+		      board.isPathClear(sourceSquare, destinationSquare));
 
-  try {
-    for (int i = 1; i < pathSteps; i++) {
-      int rankStep =  i * rankChange / abs(rankChange);
-      int fileStep =  i * fileChange / abs(fileChange);
-
-      Square squareInPath = Square(sourceSquare.getRank() + rankStep,
-				   sourceSquare.getFile() + fileStep);
-      
-      pathIsClear = (pathIsClear && !board.isPieceThere(squareInPath));
-    }
-  } catch (OffBoardError const& e) {
-    // Path is not clear if move goes off board
-    pathIsClear = false;
-  }
-
-  
   bool destinationIsFree = !board.isPieceThere(destinationSquare);
   
   bool isTakingOpponent = board.isOpponentPieceThere(destinationSquare,
@@ -106,6 +91,6 @@ bool Bishop::isAnyLegalMovePossible(Square square) {
 
 // ---------- Other functions --------------------------------------------------
 
-Piece* Bishop::copyPiece(ChessBoard& board) {
-  return (new Bishop{*this, board});
+Piece* Bishop::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) Bishop{*this, board});
 }
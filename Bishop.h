@@ -14,7 +14,7 @@
    variables: 
    Player colour - contains the colour of the Bishop
    ChessBoard& board - reference to the ChessBoard object which owns the Bishop
-   std::string name - the name of the Piece, in this case "Bishop"
+   PieceType type - the kind of Piece, in this case BishopType
    bool hasMoved - false if the Bishop has not moved yet */
 
 class Bishop : public Piece {
@@ -22,7 +22,7 @@ public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
   /* Constructs a Bishop object with colour and board set to the input 
-     variables, name set to "Bishop" and hasMoved set to false.*/
+     variables, type set to BishopType and hasMoved set to false.*/
   Bishop(Player colour, ChessBoard& board);
 
   /* Constructs a Bishop object which is a copy of the input Bishop object, 
@@ -47,10 +47,11 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a Piece pointer to a copy of the Bishop object on which this 
-     function is called, but with the ChessBoard reference of the new object set 
-     to the board input. */
-  Piece* copyPiece(ChessBoard& board) override;
+  /* Constructs a copy of the Bishop object on which this function is called in
+     storage, a PieceArena slot of the board input, and returns a Piece
+     pointer to it. The ChessBoard reference of the new object is set to the
+     board input. */
+  Piece* copyPiece(ChessBoard& board, void* storage) override;
 };
 
 #endif
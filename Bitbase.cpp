@@ -0,0 +1,659 @@
+/* This file contains the member functions of the Bitbase class and the
+   operator overloads for the Endgame and BitbaseResult enumerations. */
+
+#include "Bitbase.h"
+#include "Bitboard.h"
+#include "ChessBoard.h"
+#include "Square.h"
+#include "Player.h"
+#include "constants.h"
+#include "errors.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Values used while the Bitbase is being generated. The final results
+// Unknown, Draw, Win and Loss are stored as they are.
+const uint8_t UNDECIDED = 4;
+
+// Most legal moves in any position of these endings (8 King + 27 Queen)
+const int MAX_SUCCESSORS = 35;
+
+// Number of squares the strong King is kept to when there are no Pawns,
+// and the number of squares a Pawn on files A-D can stand on
+const int TRIANGLE_SQUARES = 10;
+const int PAWN_SQUARES = 28;
+
+// Squares of the A1-D1-D4 triangle, and the index of each square in it
+const int TRIANGLE[TRIANGLE_SQUARES] = {0, 1, 2, 3, 9, 10, 11, 18, 19, 27};
+const int NOT_IN_TRIANGLE = -1;
+
+const char FILE_MAGIC[] = "CHESSBB1";
+const int FILE_MAGIC_LENGTH = 8;
+
+/* Returns the square on the same file and the opposite rank. */
+static int flipRank(int square) {
+  return squareAt(MAX_RANK - rankOf(square), fileOf(square));
+}
+
+/* Returns the square on the same rank and the opposite file. */
+static int flipFile(int square) {
+  return squareAt(rankOf(square), MAX_FILE - fileOf(square));
+}
+
+/* Returns the square reflected in the A1-H8 diagonal. */
+static int flipDiagonal(int square) {
+  return squareAt(fileOf(square), rankOf(square));
+}
+
+/* Returns the successor standing for a position of another ending, whose
+   result for the player to move is already known. It is below 0, so it is
+   never an index. */
+static int getKnownSuccessor(BitbaseResult result) {
+  return -1 - result;
+}
+
+/* Returns the index of the square within the A1-D1-D4 triangle. */
+static int triangleIndex(int square) {
+  for (int i = 0; i < TRIANGLE_SQUARES; i++) {
+    if (TRIANGLE[i] == square) {
+      return i;
+    }
+  }
+  return NOT_IN_TRIANGLE;
+}
+
+// ---------- Enumeration operator overloads -----------------------------------
+
+ostream& operator<<(ostream& os, const Endgame& endgame) {
+  switch (endgame) {
+  case KPK: os << "KPK"; break;
+  case KRK: os << "KRK"; break;
+  case KQK: os << "KQK"; break;
+  case KQKR: os << "KQKR"; break;
+  case KRKR: os << "KRKR"; break;
+  }
+  return os;
+}
+
+ostream& operator<<(ostream& os, const BitbaseResult& result) {
+  switch (result) {
+  case Unknown: os << "Unknown"; break;
+  case Draw: os << "Draw"; break;
+  case Win: os << "Win"; break;
+  case Loss: os << "Loss"; break;
+  }
+  return os;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Bitbase::Bitbase(Endgame endgame) : endgame(endgame) {
+  int kingSquares = (endgame == KPK) ? NUMBER_OF_SQUARES : TRIANGLE_SQUARES;
+  int pieceSquares = (endgame == KPK) ? PAWN_SQUARES : NUMBER_OF_SQUARES;
+  positionCount = 2 * kingSquares * NUMBER_OF_SQUARES * pieceSquares;
+  if (hasWeakPiece()) {
+    positionCount *= NUMBER_OF_SQUARES;
+  }
+}
+
+Bitbase::~Bitbase() {}
+
+// ---------- Getter functions -------------------------------------------------
+
+Endgame Bitbase::getEndgame() const {
+  return endgame;
+}
+
+int Bitbase::getPositionCount() const {
+  return positionCount;
+}
+
+int Bitbase::count(BitbaseResult result) const {
+  int total = 0;
+  for (int i = 0; i < positionCount; i++) {
+    if (getResult(i) == result) {
+      total++;
+    }
+  }
+  return total;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void Bitbase::generate(int threadCount) {
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+
+  // Captures lead to the three-piece endings, which are worked out first
+  unique_ptr<Bitbase> strongCapture;
+  unique_ptr<Bitbase> weakCapture;
+  if (hasWeakPiece()) {
+    strongCapture.reset(new Bitbase{getStrongCaptureEndgame()});
+    strongCapture->generate(threadCount);
+    strongCaptureBitbase = strongCapture.get();
+    weakCaptureBitbase = strongCaptureBitbase;
+    if (getWeakCaptureEndgame() != getStrongCaptureEndgame()) {
+      weakCapture.reset(new Bitbase{getWeakCaptureEndgame()});
+      weakCapture->generate(threadCount);
+      weakCaptureBitbase = weakCapture.get();
+    }
+  }
+
+  unique_ptr<atomic<uint8_t>[]> results{new atomic<uint8_t>[positionCount]};
+  atomic<bool> isChanged{false};
+
+  // First pass: mark positions which are not legal, and find the checkmates
+  // and stalemates. Later passes: a position is won if a move leads to a
+  // position lost for the opponent, and lost if every move leads to a
+  // position won for the opponent.
+  auto runPass = [&](bool isFirstPass, int begin, int end) {
+    int successors[MAX_SUCCESSORS];
+    for (int i = begin; i < end; i++) {
+      if (!isFirstPass &&
+	  results[i].load(memory_order_relaxed) != UNDECIDED) {
+	continue;
+      }
+      int successorCount = getSuccessors(i, successors);
+
+      if (isFirstPass) {
+	uint8_t result = UNDECIDED;
+	if (successorCount < 0) {
+	  result = Unknown;
+	} else if (successorCount == 0) {
+	  // With no moves, being in check is checkmate
+	  bool strongToMove;
+	  int strongKing, strongPiece, weakKing, weakPiece;
+	  getPosition(i, strongToMove, strongKing, strongPiece, weakKing,
+		      weakPiece);
+	  result = (isInCheck(strongToMove, strongKing, strongPiece, weakKing,
+			      weakPiece)) ? Loss : Draw;
+	}
+	results[i].store(result, memory_order_relaxed);
+	continue;
+      }
+
+      bool isAnyOpponentLoss = false;
+      bool isEveryOpponentWin = true;
+      for (int s = 0; s < successorCount; s++) {
+	uint8_t result = (successors[s] < 0) ?
+	  static_cast<uint8_t>(-1 - successors[s]) :
+	  results[successors[s]].load(memory_order_relaxed);
+	isAnyOpponentLoss = isAnyOpponentLoss || (result == Loss);
+	isEveryOpponentWin = isEveryOpponentWin && (result == Win);
+      }
+      if (isAnyOpponentLoss || isEveryOpponentWin) {
+	results[i].store((isAnyOpponentLoss) ? Win : Loss,
+			 memory_order_relaxed);
+	isChanged.store(true, memory_order_relaxed);
+      }
+    }
+  };
+
+  auto runPassInParallel = [&](bool isFirstPass) {
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+      int begin = static_cast<int>(static_cast<long long>(positionCount) *
+				   t / threadCount);
+      int end = static_cast<int>(static_cast<long long>(positionCount) *
+				 (t + 1) / threadCount);
+      threads.emplace_back(runPass, isFirstPass, begin, end);
+    }
+    for (thread& t : threads) {
+      t.join();
+    }
+  };
+
+  runPassInParallel(true);
+  do {
+    isChanged.store(false);
+    runPassInParallel(false);
+  } while (isChanged.load());
+
+  // Pack the results, four to a byte. Anything still undecided is a draw.
+  table.assign((positionCount + 3) / 4, 0);
+  for (int i = 0; i < positionCount; i++) {
+    uint8_t result = results[i].load(memory_order_relaxed);
+    if (result == UNDECIDED) {
+      result = Draw;
+    }
+    table[i / 4] |= static_cast<uint8_t>(result << (2 * (i % 4)));
+  }
+  strongCaptureBitbase = nullptr;
+  weakCaptureBitbase = nullptr;
+}
+
+void Bitbase::save(string const& fileName) const {
+  ofstream file{fileName, ios::binary};
+  if (!file) {
+    throw BitbaseError{fileName, "could not be opened"};
+  }
+
+  uint8_t header[FILE_MAGIC_LENGTH + 5];
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    header[i] = static_cast<uint8_t>(FILE_MAGIC[i]);
+  }
+  header[FILE_MAGIC_LENGTH] = static_cast<uint8_t>(endgame);
+  for (int i = 0; i < 4; i++) {
+    header[FILE_MAGIC_LENGTH + 1 + i] =
+      static_cast<uint8_t>(positionCount >> (8 * i));
+  }
+
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(table.data()), table.size());
+  if (!file) {
+    throw BitbaseError{fileName, "could not be written"};
+  }
+}
+
+void Bitbase::load(string const& fileName) {
+  ifstream file{fileName, ios::binary};
+  if (!file) {
+    throw BitbaseError{fileName, "could not be opened"};
+  }
+
+  uint8_t header[FILE_MAGIC_LENGTH + 5];
+  file.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!file) {
+    throw BitbaseError{fileName, "is too short"};
+  }
+
+  bool isCorrectMagic = true;
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    isCorrectMagic = isCorrectMagic && (header[i] == FILE_MAGIC[i]);
+  }
+  int fileCount = 0;
+  for (int i = 0; i < 4; i++) {
+    fileCount |= header[FILE_MAGIC_LENGTH + 1 + i] << (8 * i);
+  }
+  if (!isCorrectMagic ||
+      header[FILE_MAGIC_LENGTH] != static_cast<uint8_t>(endgame) ||
+      fileCount != positionCount) {
+    throw BitbaseError{fileName, "does not hold the expected bitbase"};
+  }
+
+  vector<uint8_t> newTable((positionCount + 3) / 4);
+  file.read(reinterpret_cast<char*>(newTable.data()), newTable.size());
+  if (!file) {
+    throw BitbaseError{fileName, "is too short"};
+  }
+  table.swap(newTable);
+}
+
+BitbaseResult Bitbase::probe(Player strongSide, Square strongKing,
+			     Square strongPiece, Square weakKing,
+			     Player playerToMove) const {
+  if (hasWeakPiece()) {
+    return Unknown;
+  }
+  int strongKingIndex = strongKing.getIndex();
+  int strongPieceIndex = strongPiece.getIndex();
+  int weakKingIndex = weakKing.getIndex();
+
+  // Positions are stored with the strong side as White
+  if (strongSide == Black) {
+    strongKingIndex = flipRank(strongKingIndex);
+    strongPieceIndex = flipRank(strongPieceIndex);
+    weakKingIndex = flipRank(weakKingIndex);
+  }
+
+  int index = getIndex(playerToMove == strongSide, strongKingIndex,
+		       strongPieceIndex, weakKingIndex);
+  if (index < 0 || table.empty()) {
+    return Unknown;
+  }
+  return getResult(index);
+}
+
+BitbaseResult Bitbase::probe(Player strongSide, Square strongKing,
+			     Square strongPiece, Square weakKing,
+			     Square weakPiece, Player playerToMove) const {
+  if (!hasWeakPiece() || table.empty()) {
+    return Unknown;
+  }
+
+  // Without Pawns, the board can be flipped over, so the strong side does
+  // not have to be White
+  int index = getIndex(playerToMove == strongSide, strongKing.getIndex(),
+		       strongPiece.getIndex(), weakKing.getIndex(),
+		       weakPiece.getIndex());
+  return getResult(index);
+}
+
+BitbaseResult Bitbase::probe(ChessBoard const& board) const {
+  string pieceName = (endgame == KPK) ? "Pawn" :
+    ((endgame == KRK || endgame == KRKR) ? "Rook" : "Queen");
+
+  // Find the Pieces of the ending, and make sure there are no others. In
+  // KRKR the White Rook is taken as the strong Piece.
+  Piece* kings[2] = {nullptr, nullptr};
+  Square kingSquares[2];
+  Piece* strongPiece = nullptr;
+  Square strongPieceSquare;
+  Piece* weakPiece = nullptr;
+  Square weakPieceSquare;
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      Piece* piece = board.board[i][j];
+      if (piece == nullptr) {
+	continue;
+      }
+      if (piece->getName() == "King") {
+	kings[piece->getColour()] = piece;
+	kingSquares[piece->getColour()] = Square{i, j};
+      } else if (piece->getName() == pieceName && strongPiece == nullptr &&
+		 (endgame != KRKR || piece->getColour() == White)) {
+	strongPiece = piece;
+	strongPieceSquare = Square{i, j};
+      } else if (hasWeakPiece() && piece->getName() == "Rook" &&
+		 weakPiece == nullptr) {
+	weakPiece = piece;
+	weakPieceSquare = Square{i, j};
+      } else {
+	return Unknown;
+      }
+    }
+  }
+  if (kings[White] == nullptr || kings[Black] == nullptr ||
+      strongPiece == nullptr) {
+    return Unknown;
+  }
+  if (hasWeakPiece() && (weakPiece == nullptr ||
+			 weakPiece->getColour() == strongPiece->getColour())) {
+    return Unknown;
+  }
+
+  Player strongSide = strongPiece->getColour();
+
+  // The Bitbase does not know about castling
+  Piece* rooks[2] = {(pieceName == "Rook") ? strongPiece : nullptr,
+		     weakPiece};
+  for (Piece* rook : rooks) {
+    if (rook != nullptr && rook->isFirstMove() &&
+	kings[rook->getColour()]->isFirstMove()) {
+      return Unknown;
+    }
+  }
+
+  if (hasWeakPiece()) {
+    return probe(strongSide, kingSquares[strongSide], strongPieceSquare,
+		 kingSquares[!strongSide], weakPieceSquare, board.player);
+  }
+  return probe(strongSide, kingSquares[strongSide], strongPieceSquare,
+	       kingSquares[!strongSide], board.player);
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+bool Bitbase::hasWeakPiece() const {
+  return endgame == KQKR || endgame == KRKR;
+}
+
+int Bitbase::getIndex(bool strongToMove, int strongKing, int strongPiece,
+		      int weakKing, int weakPiece) const {
+  int sideIndex = (strongToMove) ? 0 : 1;
+
+  if (endgame == KPK) {
+    if (fileOf(strongPiece) > MAX_FILE / 2) {
+      strongKing = flipFile(strongKing);
+      strongPiece = flipFile(strongPiece);
+      weakKing = flipFile(weakKing);
+    }
+    if (rankOf(strongPiece) == MIN_RANK) {
+      return -1;
+    }
+    int pawnIndex = (rankOf(strongPiece) - 1) * 4 + fileOf(strongPiece);
+    return ((sideIndex * NUMBER_OF_SQUARES + strongKing) * NUMBER_OF_SQUARES +
+	    weakKing) * PAWN_SQUARES + pawnIndex;
+  }
+
+  // Turn the board so that the strong King is in the A1-D1-D4 triangle
+  bool isWeakPiece = hasWeakPiece();
+  if (fileOf(strongKing) > MAX_FILE / 2) {
+    strongKing = flipFile(strongKing);
+    strongPiece = flipFile(strongPiece);
+    weakKing = flipFile(weakKing);
+    weakPiece = (isWeakPiece) ? flipFile(weakPiece) : weakPiece;
+  }
+  if (rankOf(strongKing) > MAX_RANK / 2) {
+    strongKing = flipRank(strongKing);
+    strongPiece = flipRank(strongPiece);
+    weakKing = flipRank(weakKing);
+    weakPiece = (isWeakPiece) ? flipRank(weakPiece) : weakPiece;
+  }
+  if (rankOf(strongKing) > fileOf(strongKing)) {
+    strongKing = flipDiagonal(strongKing);
+    strongPiece = flipDiagonal(strongPiece);
+    weakKing = flipDiagonal(weakKing);
+    weakPiece = (isWeakPiece) ? flipDiagonal(weakPiece) : weakPiece;
+  }
+  int kingIndex = triangleIndex(strongKing);
+  int index = ((sideIndex * TRIANGLE_SQUARES + kingIndex) * NUMBER_OF_SQUARES +
+	       weakKing) * NUMBER_OF_SQUARES + strongPiece;
+  return (isWeakPiece) ? index * NUMBER_OF_SQUARES + weakPiece : index;
+}
+
+void Bitbase::getPosition(int index, bool& strongToMove, int& strongKing,
+			  int& strongPiece, int& weakKing,
+			  int& weakPiece) const {
+  weakPiece = -1;
+  if (hasWeakPiece()) {
+    weakPiece = index % NUMBER_OF_SQUARES;
+    index /= NUMBER_OF_SQUARES;
+  }
+  if (endgame == KPK) {
+    int pawnIndex = index % PAWN_SQUARES;
+    index /= PAWN_SQUARES;
+    strongPiece = squareAt(pawnIndex / 4 + 1, pawnIndex % 4);
+    weakKing = index % NUMBER_OF_SQUARES;
+    index /= NUMBER_OF_SQUARES;
+    strongKing = index % NUMBER_OF_SQUARES;
+    index /= NUMBER_OF_SQUARES;
+  } else {
+    strongPiece = index % NUMBER_OF_SQUARES;
+    index /= NUMBER_OF_SQUARES;
+    weakKing = index % NUMBER_OF_SQUARES;
+    index /= NUMBER_OF_SQUARES;
+    strongKing = TRIANGLE[index % TRIANGLE_SQUARES];
+    index /= TRIANGLE_SQUARES;
+  }
+  strongToMove = (index == 0);
+}
+
+int Bitbase::getSuccessors(int index, int* successors) const {
+  bool strongToMove;
+  int strongKing, strongPiece, weakKing, weakPiece;
+  getPosition(index, strongToMove, strongKing, strongPiece, weakKing,
+	      weakPiece);
+
+  Bitboard strongKingBit = squareBit(strongKing);
+  Bitboard strongPieceBit = squareBit(strongPiece);
+  Bitboard weakKingBit = squareBit(weakKing);
+  Bitboard occupied = strongKingBit | strongPieceBit | weakKingBit;
+  if (weakPiece >= 0) {
+    occupied |= squareBit(weakPiece);
+  }
+
+  // Positions which are not legal: two Pieces on one square, the Kings
+  // next to each other, or the player who is not to move in check
+  if (popCount(occupied) != ((weakPiece >= 0) ? 4 : 3) ||
+      (kingAttacks(strongKing) & weakKingBit) ||
+      isInCheck(!strongToMove, strongKing, strongPiece, weakKing, weakPiece)) {
+    return -1;
+  }
+  if (weakPiece >= 0) {
+    return getSuccessorsWithWeakPiece(strongToMove, strongKing, strongPiece,
+				      weakKing, weakPiece, successors);
+  }
+
+  int count = 0;
+  if (strongToMove) {
+    // King moves
+    Bitboard targets = (kingAttacks(strongKing) & ~kingAttacks(weakKing) &
+			~occupied);
+    while (targets) {
+      int target = popLowestSquare(targets);
+      successors[count++] = getIndex(false, target, strongPiece, weakKing);
+    }
+
+    // Pawn pushes, or Rook and Queen moves. The only Piece a Pawn could
+    // take is the King, so it never moves diagonally.
+    if (endgame == KPK) {
+      int oneForward = strongPiece + BOARD_WIDTH;
+      if (rankOf(strongPiece) < MAX_RANK &&
+	  !(occupied & squareBit(oneForward))) {
+	successors[count++] = getIndex(false, strongKing, oneForward, weakKing);
+	int twoForward = oneForward + BOARD_WIDTH;
+	if (rankOf(strongPiece) == RANK_TWO &&
+	    !(occupied & squareBit(twoForward))) {
+	  successors[count++] = getIndex(false, strongKing, twoForward,
+					 weakKing);
+	}
+      }
+    } else {
+      targets = getPieceAttacks(strongPiece, occupied) & ~occupied;
+      while (targets) {
+	int target = popLowestSquare(targets);
+	successors[count++] = getIndex(false, strongKing, target, weakKing);
+      }
+    }
+  } else {
+    // King moves, including taking the Piece if it is not defended
+    Bitboard targets = (kingAttacks(weakKing) & ~kingAttacks(strongKing) &
+			~strongKingBit);
+    while (targets) {
+      int target = popLowestSquare(targets);
+      if (target == strongPiece) {
+	successors[count++] = getKnownSuccessor(Draw);
+	continue;
+      }
+      Bitboard occupiedAfter = strongKingBit | strongPieceBit |
+	squareBit(target);
+      if (!(getPieceAttacks(strongPiece, occupiedAfter) & squareBit(target))) {
+	successors[count++] = getIndex(true, strongKing, strongPiece, target);
+      }
+    }
+  }
+  return count;
+}
+
+int Bitbase::getSuccessorsWithWeakPiece(bool strongToMove, int strongKing,
+					int strongPiece, int weakKing,
+					int weakPiece, int* successors) const {
+  Bitboard occupied = squareBit(strongKing) | squareBit(strongPiece) |
+    squareBit(weakKing) | squareBit(weakPiece);
+
+  // Each side has a King and a Piece which move the same way, so the moves
+  // are worked out with the mover's squares as "own" and the other side's
+  // as "their". A move is legal if it does not leave the own King attacked
+  // by the other side's Piece. Taking that Piece leads to the ending left,
+  // in which the mover is the strong side and the other side is to move.
+  int ownKing = (strongToMove) ? strongKing : weakKing;
+  int ownPiece = (strongToMove) ? strongPiece : weakPiece;
+  int theirKing = (strongToMove) ? weakKing : strongKing;
+  int theirPiece = (strongToMove) ? weakPiece : strongPiece;
+  Bitbase const* captureBitbase = (strongToMove) ? strongCaptureBitbase :
+    weakCaptureBitbase;
+  auto getOwnPieceAttacks = [&](int square, Bitboard occupiedNow) {
+    return (strongToMove) ? getPieceAttacks(square, occupiedNow) :
+      rookAttacks(square, occupiedNow);
+  };
+  auto getTheirPieceAttacks = [&](int square, Bitboard occupiedNow) {
+    return (strongToMove) ? rookAttacks(square, occupiedNow) :
+      getPieceAttacks(square, occupiedNow);
+  };
+  auto getSuccessor = [&](int newOwnKing, int newOwnPiece) {
+    return (strongToMove) ?
+      getIndex(false, newOwnKing, newOwnPiece, theirKing, theirPiece) :
+      getIndex(true, theirKing, theirPiece, newOwnKing, newOwnPiece);
+  };
+  auto getCaptureSuccessor = [&](int newOwnKing, int newOwnPiece) {
+    int captureIndex = captureBitbase->getIndex(false, newOwnKing,
+						 newOwnPiece, theirKing);
+    return getKnownSuccessor(captureBitbase->getResult(captureIndex));
+  };
+
+  int count = 0;
+  Bitboard ownBits = squareBit(ownKing) | squareBit(ownPiece);
+
+  // King moves, which must keep away from the other King
+  Bitboard targets = kingAttacks(ownKing) & ~kingAttacks(theirKing) &
+    ~ownBits & ~squareBit(theirKing);
+  while (targets) {
+    int target = popLowestSquare(targets);
+    if (target == theirPiece) {
+      successors[count++] = getCaptureSuccessor(target, ownPiece);
+      continue;
+    }
+    Bitboard occupiedAfter = (occupied & ~squareBit(ownKing)) |
+      squareBit(target);
+    if (!(getTheirPieceAttacks(theirPiece, occupiedAfter) &
+	  squareBit(target))) {
+      successors[count++] = getSuccessor(target, ownPiece);
+    }
+  }
+
+  // Moves of the Piece, which must not uncover an attack on the own King
+  targets = getOwnPieceAttacks(ownPiece, occupied) & ~ownBits &
+    ~squareBit(theirKing);
+  while (targets) {
+    int target = popLowestSquare(targets);
+    if (target == theirPiece) {
+      successors[count++] = getCaptureSuccessor(ownKing, target);
+      continue;
+    }
+    Bitboard occupiedAfter = (occupied & ~squareBit(ownPiece)) |
+      squareBit(target);
+    if (!(getTheirPieceAttacks(theirPiece, occupiedAfter) &
+	  squareBit(ownKing))) {
+      successors[count++] = getSuccessor(ownKing, target);
+    }
+  }
+  return count;
+}
+
+bool Bitbase::isInCheck(bool isStrongKing, int strongKing, int strongPiece,
+			int weakKing, int weakPiece) const {
+  Bitboard occupied = squareBit(strongKing) | squareBit(strongPiece) |
+    squareBit(weakKing);
+  if (weakPiece >= 0) {
+    occupied |= squareBit(weakPiece);
+  }
+  if (!isStrongKing) {
+    return (getPieceAttacks(strongPiece, occupied) & squareBit(weakKing)) != 0;
+  }
+  return weakPiece >= 0 &&
+    (rookAttacks(weakPiece, occupied) & squareBit(strongKing)) != 0;
+}
+
+Bitboard Bitbase::getPieceAttacks(int strongPiece, Bitboard occupied) const {
+  switch (endgame) {
+  case KPK: return pawnAttacks(White, strongPiece);
+  case KRK: return rookAttacks(strongPiece, occupied);
+  case KQK: return queenAttacks(strongPiece, occupied);
+  case KQKR: return queenAttacks(strongPiece, occupied);
+  case KRKR: return rookAttacks(strongPiece, occupied);
+  }
+  return EMPTY_BITBOARD;
+}
+
+Endgame Bitbase::getStrongCaptureEndgame() const {
+  return (endgame == KQKR) ? KQK : KRK;
+}
+
+Endgame Bitbase::getWeakCaptureEndgame() const {
+  return KRK;
+}
+
+BitbaseResult Bitbase::getResult(int index) const {
+  return static_cast<BitbaseResult>((table[index / 4] >> (2 * (index % 4))) &
+				    3);
+}
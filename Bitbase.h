@@ -0,0 +1,173 @@
+#ifndef BITBASE_H
+#define BITBASE_H
+
+#include "Bitboard.h"
+#include "Square.h"
+#include "Player.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class ChessBoard; // Forward declaration to avoid circular dependencies
+
+/* The Endgame enumeration lists the endings a Bitbase can be generated for.
+   In the first three the strong side has a King and one other Piece (a
+   Pawn, a Rook or a Queen) and the weak side has a lone King. In the last
+   two the strong side has a King and a Queen or a Rook, and the weak side
+   has a King and a Rook. */
+
+enum Endgame { KPK, KRK, KQK, KQKR, KRKR };
+
+/* The BitbaseResult enumeration gives the result of a position with best
+   play, from the point of view of the player to move. Unknown is returned
+   for positions which are not legal or are not covered by the Bitbase. */
+
+enum BitbaseResult { Unknown, Draw, Win, Loss };
+
+/* This function allows an Endgame enumerator to be output to the output
+   stream specified, e.g. "KPK". */
+std::ostream& operator<<(std::ostream& os, const Endgame& endgame);
+
+/* This function allows a BitbaseResult enumerator to be output to the output
+   stream specified, e.g. "Win". */
+std::ostream& operator<<(std::ostream& os, const BitbaseResult& result);
+
+/* The Bitbase class contains an Endgame enumerator, the number of positions
+   in the ending and a vector of bytes holding the result of every position.
+   Each result takes 2 bits, so four positions are packed into every byte.
+   Positions are stored with the strong side as White. Positions with the
+   strong side as Black are mirrored across the board before they are looked
+   up. Without Pawns, the position is also turned so that the strong King is
+   on one of the ten squares of the A1-D1-D4 triangle. With a Pawn, it is
+   flipped so that the Pawn is on files A-D. In KRKR either side can be the
+   strong one, and the White Rook is taken to be the strong Piece.
+   A capture in KQKR or KRKR leads to KQK or KRK, so generating one of them
+   first generates the Bitbases of the endings its captures lead to, and
+   looks the captures up in them.
+   The results follow the rules of this engine, so a Pawn which reaches the
+   last rank stays a Pawn. Castling is not considered. */
+
+class Bitbase {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs an empty Bitbase for the input endgame. Every probe returns
+     Unknown until generate() or load() is called. */
+  Bitbase(Endgame endgame);
+
+  /* Destructor. */
+  ~Bitbase();
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns a copy of the endgame. */
+  Endgame getEndgame() const;
+
+  /* Returns the number of positions in the Bitbase, including the ones which
+     are not legal. */
+  int getPositionCount() const;
+
+  /* Returns the number of positions in the Bitbase which have the input
+     result. */
+  int count(BitbaseResult result) const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Works out the result of every position by retrograde analysis. The
+     positions are split evenly between threadCount threads, which go over
+     them in passes until no result changes. Positions which are not won or
+     lost by then are drawn. */
+  void generate(int threadCount);
+
+  /* Writes the Bitbase to the file with the input name. Throws the
+     BitbaseError exception defined in "errors.h" if it cannot be written. */
+  void save(std::string const& fileName) const;
+
+  /* Reads the Bitbase from the file with the input name. Throws the
+     BitbaseError exception defined in "errors.h" if the file cannot be read
+     or does not hold a Bitbase for this endgame. */
+  void load(std::string const& fileName);
+
+  /* Returns the result of the position with the input squares for the
+     player to move. strongPiece is the square of the strong side's Pawn,
+     Rook or Queen. Returns Unknown for KQKR and KRKR, which need the square
+     of the weak side's Rook as well. */
+  BitbaseResult probe(Player strongSide, Square strongKing, Square strongPiece,
+		      Square weakKing, Player playerToMove) const;
+
+  /* Returns the result of the KQKR or KRKR position with the input squares
+     for the player to move. weakPiece is the square of the weak side's
+     Rook. Returns Unknown for the endings without it. */
+  BitbaseResult probe(Player strongSide, Square strongKing, Square strongPiece,
+		      Square weakKing, Square weakPiece,
+		      Player playerToMove) const;
+
+  /* Returns the result of the position on the board for the player to move.
+     Returns Unknown if the board does not hold this endgame, or if the
+     strong side could still castle. */
+  BitbaseResult probe(ChessBoard const& board) const;
+
+private:
+  Endgame endgame;
+  int positionCount;
+  std::vector<uint8_t> table;
+
+  // The Bitbases of the endings reached when the strong side or the weak
+  // side makes a capture. Only set while a KQKR or KRKR Bitbase is being
+  // generated.
+  Bitbase const* strongCaptureBitbase = nullptr;
+  Bitbase const* weakCaptureBitbase = nullptr;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Returns whether the ending has a weak side's Rook, i.e. is KQKR or
+     KRKR. */
+  bool hasWeakPiece() const;
+
+  /* Returns the index of the position with the input squares, given with the
+     strong side as White. weakPiece is the square of the weak side's Rook,
+     and is left out in the endings without one. Returns -1 if the position
+     cannot be stored, i.e. if there is a Pawn on the first rank. */
+  int getIndex(bool strongToMove, int strongKing, int strongPiece,
+	       int weakKing, int weakPiece = -1) const;
+
+  /* Sets the squares and the player to move for the position with the
+     input index. The reverse of getIndex(). weakPiece is set to -1 in the
+     endings without a weak side's Rook. */
+  void getPosition(int index, bool& strongToMove, int& strongKing,
+		   int& strongPiece, int& weakKing, int& weakPiece) const;
+
+  /* Puts the index of every position that can be reached in one legal move
+     into successors and returns how many there are. A capture leads to a
+     position of another ending, whose result is already known, and which
+     is given as the negative number from getKnownSuccessor(). If the
+     position is not legal, returns -1. */
+  int getSuccessors(int index, int* successors) const;
+
+  /* The part of getSuccessors() for KQKR and KRKR, for the position with
+     the input squares, which has already been found to be legal. */
+  int getSuccessorsWithWeakPiece(bool strongToMove, int strongKing,
+				 int strongPiece, int weakKing, int weakPiece,
+				 int* successors) const;
+
+  /* Returns whether the strong side's King, if isStrongKing is true, or
+     else the weak side's King is attacked in the position with the input
+     squares. weakPiece is -1 in the endings without it. */
+  bool isInCheck(bool isStrongKing, int strongKing, int strongPiece,
+		 int weakKing, int weakPiece) const;
+
+  /* Returns the squares attacked by the strong side's Piece. */
+  Bitboard getPieceAttacks(int strongPiece, Bitboard occupied) const;
+
+  /* Return the ending reached in KQKR or KRKR when the strong side takes
+     the weak side's Rook, and when the weak side takes the strong side's
+     Piece. The side left with a Piece is the strong side of that ending. */
+  Endgame getStrongCaptureEndgame() const;
+  Endgame getWeakCaptureEndgame() const;
+
+  /* Returns the result stored for the position with the input index. */
+  BitbaseResult getResult(int index) const;
+};
+
+#endif
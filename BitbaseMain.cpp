@@ -0,0 +1,75 @@
+/* This file contains the main function of the bitbase tool, which generates
+   the win/draw/loss Bitbase for one of the small endgames and writes it to a
+   file. Usage:
+   >> bitbase KPK KPK.bb
+   >> bitbase KQK KQK.bb 4
+   >> bitbase KQKR KQKR.bb
+   The last input is the number of threads. If it is left out, one thread is
+   used for every core. KQKR and KRKR generate the three-piece endings their
+   captures lead to first, but only write their own Bitbase. */
+
+#include "Bitbase.h"
+#include "errors.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  if (argc < 3 || argc > 4) {
+    cerr << "Usage: bitbase <KPK|KRK|KQK|KQKR|KRKR> <output file> [threads]";
+    cerr << endl;
+    return 1;
+  }
+
+  string name = argv[1];
+  Endgame endgame;
+  if (name == "KPK") {
+    endgame = KPK;
+  } else if (name == "KRK") {
+    endgame = KRK;
+  } else if (name == "KQK") {
+    endgame = KQK;
+  } else if (name == "KQKR") {
+    endgame = KQKR;
+  } else if (name == "KRKR") {
+    endgame = KRKR;
+  } else {
+    cerr << name << " is not one of the endgames KPK, KRK, KQK, KQKR or KRKR!";
+    cerr << endl;
+    return 1;
+  }
+
+  int threadCount = (argc == 4) ? stoi(argv[3]) :
+    static_cast<int>(thread::hardware_concurrency());
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+
+  Bitbase bitbase{endgame};
+  cout << "Generating the " << endgame << " bitbase with " << threadCount;
+  cout << " thread(s)" << endl;
+
+  auto start = chrono::steady_clock::now();
+  bitbase.generate(threadCount);
+  auto finish = chrono::steady_clock::now();
+  auto milliseconds =
+    chrono::duration_cast<chrono::milliseconds>(finish - start).count();
+
+  cout << bitbase.getPositionCount() << " positions in " << milliseconds;
+  cout << " ms" << endl;
+  cout << "Win: " << bitbase.count(Win) << ", Draw: " << bitbase.count(Draw);
+  cout << ", Loss: " << bitbase.count(Loss);
+  cout << ", Illegal: " << bitbase.count(Unknown) << endl;
+
+  try {
+    bitbase.save(argv[2]);
+  } catch (BitbaseError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  cout << "Written to " << argv[2] << endl;
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* This file contains the attack tables and attack functions declared in
+   "Bitboard.h". */
+
+#include "Bitboard.h"
+#include "Player.h"
+#include "constants.h"
+#include <cstdlib>
+
+using namespace std;
+
+// ---------- Attack tables ----------------------------------------------------
+
+/* The tables below are filled in once, before main() is called, by the
+   constructor of the AttackTables object defined at the bottom of this
+   section. */
+
+static Bitboard knightTable[NUMBER_OF_SQUARES];
+static Bitboard kingTable[NUMBER_OF_SQUARES];
+static Bitboard pawnTable[2][NUMBER_OF_SQUARES];
+
+/* Returns the bit for the square reached by moving rankChange and fileChange
+   from squareIndex, or an empty Bitboard if that square is off the board. */
+static Bitboard stepBit(int squareIndex, int rankChange, int fileChange) {
+  int rank = rankOf(squareIndex) + rankChange;
+  int file = fileOf(squareIndex) + fileChange;
+  bool isOnBoard = (rank >= MIN_RANK && rank <= MAX_RANK &&
+		    file >= MIN_FILE && file <= MAX_FILE);
+  return (isOnBoard) ? squareBit(squareAt(rank, file)) : EMPTY_BITBOARD;
+}
+
+/* Returns the squares attacked along the direction (rankStep, fileStep)
+   from squareIndex, stopping at the first occupied square. */
+static Bitboard rayAttacks(int squareIndex, int rankStep, int fileStep,
+			   Bitboard occupied) {
+  Bitboard attacks = EMPTY_BITBOARD;
+  Bitboard next = stepBit(squareIndex, rankStep, fileStep);
+  while (next != EMPTY_BITBOARD) {
+    attacks |= next;
+    if (next & occupied) {
+      break;
+    }
+    next = stepBit(lowestSquare(next), rankStep, fileStep);
+  }
+  return attacks;
+}
+
+struct AttackTables {
+  AttackTables() {
+    for (int s = 0; s < NUMBER_OF_SQUARES; s++) {
+      knightTable[s] = EMPTY_BITBOARD;
+      kingTable[s] = EMPTY_BITBOARD;
+      // Same steps as Knight::isAnyLegalMovePossible() and
+      // King::isAnyLegalMovePossible()
+      for (int i = -2; i <= 2; i++) {
+	for (int j = -2; j <= 2; j++) {
+	  if ((abs(i) != abs(j)) && (i != 0) && (j != 0)) {
+	    knightTable[s] |= stepBit(s, i, j);
+	  }
+	  if (abs(i) <= 1 && abs(j) <= 1 && !(i == 0 && j == 0)) {
+	    kingTable[s] |= stepBit(s, i, j);
+	  }
+	}
+      }
+      pawnTable[White][s] = stepBit(s, 1, -1) | stepBit(s, 1, 1);
+      pawnTable[Black][s] = stepBit(s, -1, -1) | stepBit(s, -1, 1);
+    }
+  }
+};
+
+static AttackTables attackTables;
+
+// ---------- Line tables ------------------------------------------------------
+
+/* The line tables are made at compile time, like the Zobrist keys, so a
+   query about the squares between two others is a single lookup. */
+
+struct LineTables {
+  Bitboard between[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES];
+  Bitboard line[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES];
+};
+
+/* Returns the squares from squareIndex to the edge of the board in the
+   direction (rankStep, fileStep), not including squareIndex. */
+static constexpr Bitboard emptyBoardRay(int squareIndex, int rankStep,
+					int fileStep) {
+  Bitboard ray = EMPTY_BITBOARD;
+  int rank = rankOf(squareIndex) + rankStep;
+  int file = fileOf(squareIndex) + fileStep;
+  while (rank >= MIN_RANK && rank <= MAX_RANK &&
+	 file >= MIN_FILE && file <= MAX_FILE) {
+    ray |= squareBit(squareAt(rank, file));
+    rank += rankStep;
+    file += fileStep;
+  }
+  return ray;
+}
+
+static constexpr LineTables makeLineTables() {
+  LineTables tables{};
+  for (int from = 0; from < NUMBER_OF_SQUARES; from++) {
+    for (int rankStep = -1; rankStep <= 1; rankStep++) {
+      for (int fileStep = -1; fileStep <= 1; fileStep++) {
+	if (rankStep == 0 && fileStep == 0) {
+	  continue;
+	}
+	// Walk out from the square. Every square passed is on the same line,
+	// and the squares walked over before it are between the two.
+	Bitboard line = (squareBit(from) |
+			 emptyBoardRay(from, rankStep, fileStep) |
+			 emptyBoardRay(from, -rankStep, -fileStep));
+	Bitboard between = EMPTY_BITBOARD;
+	int rank = rankOf(from) + rankStep;
+	int file = fileOf(from) + fileStep;
+	while (rank >= MIN_RANK && rank <= MAX_RANK &&
+	       file >= MIN_FILE && file <= MAX_FILE) {
+	  int to = squareAt(rank, file);
+	  tables.between[from][to] = between;
+	  tables.line[from][to] = line;
+	  between |= squareBit(to);
+	  rank += rankStep;
+	  file += fileStep;
+	}
+      }
+    }
+  }
+  return tables;
+}
+
+static constexpr LineTables lineTables = makeLineTables();
+
+// ---------- Attacks ----------------------------------------------------------
+
+Bitboard knightAttacks(int squareIndex) {
+  return knightTable[squareIndex];
+}
+
+Bitboard kingAttacks(int squareIndex) {
+  return kingTable[squareIndex];
+}
+
+Bitboard pawnAttacks(Player colour, int squareIndex) {
+  return pawnTable[colour][squareIndex];
+}
+
+Bitboard rookAttacks(int squareIndex, Bitboard occupied) {
+  return (rayAttacks(squareIndex, 1, 0, occupied) |
+	  rayAttacks(squareIndex, -1, 0, occupied) |
+	  rayAttacks(squareIndex, 0, 1, occupied) |
+	  rayAttacks(squareIndex, 0, -1, occupied));
+}
+
+Bitboard bishopAttacks(int squareIndex, Bitboard occupied) {
+  return (rayAttacks(squareIndex, 1, 1, occupied) |
+	  rayAttacks(squareIndex, 1, -1, occupied) |
+	  rayAttacks(squareIndex, -1, 1, occupied) |
+	  rayAttacks(squareIndex, -1, -1, occupied));
+}
+
+Bitboard queenAttacks(int squareIndex, Bitboard occupied) {
+  return rookAttacks(squareIndex, occupied) |
+    bishopAttacks(squareIndex, occupied);
+}
+
+// ---------- Lines ------------------------------------------------------------
+
+Bitboard squaresBetween(int from, int to) {
+  return lineTables.between[from][to];
+}
+
+Bitboard lineThrough(int from, int to) {
+  return lineTables.line[from][to];
+}
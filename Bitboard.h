@@ -0,0 +1,131 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "Player.h"
+#include <cstdint>
+
+/* A Bitboard is a 64 bit integer in which each bit stands for one square of
+   the board. The bit for a square is given by Square::getIndex(), so A1 is
+   the lowest bit and H8 is the highest. A set bit means that the square is
+   part of the set of squares the Bitboard describes, for example the squares
+   attacked by a Piece. */
+
+typedef uint64_t Bitboard;
+
+const int NUMBER_OF_SQUARES = 64;
+
+const Bitboard EMPTY_BITBOARD = 0;
+
+// Squares on the A and H files, which a Pawn cannot take off the side of
+const Bitboard A_FILE_BITBOARD = 0x0101010101010101ULL;
+const Bitboard H_FILE_BITBOARD = 0x8080808080808080ULL;
+
+// Squares on the first rank
+const Bitboard RANK_ONE_BITBOARD = 0x00000000000000FFULL;
+
+// ---------- Square helpers ---------------------------------------------------
+
+/* Returns a Bitboard with only the bit for squareIndex set. */
+constexpr Bitboard squareBit(int squareIndex) {
+  return Bitboard(1) << squareIndex;
+}
+
+/* Returns the rank (0-7) of the square with the input index. */
+constexpr int rankOf(int squareIndex) {
+  return squareIndex >> 3;
+}
+
+/* Returns the file (0-7) of the square with the input index. */
+constexpr int fileOf(int squareIndex) {
+  return squareIndex & 7;
+}
+
+/* Returns the index of the square on the input rank and file. Does not check
+   that the rank and file are on the board. */
+constexpr int squareAt(int rank, int file) {
+  return (rank << 3) | file;
+}
+
+// ---------- Set operations ---------------------------------------------------
+
+/* Returns the number of squares in the Bitboard. */
+inline int popCount(Bitboard bitboard) {
+  return __builtin_popcountll(bitboard);
+}
+
+/* Returns the index of the lowest square in the Bitboard. The Bitboard must
+   not be empty. */
+inline int lowestSquare(Bitboard bitboard) {
+  return __builtin_ctzll(bitboard);
+}
+
+/* Removes the lowest square from the Bitboard and returns its index. The
+   Bitboard must not be empty. */
+inline int popLowestSquare(Bitboard& bitboard) {
+  int squareIndex = lowestSquare(bitboard);
+  bitboard &= bitboard - 1;
+  return squareIndex;
+}
+
+// ---------- Lines ------------------------------------------------------------
+
+/* Returns the squares strictly between the squares with the input indices
+   if they are on the same rank, file or diagonal, and an empty Bitboard if
+   they are not. A Rook, Bishop or Queen can only move from one to the
+   other if these squares are all empty, and a check along the line can
+   only be blocked on one of them. */
+Bitboard squaresBetween(int from, int to);
+
+/* Returns every square of the rank, file or diagonal which goes through
+   both squares with the input indices, from one edge of the board to the
+   other, and an empty Bitboard if there is none or the squares are the
+   same. A Piece can only be pinned to its King along this line. */
+Bitboard lineThrough(int from, int to);
+
+// ---------- Attacks ----------------------------------------------------------
+
+/* Returns the squares a Knight on squareIndex attacks. */
+Bitboard knightAttacks(int squareIndex);
+
+/* Returns the squares a King on squareIndex attacks. */
+Bitboard kingAttacks(int squareIndex);
+
+/* Returns the squares a Pawn of the input colour on squareIndex attacks,
+   i.e. the one or two squares diagonally in front of it. */
+Bitboard pawnAttacks(Player colour, int squareIndex);
+
+/* Returns the squares one step forward of the Pawns of player Us in pawns,
+   whether they are empty or not. Pawns on the last rank have nowhere to
+   go. */
+template <Player Us> inline Bitboard pawnPushes(Bitboard pawns) {
+  return (Us == White) ? pawns << 8 : pawns >> 8;
+}
+
+/* Returns the squares attacked by the Pawns of player Us in pawns. */
+template <Player Us> inline Bitboard pawnAttacks(Bitboard pawns) {
+  Bitboard pushes = pawnPushes<Us>(pawns);
+  return (((pushes & ~A_FILE_BITBOARD) >> 1) |
+	  ((pushes & ~H_FILE_BITBOARD) << 1));
+}
+
+/* Returns the squares on rank, counted up the board from player Us's side,
+   e.g. relativeRankBitboard<Black>(RANK_TWO) is the seventh rank. */
+template <Player Us> inline Bitboard relativeRankBitboard(int rank) {
+  return RANK_ONE_BITBOARD << (8 * relativeRank<Us>(rank));
+}
+
+/* Returns the squares a Rook on squareIndex attacks when the squares in
+   occupied are taken. Each ray stops at, and includes, the first occupied
+   square. */
+Bitboard rookAttacks(int squareIndex, Bitboard occupied);
+
+/* Returns the squares a Bishop on squareIndex attacks when the squares in
+   occupied are taken. Each ray stops at, and includes, the first occupied
+   square. */
+Bitboard bishopAttacks(int squareIndex, Bitboard occupied);
+
+/* Returns the squares a Queen on squareIndex attacks when the squares in
+   occupied are taken. */
+Bitboard queenAttacks(int squareIndex, Bitboard occupied);
+
+#endif
@@ -10,53 +10,134 @@
 #include "Rook.h"
 #include "Queen.h"
 #include "King.h"
+#include "PieceArena.h"
+#include "PieceType.h"
+#include "Move.h"
+#include "GameStatus.h"
+#include "Bitboard.h"
+#include "Zobrist.h"
+#include "Stats.h"
+#include "Latency.h"
+#include "SnapshotPublisher.h"
 #include "constants.h"
 #include "errors.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 #include <iostream>
+#include <new>
+#include <sstream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
-// ---------- Contructors, destructors and operator overloads ------------------
+// Bits of a Snapshot square. The low bits hold the PieceType plus one, so
+// that an empty square is 0.
+const uint8_t SNAPSHOT_TYPE_MASK = 0x07;
+const uint8_t SNAPSHOT_BLACK = 0x08;
+const uint8_t SNAPSHOT_HAS_MOVED = 0x10;
 
-ChessBoard::ChessBoard() {
-  // Create 8x8 array of pointers to Piece objects
-  board = new Piece**[BOARD_LENGTH];
+/* Returns the Snapshot square holding the input Piece, or 0 for null. */
+static uint8_t getSnapshotSquare(Piece const* piece) {
+  if (piece == nullptr) {
+    return 0;
+  }
+  uint8_t square = static_cast<uint8_t>(piece->getType() + 1);
+  if (piece->getColour() == Black) {
+    square |= SNAPSHOT_BLACK;
+  }
+  if (!piece->isFirstMove()) {
+    square |= SNAPSHOT_HAS_MOVED;
+  }
+  return square;
+}
+
+/* Returns true if the King of the input colour could be taken by one of the
+   opponent's Pieces, when the Pieces are placed as given by the Forsyth-
+   Edwards Notation letters input (0 for an empty square). Used to check a
+   position before any Pieces are created for it. */
+static bool isKingAttacked(char const letters[][BOARD_WIDTH], Player colour) {
+  Bitboard occupied = EMPTY_BITBOARD;
+  int kingSquare = 0;
+  char kingLetter = (colour == White) ? 'K' : 'k';
   for (int i = 0; i < BOARD_LENGTH; i++) {
-    board[i] = new Piece*[BOARD_WIDTH];
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      board[i][j] = nullptr;
+      if (letters[i][j] != 0) {
+	occupied |= squareBit(squareAt(i, j));
+      }
+      if (letters[i][j] == kingLetter) {
+	kingSquare = squareAt(i, j);
+      }
     }
   }
-  // Add Pieces
-  setUpBoard();
-}
 
-ChessBoard::~ChessBoard() {
-  // Delete all the Pieces and then the array of pointers
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      delete board[i][j];
+      char letter = letters[i][j];
+      bool isOpponent = (letter != 0 &&
+			 ((colour == White) ? islower(letter) : isupper(letter)));
+      if (!isOpponent) {
+	continue;
+      }
+      int square = squareAt(i, j);
+      Bitboard attacks = EMPTY_BITBOARD;
+      switch (tolower(letter)) {
+      case 'p': attacks = pawnAttacks(!colour, square); break;
+      case 'n': attacks = knightAttacks(square); break;
+      case 'b': attacks = bishopAttacks(square, occupied); break;
+      case 'r': attacks = rookAttacks(square, occupied); break;
+      case 'q': attacks = queenAttacks(square, occupied); break;
+      case 'k': attacks = kingAttacks(square); break;
+      }
+      if (attacks & squareBit(kingSquare)) {
+	return true;
+      }
     }
-    delete[] board[i];
   }
-  delete[] board;
+  return false;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+ChessBoard::ChessBoard() {
+  // Add Pieces
+  setUpBoard();
+}
+
+ChessBoard::ChessBoard(string const& fen) {
+  // Nothing has been allocated, so a FenError can be left to propagate
+  setPosition(fen);
+}
+
+ChessBoard::~ChessBoard() {
+  // The Pieces are stored in the arena, which goes with the board
+  clearBoard();
 }
 
 ChessBoard& ChessBoard::operator=(ChessBoard const& otherBoard) {
-  this->player = otherBoard.player;
-  
+  if (this == &otherBoard) {
+    return *this;
+  }
+  STATS_COUNT(BoardCopyCount);
   clearBoard();
+
+  this->player = otherBoard.player;
+  this->hash = otherBoard.hash;
+  this->halfmoveClock = otherBoard.halfmoveClock;
+  this->history = otherBoard.history;
+  this->historyLength = otherBoard.historyLength;
+  this->occupied = otherBoard.occupied;
   
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
 
       // If there is a Piece on a square on the other board, create
-      // a copy of the Piece with a reference to this board and put
-      // it on the square on this board
+      // a copy of the Piece in this board's arena with a reference to 
+      // this board and put it on the square on this board
       if (otherBoard.board[i][j] != nullptr) {
 	Piece* otherPiece = otherBoard.board[i][j];
-	auto* newPiece = otherPiece->copyPiece(*this); 
+	auto* newPiece = otherPiece->copyPiece(*this, pieces.allocate());
 	this->board[i][j] = newPiece;
       }
       
@@ -66,15 +147,6 @@ ChessBoard& ChessBoard::operator=(ChessBoard const& otherBoard) {
 }
 
 ChessBoard::ChessBoard(ChessBoard const& otherBoard) {
-  // Create 8x8 array of pointers to Piece objects
-  board = new Piece**[BOARD_LENGTH];
-  for (int i = 0; i < BOARD_LENGTH; i++) {
-    board[i] = new Piece*[BOARD_WIDTH];
-    for (int j = 0; j < BOARD_WIDTH; j++) {
-      board[i][j] = nullptr;
-    }
-  }
-
   *this = otherBoard;
 }
 
@@ -92,22 +164,151 @@ bool ChessBoard::isOpponentPieceThere(Square square,
   return (getPiece(square)->getColour() == opponentColour);
 }
 
+bool ChessBoard::isPathClear(Square sourceSquare,
+			     Square destinationSquare) const {
+  return !(squaresBetween(sourceSquare.getIndex(),
+			  destinationSquare.getIndex()) & occupied);
+}
+
 bool ChessBoard::isMoveLegal(Square sourceSquare, Square destinationSquare) {
-  // Create a copy of the current board, make the move and check whether
-  // the player is in check as a result
-  
-  ChessBoard* copyBoard = new ChessBoard{*this};
-  Player playerColour = getPiece(sourceSquare)->getColour();
-  
-  copyBoard->makeMove(sourceSquare, destinationSquare);
-  
-  if (copyBoard->isPlayerInCheck(playerColour)) {
-    delete copyBoard;
-    return false;
+  return (getPiece(sourceSquare)->getColour() == White) ?
+    isMoveLegal<White>(sourceSquare, destinationSquare) :
+    isMoveLegal<Black>(sourceSquare, destinationSquare);
+}
+
+bool ChessBoard::isInCheck() const {
+  return isPlayerInCheck(player);
+}
+
+bool ChessBoard::isRepetition() const {
+  return countRepetitions(hash, 1) >= 1;
+}
+
+bool ChessBoard::isThreefoldRepetition() const {
+  return countRepetitions(hash, 2) >= 2;
+}
+
+bool ChessBoard::isFiftyMoveRuleDraw() const {
+  return halfmoveClock >= FIFTY_MOVE_HALFMOVES;
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+Player ChessBoard::getPlayer() const {
+  return player;
+}
+
+string ChessBoard::getFen() const {
+  string fen;
+  for (int i = MAX_RANK; i >= MIN_RANK; i--) {
+    int emptySquares = 0;
+    for (int j = MIN_FILE; j <= MAX_FILE; j++) {
+      if (board[i][j] == nullptr) {
+	emptySquares++;
+	continue;
+      }
+      if (emptySquares > 0) {
+	fen += to_string(emptySquares);
+	emptySquares = 0;
+      }
+      fen += getFenLetter(board[i][j]);
+    }
+    if (emptySquares > 0) {
+      fen += to_string(emptySquares);
+    }
+    if (i > MIN_RANK) {
+      fen += '/';
+    }
   }
-  
-  delete copyBoard;
-  return true;
+
+  fen += (player == White) ? " w " : " b ";
+
+  string castling;
+  int castlingRights = getCastlingRights();
+  char letters[4] = {'K', 'Q', 'k', 'q'};
+  for (int i = 0; i < 4; i++) {
+    if (castlingRights & (1 << i)) {
+      castling += letters[i];
+    }
+  }
+  fen += (castling.empty()) ? "-" : castling;
+
+  fen += " - " + to_string(halfmoveClock) + " 1";
+  return fen;
+}
+
+int ChessBoard::getHalfmoveClock() const {
+  return halfmoveClock;
+}
+
+Bitboard ChessBoard::getOccupied() const {
+  return occupied;
+}
+
+GameStatus ChessBoard::getStatus() {
+  // Checkmate and stalemate end the game before any draw is claimed
+  bool isCheck = isPlayerInCheck(player);
+  if (isCheck && isPlayerInCheckmate(player)) {
+    return Checkmate;
+  }
+  if (!isCheck && isPlayerInStalemate(player)) {
+    return Stalemate;
+  }
+  if (isThreefoldRepetition()) {
+    return ThreefoldRepetition;
+  }
+  if (isFiftyMoveRuleDraw()) {
+    return FiftyMoveRule;
+  }
+  return (isCheck) ? Check : InProgress;
+}
+
+vector<Move> ChessBoard::getLegalMoves() {
+  return (player == White) ? getLegalMoves<White>() : getLegalMoves<Black>();
+}
+
+int ChessBoard::countLegalMoves() {
+  return (player == White) ? countLegalMoves<White>() :
+    countLegalMoves<Black>();
+}
+
+int ChessBoard::getMaterial(Player p) const {
+  int material = 0;
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      if (board[i][j] == nullptr || board[i][j]->getColour() != p) {
+	continue;
+      }
+      switch (tolower(getFenLetter(board[i][j]))) {
+      case 'p': material += PAWN_VALUE; break;
+      case 'n': material += KNIGHT_VALUE; break;
+      case 'b': material += BISHOP_VALUE; break;
+      case 'r': material += ROOK_VALUE; break;
+      case 'q': material += QUEEN_VALUE; break;
+      }
+    }
+  }
+  return material;
+}
+
+HashKey ChessBoard::getHash() const {
+  return hash;
+}
+
+size_t ChessBoard::getHistoryLength() const {
+  return historyLength;
+}
+
+Snapshot ChessBoard::snapshot() const {
+  Snapshot state;
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      state.squares[i][j] = getSnapshotSquare(board[i][j]);
+    }
+  }
+  state.player = static_cast<uint8_t>(player);
+  state.halfmoveClock = static_cast<uint8_t>(min(halfmoveClock, UINT8_MAX));
+  return state;
 }
 
 // ---------- Other functions --------------------------------------------------
@@ -115,10 +316,234 @@ bool ChessBoard::isMoveLegal(Square sourceSquare, Square destinationSquare) {
 void ChessBoard::resetBoard() {
   clearBoard();
   player = White;
+  halfmoveClock = 0;
   setUpBoard();
+  publishPosition();
+}
+
+void ChessBoard::setPosition(string const& fen) {
+  istringstream fields{fen};
+  string placement, side, castling, enPassant, halfmove;
+  fields >> placement >> side >> castling >> enPassant >> halfmove;
+  if (castling.empty()) {
+    castling = "-";
+  }
+  int newHalfmoveClock = 0;
+  if (!halfmove.empty()) {
+    if (halfmove.size() > 4 ||
+	halfmove.find_first_not_of("0123456789") != string::npos) {
+      throw FenError{fen, "the halfmove clock must be a number"};
+    }
+    newHalfmoveClock = stoi(halfmove);
+  }
+
+  // Read the placement into an array of letters first, so that the board
+  // is not changed unless the whole position is valid
+  char letters[BOARD_LENGTH][BOARD_WIDTH] = {};
+  int rank = MAX_RANK;
+  int file = MIN_FILE;
+  int kingCount[2] = {0, 0};
+  for (char c : placement) {
+    if (c == '/') {
+      if (file != BOARD_WIDTH || rank == MIN_RANK) {
+	throw FenError{fen, "there must be 8 ranks of 8 squares"};
+      }
+      rank--;
+      file = MIN_FILE;
+    } else if (c >= '1' && c <= '8') {
+      file += c - '0';
+    } else if (string{"PNBRQKpnbrqk"}.find(c) != string::npos) {
+      if (file > MAX_FILE) {
+	throw FenError{fen, "there must be 8 ranks of 8 squares"};
+      }
+      if (c == 'K' || c == 'k') {
+	kingCount[(c == 'K') ? White : Black]++;
+      }
+      letters[rank][file++] = c;
+    } else {
+      throw FenError{fen, string{"'"} + c + "' is not a Piece"};
+    }
+    if (file > BOARD_WIDTH) {
+      throw FenError{fen, "there must be 8 ranks of 8 squares"};
+    }
+  }
+  if (rank != MIN_RANK || file != BOARD_WIDTH) {
+    throw FenError{fen, "there must be 8 ranks of 8 squares"};
+  }
+  if (kingCount[White] != 1 || kingCount[Black] != 1) {
+    throw FenError{fen, "each player must have exactly one King"};
+  }
+  if (side != "w" && side != "b") {
+    throw FenError{fen, "the player to move must be \"w\" or \"b\""};
+  }
+  Player newPlayer = (side == "w") ? White : Black;
+  if (isKingAttacked(letters, !newPlayer)) {
+    throw FenError{fen, "the player who is not to move is in check"};
+  }
+
+  // Each castling right needs the King and the Rook on their start squares
+  if (castling != "-") {
+    for (char c : castling) {
+      bool isWhite = (c == 'K' || c == 'Q');
+      int kingRank = (isWhite) ? MIN_RANK : MAX_RANK;
+      int rookFile = (c == 'K' || c == 'k') ? MAX_FILE : MIN_FILE;
+      bool isValid = (string{"KQkq"}.find(c) != string::npos &&
+		      letters[kingRank][4] == ((isWhite) ? 'K' : 'k') &&
+		      letters[kingRank][rookFile] == ((isWhite) ? 'R' : 'r'));
+      if (!isValid) {
+	throw FenError{fen, "the castling rights do not match the Pieces"};
+      }
+    }
+  }
+
+  // Put the Pieces on the board. Pawns have moved if they are not on their
+  // starting rank, and Kings and Rooks have moved unless they can castle.
+  clearBoard();
+  player = newPlayer;
+  halfmoveClock = newHalfmoveClock;
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      if (letters[i][j] == 0) {
+	continue;
+      }
+      Piece* piece = createPiece(letters[i][j]);
+      Player colour = piece->getColour();
+      char letter = static_cast<char>(tolower(letters[i][j]));
+      if (letter == 'p') {
+	int startRank = (colour == White) ? RANK_TWO : RANK_SEVEN;
+	piece->setHasMoved(i != startRank);
+      } else if (letter == 'k') {
+	string rights = (colour == White) ? "KQ" : "kq";
+	piece->setHasMoved(castling.find_first_of(rights) == string::npos);
+      } else if (letter == 'r') {
+	char right = (j == MAX_FILE) ? 'K' : 'Q';
+	if (colour == Black) {
+	  right = static_cast<char>(tolower(right));
+	}
+	int startRank = (colour == White) ? MIN_RANK : MAX_RANK;
+	bool canCastle = (i == startRank && (j == MIN_FILE || j == MAX_FILE) &&
+			  castling.find(right) != string::npos);
+	piece->setHasMoved(!canCastle);
+      }
+      board[i][j] = piece;
+      occupied |= squareBit(squareAt(i, j));
+    }
+  }
+  hash = computeHash();
+  publishPosition();
+}
+
+void ChessBoard::restore(Snapshot const& state) {
+  // Variations seldom move more than a few Pieces, so only the squares
+  // which differ from the Snapshot are rebuilt and the hash is updated for
+  // them, rather than clearing the board and starting again
+  HashKey oldCastling = castlingKey(getCastlingRights());
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      uint8_t square = state.squares[i][j];
+      Piece* piece = board[i][j];
+      if (getSnapshotSquare(piece) == square) {
+	continue;
+      }
+      int index = squareAt(i, j);
+      if (piece != nullptr) {
+	hash ^= pieceKey(piece->getColour(), piece->getType(), index);
+	pieces.release(piece);
+	board[i][j] = nullptr;
+	occupied &= ~squareBit(index);
+      }
+      if (square == 0) {
+	continue;
+      }
+      PieceType type =
+	static_cast<PieceType>((square & SNAPSHOT_TYPE_MASK) - 1);
+      Player colour = (square & SNAPSHOT_BLACK) ? Black : White;
+      board[i][j] = createPiece(type, colour);
+      board[i][j]->setHasMoved((square & SNAPSHOT_HAS_MOVED) != 0);
+      occupied |= squareBit(index);
+      hash ^= pieceKey(colour, type, index);
+    }
+  }
+  hash ^= oldCastling ^ castlingKey(getCastlingRights());
+  if (player != ((state.player == White) ? White : Black)) {
+    swapPlayer();
+  }
+  halfmoveClock = state.halfmoveClock;
+  history.clear();
+  historyLength = 0;
+  publishPosition();
+}
+
+void ChessBoard::playMove(Move move) {
+  recordMove(move);
+  applyMove(move);
+  swapPlayer();
+}
+
+bool ChessBoard::takeback() {
+  if (historyLength == 0) {
+    return false;
+  }
+  HistoryEntry const& entry = history[--historyLength];
+  Square source = entry.move.getSource();
+  Square destination = entry.move.getDestination();
+  Piece* piece = getPiece(destination);
+  Player mover = piece->getColour();
+
+  board[source.getRank()][source.getFile()] = piece;
+  board[destination.getRank()][destination.getFile()] = nullptr;
+  occupied ^= squareBit(source.getIndex()) | squareBit(destination.getIndex());
+  piece->setHasMoved(entry.hadMoved);
+
+  if (entry.captured != NoPieceType) {
+    Piece* takenPiece = createPiece(entry.captured, !mover);
+    takenPiece->setHasMoved(entry.capturedHadMoved);
+    board[destination.getRank()][destination.getFile()] = takenPiece;
+    occupied |= squareBit(destination.getIndex());
+  }
+
+  // Put the Rook back in its corner. It cannot have moved before.
+  if (entry.move.isCastle()) {
+    bool isKingside = entry.move.isKingsideCastle();
+    Square rookPosition = (isKingside) ? getKingsideRookStartSquare(mover) :
+      getQueensideRookStartSquare(mover);
+    int fileStep = (isKingside) ? 1 : -1;
+    Square rookDestination{source.getRank(), source.getFile() + fileStep};
+    Piece* rook = getPiece(rookDestination);
+    board[rookPosition.getRank()][rookPosition.getFile()] = rook;
+    board[rookDestination.getRank()][rookDestination.getFile()] = nullptr;
+    occupied ^= (squareBit(rookPosition.getIndex()) |
+		 squareBit(rookDestination.getIndex()));
+    rook->setHasMoved(false);
+  }
+
+  player = mover;
+  hash = entry.hash;
+  halfmoveClock = entry.halfmoveClock;
+  publishPosition();
+  return true;
+}
+
+bool ChessBoard::redo() {
+  if (historyLength == history.size()) {
+    return false;
+  }
+  HistoryEntry const& entry = history[historyLength++];
+  applyMove(entry.move);
+  if (entry.isPlayerSwapped) {
+    swapPlayer();
+  }
+  publishPosition();
+  return true;
+}
+
+void ChessBoard::setPublisher(SnapshotPublisher* publisher) {
+  this->publisher = publisher;
+  publishPosition();
 }
 
 void ChessBoard::submitMove(string sourceSquare, string destinationSquare) {
+  STATS_LATENCY(SubmitSquaresLatency);
 
   // Checks on input -------------------------------------------
   
@@ -144,6 +569,51 @@ void ChessBoard::submitMove(string sourceSquare, string destinationSquare) {
     return;
   }
 
+  submitMove(Move{source, destination});
+}
+
+
+// Function for castling
+void ChessBoard::submitMove(char playerColour, std::string castleCode) {
+  STATS_LATENCY(SubmitCastleLatency);
+  
+  bool validInput = ((playerColour == 'W' || playerColour == 'B') &&
+		     (castleCode == "O-O" || castleCode == "O-O-O"));
+    
+  if (!validInput) {
+    cout << "Sorry, invalid input! Please enter a correct rank and file\n";
+    cout << "combination, or a colour and castle code. For example:\n";
+    cout << ">> chessboard.sumbitMove(\"E2\", \"E4\");\n";
+    cout << ">> chessboard.submitMove('B', \"O-O\");" << endl;
+    return;
+  }
+
+  bool isCorrectPlayer = ((this->player == White && playerColour == 'W') ||
+			  (this->player == Black && playerColour == 'B'));
+  
+  if (!isCorrectPlayer) {
+    cout << "It is not " << !player << "'s turn to move!" << endl;
+    return;
+  }
+
+  // King always moves two towards the Rook
+  int fileChange = (castleCode == "O-O") ? 2 : -2;
+  Square kingPosition = getKingStartSquare(player);
+  Square kingDestination{kingPosition.getRank(),
+			 kingPosition.getFile() + fileChange};
+  submitMove(Move{kingPosition, kingDestination, true});
+}
+
+void ChessBoard::submitMove(Move move) {
+  STATS_LATENCY(SubmitMoveLatency);
+  if (move.isCastle()) {
+    submitCastle(move);
+    return;
+  }
+
+  Square source = move.getSource();
+  Square destination = move.getDestination();
+
   if (source == destination) {
     cout << "A piece cannot move to the square it's already on!" << endl;
     return;
@@ -168,54 +638,314 @@ void ChessBoard::submitMove(string sourceSquare, string destinationSquare) {
   // the game (check/checkmate/stalemate)
   if (piece->isMovePossible(source, destination) &&
       isMoveLegal(source, destination)) {
-    string opponentPiece = makeMove(source, destination);
-    piece->setHasMoved(true);
+    recordMove(move);
+    string opponentPiece = applyMove(move);
     
     cout << player << "'s " << *piece << " moves from ";
     cout << source << " to " << destination;
 
-    if (opponentPiece != "") {
-      cout << " taking "  << !player << "'s " << opponentPiece;
-    }
-    cout << endl;
-   
-    if (isGameContinuing()) {
-      swapPlayer();
-    }
-    
+    if (opponentPiece != "") {
+      cout << " taking "  << !player << "'s " << opponentPiece;
+    }
+    cout << endl;
+   
+    finishMove();
+    
+  } else {
+    cerr << player << "'s " << *piece << " cannot move to ";
+    cerr << destination << "!" << endl;
+  }
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+void ChessBoard::setUpBoard() {
+  // Pawns
+  for (int i = 0; i < BOARD_WIDTH; i++) {
+    Piece* newPawn = new (pieces.allocate()) Pawn{White, *this};
+    board[RANK_TWO][i] = newPawn;
+    occupied |= squareBit(squareAt(RANK_TWO, i));
+  }
+  for (int i = 0; i < BOARD_WIDTH; i++) {
+    Piece* newPawn = new (pieces.allocate()) Pawn{Black, *this};
+    board[RANK_SEVEN][i] = newPawn;
+    occupied |= squareBit(squareAt(RANK_SEVEN, i));
+  }
+  
+  // Bishops
+  Piece* newBishop = new (pieces.allocate()) Bishop{White, *this};
+  putPieceOnBoard(newBishop, WHITE_QUEEN_BISHOP);
+  newBishop = new (pieces.allocate()) Bishop{White, *this};
+  putPieceOnBoard(newBishop, WHITE_KING_BISHOP);
+  newBishop = new (pieces.allocate()) Bishop{Black, *this};
+  putPieceOnBoard(newBishop, BLACK_QUEEN_BISHOP);
+  newBishop = new (pieces.allocate()) Bishop{Black, *this};
+  putPieceOnBoard(newBishop, BLACK_KING_BISHOP);
+
+  // Knights
+  Piece* newKnight = new (pieces.allocate()) Knight{White, *this};
+  putPieceOnBoard(newKnight, WHITE_QUEEN_KNIGHT);
+  newKnight = new (pieces.allocate()) Knight{White, *this};
+  putPieceOnBoard(newKnight, WHITE_KING_KNIGHT);
+  newKnight = new (pieces.allocate()) Knight{Black, *this};
+  putPieceOnBoard(newKnight, BLACK_QUEEN_KNIGHT);
+  newKnight = new (pieces.allocate()) Knight{Black, *this};
+  putPieceOnBoard(newKnight, BLACK_KING_KNIGHT);
+
+  // Rooks
+  Piece* newRook = new (pieces.allocate()) Rook{White, *this};
+  putPieceOnBoard(newRook, WHITE_QUEEN_ROOK);
+  newRook = new (pieces.allocate()) Rook{White, *this};
+  putPieceOnBoard(newRook, WHITE_KING_ROOK);
+  newRook = new (pieces.allocate()) Rook{Black, *this};
+  putPieceOnBoard(newRook, BLACK_QUEEN_ROOK);
+  newRook = new (pieces.allocate()) Rook{Black, *this};
+  putPieceOnBoard(newRook, BLACK_KING_ROOK);
+
+  // Queens
+  Piece* newQueen = new (pieces.allocate()) Queen{White, *this};
+  putPieceOnBoard(newQueen, WHITE_QUEEN);
+  newQueen = new (pieces.allocate()) Queen{Black, *this};
+  putPieceOnBoard(newQueen, BLACK_QUEEN);
+
+  // Kings
+  Piece* newKing = new (pieces.allocate()) King{White, *this};
+  putPieceOnBoard(newKing, WHITE_KING_START_SQUARE);
+  newKing = new (pieces.allocate()) King{Black, *this};
+  putPieceOnBoard(newKing, BLACK_KING_START_SQUARE);
+  hash = computeHash();
+  
+  cout << "A new chess game is started!" << endl;
+}
+
+void ChessBoard::putPieceOnBoard(Piece* piece, string position) {
+  try {
+    Square square{position};
+    int rank = square.getRank();
+    int file = square.getFile();
+    board[rank][file] = piece;
+    occupied |= squareBit(square.getIndex());
+  } catch (OffBoardError const& e) {
+    cerr << "You cannot place a piece there," << endl;
+    cerr << e.what() << endl;
+  }
+}
+
+Piece* ChessBoard::createPiece(char fenLetter) {
+  Player colour = (isupper(fenLetter)) ? White : Black;
+  switch (tolower(fenLetter)) {
+  case 'p': return createPiece(PawnType, colour);
+  case 'n': return createPiece(KnightType, colour);
+  case 'b': return createPiece(BishopType, colour);
+  case 'r': return createPiece(RookType, colour);
+  case 'q': return createPiece(QueenType, colour);
+  case 'k': return createPiece(KingType, colour);
+  }
+  return nullptr;
+}
+
+Piece* ChessBoard::createPiece(PieceType type, Player colour) {
+  switch (type) {
+  case PawnType: return new (pieces.allocate()) Pawn{colour, *this};
+  case KnightType: return new (pieces.allocate()) Knight{colour, *this};
+  case BishopType: return new (pieces.allocate()) Bishop{colour, *this};
+  case RookType: return new (pieces.allocate()) Rook{colour, *this};
+  case QueenType: return new (pieces.allocate()) Queen{colour, *this};
+  case KingType: return new (pieces.allocate()) King{colour, *this};
+  case NoPieceType: break;
+  }
+  return nullptr;
+}
+
+char ChessBoard::getFenLetter(Piece const* piece) const {
+  static const char letters[PIECE_TYPE_COUNT] = {'p', 'n', 'b', 'r', 'q', 'k'};
+  char letter = letters[piece->getType()];
+  return (piece->getColour() == White) ?
+    static_cast<char>(toupper(letter)) : letter;
+}
+
+void ChessBoard::clearBoard() {
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      this->board[i][j] = nullptr;
+    }
+  }
+  occupied = EMPTY_BITBOARD;
+  pieces.releaseAll();
+  history.clear();
+  historyLength = 0;
+}
+
+void ChessBoard::swapPlayer() {
+  player = !player;
+  hash ^= blackToMoveKey();
+}
+
+HashKey ChessBoard::computeHash() const {
+  HashKey newHash = castlingKey(getCastlingRights());
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      Piece* piece = board[i][j];
+      if (piece != nullptr) {
+	newHash ^= pieceKey(piece->getColour(), piece->getType(),
+			    squareAt(i, j));
+      }
+    }
+  }
+  if (player == Black) {
+    newHash ^= blackToMoveKey();
+  }
+  return newHash;
+}
+
+int ChessBoard::getCastlingRights() const {
+  // A castling right is kept while the King and the Rook are both unmoved.
+  // The rights are in the order White kingside, White queenside, Black
+  // kingside, Black queenside.
+  int castlingRights = 0;
+  Player colours[2] = {White, Black};
+  for (Player colour : colours) {
+    Piece* king = getPiece(getKingStartSquare(colour));
+    if (king == nullptr || king->getType() != KingType ||
+	king->getColour() != colour || !king->isFirstMove()) {
+      continue;
+    }
+    Square rookSquares[2] = {getKingsideRookStartSquare(colour),
+			     getQueensideRookStartSquare(colour)};
+    for (int side = 0; side < 2; side++) {
+      Piece* rook = getPiece(rookSquares[side]);
+      if (rook != nullptr && rook->getType() == RookType &&
+	  rook->getColour() == colour && rook->isFirstMove()) {
+	castlingRights |= 1 << (2 * colour + side);
+      }
+    }
+  }
+  return castlingRights;
+}
+
+int ChessBoard::countRepetitions(HashKey key, int maxCount) const {
+  // history[i].hash is the position before move i, so the positions with
+  // the same player to move as now are at historyLength - 2, - 4, ...
+  int count = 0;
+  int oldest = static_cast<int>(historyLength) - halfmoveClock;
+  for (int i = static_cast<int>(historyLength) - 2; i >= 0 && i >= oldest;
+       i -= 2) {
+    if (history[i].hash == key && ++count == maxCount) {
+      break;
+    }
+  }
+  return count;
+}
+
+void ChessBoard::recordMove(Move move) {
+  HistoryEntry entry;
+  entry.move = move;
+  entry.hash = hash;
+  entry.halfmoveClock = halfmoveClock;
+  entry.hadMoved = !getPiece(move.getSource())->isFirstMove();
+  Piece* takenPiece = getPiece(move.getDestination());
+  if (!move.isCastle() && takenPiece != nullptr) {
+    entry.captured = takenPiece->getType();
+    entry.capturedHadMoved = !takenPiece->isFirstMove();
+  }
+
+  history.resize(historyLength);
+  history.push_back(entry);
+  historyLength++;
+}
+
+string ChessBoard::applyMove(Move move) {
+  Square source = move.getSource();
+  Square destination = move.getDestination();
+  Piece* piece = getPiece(source);
+  int castlingRights = getCastlingRights();
+
+  // The Rook ends up on the other side of the King, one square away
+  // from where the King started
+  if (move.isCastle()) {
+    Player colour = piece->getColour();
+    bool isKingside = move.isKingsideCastle();
+    Square rookPosition = (isKingside) ? getKingsideRookStartSquare(colour) :
+      getQueensideRookStartSquare(colour);
+    int fileStep = (isKingside) ? 1 : -1;
+    Square rookDestination{source.getRank(), source.getFile() + fileStep};
+    Piece* rook = getPiece(rookPosition);
+    makeMove(rookPosition, rookDestination);
+    rook->setHasMoved(true);
+  }
+
+  // Captures and Pawn moves cannot be undone, so they restart the clock
+  bool isIrreversible = (piece->getType() == PawnType ||
+			 (!move.isCastle() && isPieceThere(destination)));
+  halfmoveClock = (isIrreversible) ? 0 : halfmoveClock + 1;
+
+  string opponentPiece = makeMove(source, destination);
+  piece->setHasMoved(true);
+  hash ^= castlingKey(castlingRights) ^ castlingKey(getCastlingRights());
+  return opponentPiece;
+}
+
+void ChessBoard::finishMove() {
+  GameStatus status = announceStatus();
+  if (!isGameOver(status)) {
+    swapPlayer();
   } else {
-    cerr << player << "'s " << *piece << " cannot move to ";
-    cerr << destination << "!" << endl;
+    history[historyLength - 1].isPlayerSwapped = false;
   }
+  publish(status);
 }
 
+void ChessBoard::publish(GameStatus status) {
+  if (publisher == nullptr) {
+    return;
+  }
+  BoardSnapshot published;
+  published.position = snapshot();
+  published.status = status;
+  published.moveCount = static_cast<uint32_t>(historyLength);
+  published.lastMove = (historyLength > 0) ? history[historyLength - 1].move :
+    Move{};
+  published.hash = hash;
+  publisher->publish(published);
+}
 
-// Function for castling
-void ChessBoard::submitMove(char playerColour, std::string castleCode) {
-  
-  bool validInput = ((playerColour == 'W' || playerColour == 'B') &&
-		     (castleCode == "O-O" || castleCode == "O-O-O"));
-    
-  if (!validInput) {
-    cout << "Sorry, invalid input! Please enter a correct rank and file\n";
-    cout << "combination, or a colour and castle code. For example:\n";
-    cout << ">> chessboard.sumbitMove(\"E2\", \"E4\");\n";
-    cout << ">> chessboard.submitMove('B', \"O-O\");" << endl;
+void ChessBoard::publishPosition() {
+  if (publisher == nullptr) {
     return;
   }
 
-  bool isCorrectPlayer = ((this->player == White && playerColour == 'W') ||
-			  (this->player == Black && playerColour == 'B'));
-  
-  if (!isCorrectPlayer) {
-    cout << "It is not " << !player << "'s turn to move!" << endl;
+  // After a move which ended the game the player was not swapped over, so
+  // the status is the opponent's, as announceStatus() found it
+  bool isEnded = (historyLength > 0 &&
+		  !history[historyLength - 1].isPlayerSwapped);
+  if (isEnded) {
+    swapPlayer();
+  }
+  GameStatus status = getStatus();
+  if (isEnded) {
+    swapPlayer();
+  }
+  publish(status);
+}
+
+void ChessBoard::submitCastle(Move move) {
+  // The King must be on its starting square and move two squares along
+  // the rank towards one of the Rooks
+  Square kingPosition = getKingStartSquare(player);
+  Square source = move.getSource();
+  Square destination = move.getDestination();
+  bool isCastle = (source == kingPosition &&
+		   destination.getRank() == kingPosition.getRank() &&
+		   abs(destination.getFile() - kingPosition.getFile()) == 2);
+  if (!isCastle) {
+    cout << player << " cannot castle from " << source << " to ";
+    cout << destination << "!" << endl;
     return;
   }
 
-  // Find starting positions of King and Rook
+  // Find starting position of the Rook
   
-  bool isKingside = (castleCode == "O-O");
-  Square kingPosition = getKingStartSquare(player);
+  bool isKingside = move.isKingsideCastle();
   Square rookPosition;
   if (isKingside) {
     rookPosition = getKingsideRookStartSquare(player);
@@ -229,7 +959,7 @@ void ChessBoard::submitMove(char playerColour, std::string castleCode) {
   // Check if King and Rook have moved before
   
   if (king == nullptr ||
-      king->getName() != "King" ||
+      king->getType() != KingType ||
       king->getColour() != player ||
       !king->isFirstMove()) {
     cout << player << " cannot castle, the King has moved previously" << endl;
@@ -237,7 +967,7 @@ void ChessBoard::submitMove(char playerColour, std::string castleCode) {
   }
 
   if (rook == nullptr ||
-      rook->getName() != "Rook" ||
+      rook->getType() != RookType ||
       rook->getColour() != player ||
       !rook->isFirstMove()) {
     cout << player << " cannot castle, the Rook has moved previously" << endl;
@@ -246,17 +976,7 @@ void ChessBoard::submitMove(char playerColour, std::string castleCode) {
 
   // Check that the squares between the King and Rook are clear
   
-  bool pathIsClear = true;
-  int fileChange = rookPosition.getFile() - kingPosition.getFile();
-
-  for (int i = 1; i < abs(fileChange); i++) {
-    int fileStep = i * fileChange / abs(fileChange);
-    Square pathSquare{kingPosition.getRank(),
-		      kingPosition.getFile() + fileStep};
-    pathIsClear = pathIsClear && !isPieceThere(pathSquare);
-  }
-  
-  if (!pathIsClear) {
+  if (!isPathClear(kingPosition, rookPosition)) {
     cout << player << " cannot castle, the squares between the King" << endl;
     cout << "and the Rook are not clear" << endl;
     return;
@@ -271,7 +991,7 @@ void ChessBoard::submitMove(char playerColour, std::string castleCode) {
 
   // Check that the player will not move through check
   
-  int fileStep = fileChange / abs(fileChange);
+  int fileStep = (isKingside) ? 1 : -1;
   Square pathSquare{kingPosition.getRank(),
 		    kingPosition.getFile() + fileStep};
   if (!isMoveLegal(kingPosition, pathSquare)) {
@@ -281,149 +1001,187 @@ void ChessBoard::submitMove(char playerColour, std::string castleCode) {
   }
 
   // Check that the player will not move into check
-
-  // King always moves two towards the Rook and Rook always ends
-  // up on other side of King - one away from where King was originally
-  Square kingDestination{kingPosition.getRank(),
-                         kingPosition.getFile() + 2 * fileStep};
-  Square rookDestination{rookPosition.getRank(),
-			 kingPosition.getFile() + 1 * fileStep};
   
-  if (!isMoveLegal(kingPosition, kingDestination)) {
+  if (!isMoveLegal(kingPosition, destination)) {
     cout << player << " cannot castle, the King would move into check" << endl;
     return;
   }
 
-  // Making move 
+  // Making move. applyMove() puts the Rook on the other side of the King.
   
-  makeMove(kingPosition, kingDestination);
-  makeMove(rookPosition, rookDestination);
-
-  king->setHasMoved(true);
-  rook->setHasMoved(true);
+  recordMove(move);
+  applyMove(move);
 
   string side = (isKingside) ? "kingside" : "queenside";
   
   cout << player << " castles " << side << endl;
   
-  if (isGameContinuing()) {
-    swapPlayer();
-  }
+  finishMove();
 }
 
-// ---------- Helper functions -------------------------------------------------
+string ChessBoard::makeMove(Square sourceSquare, Square destinationSquare) {
+  string opponentPiece;
+  Piece* destination = getPiece(destinationSquare);
 
-void ChessBoard::setUpBoard() {
-  // Pawns
-  for (int i = 0; i < BOARD_WIDTH; i++) {
-    Piece* newPawn = new Pawn{White, *this};
-    board[RANK_TWO][i] = newPawn;
-  }
-  for (int i = 0; i < BOARD_WIDTH; i++) {
-    Piece* newPawn = new Pawn{Black, *this};
-    board[RANK_SEVEN][i] = newPawn;
-  }
+  int sourceRank = sourceSquare.getRank();
+  int sourceFile = sourceSquare.getFile();
+  int destinationRank = destinationSquare.getRank();
+  int destinationFile = destinationSquare.getFile();
   
-  // Bishops
-  Piece* newBishop = new Bishop{White, *this};
-  putPieceOnBoard(newBishop, WHITE_QUEEN_BISHOP);
-  newBishop = new Bishop{White, *this};
-  putPieceOnBoard(newBishop, WHITE_KING_BISHOP);
-  newBishop = new Bishop{Black, *this};
-  putPieceOnBoard(newBishop, BLACK_QUEEN_BISHOP);
-  newBishop = new Bishop{Black, *this};
-  putPieceOnBoard(newBishop, BLACK_KING_BISHOP);
+  if (destination != nullptr) {
+    opponentPiece = destination->getName();
+    hash ^= pieceKey(destination->getColour(), destination->getType(),
+		     destinationSquare.getIndex());
+    pieces.release(destination);
+  } else {
+    opponentPiece = "";
+  }
+  Piece* piece = board[sourceRank][sourceFile];
+  hash ^= pieceKey(piece->getColour(), piece->getType(),
+		   sourceSquare.getIndex());
+  hash ^= pieceKey(piece->getColour(), piece->getType(),
+		   destinationSquare.getIndex());
+  board[destinationRank][destinationFile] = board[sourceRank][sourceFile];
+  board[sourceRank][sourceFile] = nullptr;
+  occupied &= ~squareBit(sourceSquare.getIndex());
+  occupied |= squareBit(destinationSquare.getIndex());
+  return opponentPiece;
+}
 
-  // Knights
-  Piece* newKnight = new Knight{White, *this};
-  putPieceOnBoard(newKnight, WHITE_QUEEN_KNIGHT);
-  newKnight = new Knight{White, *this};
-  putPieceOnBoard(newKnight, WHITE_KING_KNIGHT);
-  newKnight = new Knight{Black, *this};
-  putPieceOnBoard(newKnight, BLACK_QUEEN_KNIGHT);
-  newKnight = new Knight{Black, *this};
-  putPieceOnBoard(newKnight, BLACK_KING_KNIGHT);
+// ---------- Checker functions ------------------------------------------------
 
-  // Rooks
-  Piece* newRook = new Rook{White, *this};
-  putPieceOnBoard(newRook, WHITE_QUEEN_ROOK);
-  newRook = new Rook{White, *this};
-  putPieceOnBoard(newRook, WHITE_KING_ROOK);
-  newRook = new Rook{Black, *this};
-  putPieceOnBoard(newRook, BLACK_QUEEN_ROOK);
-  newRook = new Rook{Black, *this};
-  putPieceOnBoard(newRook, BLACK_KING_ROOK);
+bool ChessBoard::isPlayerInCheck(Player p) const {
+  return (p == White) ? isPlayerInCheck<White>() : isPlayerInCheck<Black>();
+}
 
-  // Queens
-  Piece* newQueen = new Queen{White, *this};
-  putPieceOnBoard(newQueen, WHITE_QUEEN);
-  newQueen = new Queen{Black, *this};
-  putPieceOnBoard(newQueen, BLACK_QUEEN);
+bool ChessBoard::isPlayerInCheckmate(Player p) {
+  return (p == White) ? isPlayerInCheckmate<White>() :
+    isPlayerInCheckmate<Black>();
+}
 
-  // Kings
-  Piece* newKing = new King{White, *this};
-  putPieceOnBoard(newKing, WHITE_KING_START_SQUARE);
-  newKing = new King{Black, *this};
-  putPieceOnBoard(newKing, BLACK_KING_START_SQUARE);
-  
-  cout << "A new chess game is started!" << endl;
+bool ChessBoard::isAbleToTakeOrBlock(Square defender,
+				     Square threat,
+				     Square king) {
+  return (getPiece(defender)->getColour() == White) ?
+    isAbleToTakeOrBlock<White>(defender, threat, king) :
+    isAbleToTakeOrBlock<Black>(defender, threat, king);
 }
 
-void ChessBoard::putPieceOnBoard(Piece* piece, string position) {
-  try {
-    Square square{position};
-    int rank = square.getRank();
-    int file = square.getFile();
-    board[rank][file] = piece;
-  } catch (OffBoardError const& e) {
-    cerr << "You cannot place a piece there," << endl;
-    cerr << e.what() << endl;
+bool ChessBoard::isCastlePossible(bool isKingside) {
+  return (player == White) ? isCastlePossible<White>(isKingside) :
+    isCastlePossible<Black>(isKingside);
+}
+
+bool ChessBoard::isPlayerInStalemate(Player p) {
+  return (p == White) ? isPlayerInStalemate<White>() :
+    isPlayerInStalemate<Black>();
+}
+
+GameStatus ChessBoard::announceStatus() {
+  bool isCheck = isPlayerInCheck(!player);
+  if (isCheck) {
+    if (isPlayerInCheckmate(!player)) {
+      cout << !player << " is in checkmate" << endl;
+      return Checkmate;
+    } else {
+      cout << !player << " is in check" << endl;
+    }
+  } else if (isPlayerInStalemate(!player)) {
+    cout << !player << " is in stalemate" << endl;
+    return Stalemate;
+  }
+
+  // The player has not been swapped over yet, so the hash of the position
+  // with the opponent to move is needed
+  if (countRepetitions(hash ^ blackToMoveKey(), 2) >= 2) {
+    cout << "The game is drawn by threefold repetition" << endl;
+    return ThreefoldRepetition;
+  }
+  if (isFiftyMoveRuleDraw()) {
+    cout << "The game is drawn by the fifty-move rule" << endl;
+    return FiftyMoveRule;
   }
+  return (isCheck) ? Check : InProgress;
 }
 
-void ChessBoard::clearBoard() {
+// ---------- Getter functions -------------------------------------------------
+
+Square ChessBoard::getKingStartSquare(Player player) const {
+  return (player == White) ? getKingStartSquare<White>() :
+    getKingStartSquare<Black>();
+}
+
+Square ChessBoard::getKingsideRookStartSquare(Player player) const {
+  return (player == White) ? getKingsideRookStartSquare<White>() :
+    getKingsideRookStartSquare<Black>();
+}
+
+Square ChessBoard::getQueensideRookStartSquare(Player player) const {
+  return (player == White) ? getQueensideRookStartSquare<White>() :
+    getQueensideRookStartSquare<Black>();
+}
+
+Square ChessBoard::getKingPosition(Player p) const {
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      delete this->board[i][j];
-      this->board[i][j] = nullptr;
+      if (board[i][j] != nullptr &&
+	  board[i][j]->getColour() == p &&
+	  board[i][j]->getType() == KingType) {
+	return Square{i, j};
+      }
     }
   }
+  string colour = (p == White) ? "White" : "Black";
+  string message = "The " + colour + " King";
+  throw OffBoardError{message};
 }
 
-void ChessBoard::swapPlayer() {
-  player = !player;
+Piece* ChessBoard::getPiece(Square square) const {
+  int rank = square.getRank();
+  int file = square.getFile();
+  return board[rank][file];
 }
 
-string ChessBoard::makeMove(Square sourceSquare, Square destinationSquare) {
-  string opponentPiece;
-  Piece* destination = getPiece(destinationSquare);
+// ---------- Helper functions for one colour ----------------------------------
 
-  int sourceRank = sourceSquare.getRank();
-  int sourceFile = sourceSquare.getFile();
-  int destinationRank = destinationSquare.getRank();
-  int destinationFile = destinationSquare.getFile();
+template <Player Us>
+bool ChessBoard::isMoveLegal(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(MoveLegalCount);
+
+  // Move the pointers on the board, check whether the player is in check
+  // as a result and put them back. A taken Piece is only taken off the
+  // board, so nothing has to be created again.
   
-  if (destination != nullptr) {
-    opponentPiece = destination->getName();
-    delete destination;
-  } else {
-    opponentPiece = "";
-  }
-  board[destinationRank][destinationFile] = board[sourceRank][sourceFile];
-  board[sourceRank][sourceFile] = nullptr;
-  return opponentPiece;
+  Piece*& source = board[sourceSquare.getRank()][sourceSquare.getFile()];
+  Piece*& destination =
+    board[destinationSquare.getRank()][destinationSquare.getFile()];
+  Piece* piece = source;
+  Piece* takenPiece = destination;
+  Bitboard occupiedBefore = occupied;
+  
+  destination = piece;
+  source = nullptr;
+  occupied &= ~squareBit(sourceSquare.getIndex());
+  occupied |= squareBit(destinationSquare.getIndex());
+  bool isLegal = !isPlayerInCheck<Us>();
+  source = piece;
+  destination = takenPiece;
+  occupied = occupiedBefore;
+  
+  return isLegal;
 }
 
-// ---------- Checker functions ------------------------------------------------
+template <Player Us>
+bool ChessBoard::isPlayerInCheck() const {
+  STATS_TIME(CheckTime, CheckLatency);
 
-bool ChessBoard::isPlayerInCheck(Player p) const {
   // For each square on the board, if there is an opponent piece there,
   // check if it is possible for the piece to take the king - if yes, then
   // the player is in check
-  Square kingPosition = getKingPosition(p);
+  Square kingPosition = getKingPosition(Us);
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      if (board[i][j] != nullptr && board[i][j]->getColour() == !p) {
+      if (board[i][j] != nullptr && board[i][j]->getColour() == !Us) {
 	if (board[i][j]->isMovePossible(Square{i, j}, kingPosition)) {
 	  return true;
 	}
@@ -433,19 +1191,23 @@ bool ChessBoard::isPlayerInCheck(Player p) const {
   return false;
 }
 
-bool ChessBoard::isPlayerInCheckmate(Player p) {
+template <Player Us>
+bool ChessBoard::isPlayerInCheckmate() {
+  STATS_TIME(CheckmateTime, CheckmateLatency);
+
   // Check if King has any legal moves
-  Square kingPosition = getKingPosition(p);
+  Square kingPosition = getKingPosition(Us);
   if (getPiece(kingPosition)->isAnyLegalMovePossible(kingPosition)) {
     return false;
   }
 
   // Search the board for Pieces that threaten the King
-  Square threateningPiece;
+  // threateningPiece is only used once a threat has been found
+  Square threateningPiece = kingPosition;
   int threatCount = 0;
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      if (board[i][j] != nullptr && board[i][j]->getColour() == !p) {
+      if (board[i][j] != nullptr && board[i][j]->getColour() == !Us) {
 	if (board[i][j]->isMovePossible(Square{i, j}, kingPosition)) {
 	  threateningPiece = Square{i, j};	  
 	  threatCount++;
@@ -469,61 +1231,39 @@ bool ChessBoard::isPlayerInCheckmate(Player p) {
   // that can move to block or take it.
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      if (board[i][j] != nullptr && board[i][j]->getColour() == p) {
+      if (board[i][j] != nullptr && board[i][j]->getColour() == Us) {
 	Square defender = Square{i, j};
-	if (isAbleToTakeOrBlock(defender, threateningPiece, kingPosition)) {
+	if (isAbleToTakeOrBlock<Us>(defender, threateningPiece,
+				    kingPosition)) {
 	  return false;
 	}
       }
     }
   }
-  	  
+	  
   return true;
 }
 
+template <Player Us>
 bool ChessBoard::isAbleToTakeOrBlock(Square defender,
 				     Square threat,
 				     Square king) {
-  int rankChange = king.getRank() - threat.getRank();
-  int fileChange = king.getFile() - threat.getFile();
-
   // Check if it is possible to take the threatening piece
   if (getPiece(defender)->isMovePossible(defender, threat) &&
-      isMoveLegal(defender, threat)) {
+      isMoveLegal<Us>(defender, threat)) {
     return true;
   }
 
-  // Check if the threatening piece is a Pawn or a Knight as
-  // neither can be blocked
-  if (getPiece(threat)->getName() == "Knight" ||
-      getPiece(threat)->getName() == "Pawn") {
-    return false;
-  }
-
-  // We know that the threatening piece can move to take the King,
-  // and that it is either a Bishop, a Rook or a Queen, so it
-  // is either moving along the diagonal or a rank or file
-  bool isAlongDiagonal = (abs(rankChange) == abs(fileChange));
-  int pathSteps;
-  
-  if (isAlongDiagonal) {
-    pathSteps = abs(rankChange); // could equally be fileChange
-  } else { // in this case it is moving along a rank or file
-    // summing rank and file change is okay since one of the terms will be 0
-    pathSteps = abs(rankChange + fileChange);
-  }
-
   // Check if defender can move to any squares in the threatening piece's
-  // path to the King - i.e. can the defender block it
-  for (int i = 1; i < pathSteps; i++) {
-    int rankStep = (rankChange == 0) ? 0 : i * rankChange / abs(rankChange);
-    int fileStep = (fileChange == 0) ? 0 : i * fileChange / abs(fileChange);
-
-    Square squareInPath = Square(threat.getRank() + rankStep,
-				 threat.getFile() + fileStep);
-
+  // path to the King - i.e. can the defender block it. A Pawn or a Knight
+  // giving check is either next to the King or not on a line with it, so
+  // there is nothing between them to block.
+  Bitboard path = squaresBetween(threat.getIndex(), king.getIndex());
+  while (path) {
+    int squareIndex = popLowestSquare(path);
+    Square squareInPath{rankOf(squareIndex), fileOf(squareIndex)};
     if (getPiece(defender)->isMovePossible(defender, squareInPath) &&
-	isMoveLegal(defender, squareInPath)) {
+	isMoveLegal<Us>(defender, squareInPath)) {
       return true;
     }
   }
@@ -531,81 +1271,205 @@ bool ChessBoard::isAbleToTakeOrBlock(Square defender,
   return false;
 }
 
-bool ChessBoard::isPlayerInStalemate(Player p) {
-  // For each of the player's pieces on the chessboard,
-  // check if they have any legal moves
+template <Player Us>
+bool ChessBoard::isCastlePossible(bool isKingside) {
+  Square kingPosition = getKingStartSquare<Us>();
+  Square rookPosition = (isKingside) ? getKingsideRookStartSquare<Us>() :
+    getQueensideRookStartSquare<Us>();
+
+  Piece* king = getPiece(kingPosition);
+  Piece* rook = getPiece(rookPosition);
+  if (king == nullptr || king->getType() != KingType ||
+      king->getColour() != Us || !king->isFirstMove() ||
+      rook == nullptr || rook->getType() != RookType ||
+      rook->getColour() != Us || !rook->isFirstMove()) {
+    return false;
+  }
+
+  if (!isPathClear(kingPosition, rookPosition)) {
+    return false;
+  }
+
+  int fileStep = (isKingside) ? 1 : -1;
+  Square pathSquare{kingPosition.getRank(), KING_START_FILE + fileStep};
+  Square kingDestination{kingPosition.getRank(),
+			 KING_START_FILE + 2 * fileStep};
+  return (!isPlayerInCheck<Us>() &&
+	  isMoveLegal<Us>(kingPosition, pathSquare) &&
+	  isMoveLegal<Us>(kingPosition, kingDestination));
+}
+
+template <Player Us>
+bool ChessBoard::isPlayerInStalemate() {
+  STATS_TIME(StalemateTime, StalemateLatency);
+  return countLegalMoves<Us>() == 0;
+}
+
+template <Player Us>
+vector<Move> ChessBoard::getLegalMoves() {
+  vector<Move> moves;
+
+  // Try every Piece of the player on every square of the board
   for (int i = 0; i < BOARD_LENGTH; i++) {
     for (int j = 0; j < BOARD_WIDTH; j++) {
-      if (board[i][j] != nullptr && board[i][j]->getColour() == p) {
-	Square s = Square{i, j};
-	if (getPiece(s)->isAnyLegalMovePossible(s)) {
-	  return false;
+      if (board[i][j] == nullptr || board[i][j]->getColour() != Us) {
+	continue;
+      }
+      Square source{i, j};
+      for (int k = 0; k < BOARD_LENGTH; k++) {
+	for (int l = 0; l < BOARD_WIDTH; l++) {
+	  Square destination{k, l};
+	  if (board[i][j]->isMovePossible(source, destination) &&
+	      isMoveLegal<Us>(source, destination)) {
+	    moves.emplace_back(source, destination);
+	  }
 	}
       }
     }
   }
-  return true;
+
+  // King moves two squares towards the Rook when castling
+  Square kingPosition = getKingStartSquare<Us>();
+  if (isCastlePossible<Us>(true)) {
+    Square kingDestination{kingPosition.getRank(), KING_START_FILE + 2};
+    moves.emplace_back(kingPosition, kingDestination, true);
+  }
+  if (isCastlePossible<Us>(false)) {
+    Square kingDestination{kingPosition.getRank(), KING_START_FILE - 2};
+    moves.emplace_back(kingPosition, kingDestination, true);
+  }
+  return moves;
 }
 
-bool ChessBoard::isGameContinuing() {
-  if (isPlayerInCheck(!player)) {
-    if (isPlayerInCheckmate(!player)) {
-      cout << !player << " is in checkmate" << endl;
-      return false;
-    } else {
-      cout << !player << " is in check" << endl;
-      return true;
+template <Player Us>
+int ChessBoard::countLegalMoves() {
+  Bitboard pieces[2][PIECE_TYPE_COUNT] = {};
+  for (int i = 0; i < BOARD_LENGTH; i++) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+      if (board[i][j] != nullptr) {
+	pieces[board[i][j]->getColour()][board[i][j]->getType()] |=
+	  squareBit(squareAt(i, j));
+      }
     }
-  } else if (isPlayerInStalemate(!player)) {
-    cout << !player << " is in stalemate" << endl;
-    return false;
   }
-  return true;
-}
+  Bitboard own = EMPTY_BITBOARD;
+  Bitboard theirs = EMPTY_BITBOARD;
+  for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+    own |= pieces[Us][t];
+    theirs |= pieces[!Us][t];
+  }
+  Bitboard straight = pieces[!Us][RookType] | pieces[!Us][QueenType];
+  Bitboard diagonal = pieces[!Us][BishopType] | pieces[!Us][QueenType];
+
+  // The King may go to any square the opponent does not attack. The lines
+  // of attack are followed through the King, which cannot step back along
+  // one of them.
+  int count = 0;
+  Bitboard target = ~own;
+  Bitboard pinned = EMPTY_BITBOARD;
+  Bitboard kingBit = pieces[Us][KingType];
+  int king = (kingBit != EMPTY_BITBOARD) ? lowestSquare(kingBit) : -1;
+  if (king >= 0) {
+    Bitboard withoutKing = occupied & ~kingBit;
+    Bitboard attacked = pawnAttacks<!Us>(pieces[!Us][PawnType]);
+    Bitboard attackers = pieces[!Us][KnightType];
+    while (attackers) {
+      attacked |= knightAttacks(popLowestSquare(attackers));
+    }
+    attackers = straight;
+    while (attackers) {
+      attacked |= rookAttacks(popLowestSquare(attackers), withoutKing);
+    }
+    attackers = diagonal;
+    while (attackers) {
+      attacked |= bishopAttacks(popLowestSquare(attackers), withoutKing);
+    }
+    attackers = pieces[!Us][KingType];
+    while (attackers) {
+      attacked |= kingAttacks(popLowestSquare(attackers));
+    }
+    count += popCount(kingAttacks(king) & ~own & ~attacked);
+
+    // In double check only the King can move, and in check the other
+    // Pieces must take the checking Piece or block the check
+    Bitboard checkers =
+      (pawnAttacks(Us, king) & pieces[!Us][PawnType]) |
+      (knightAttacks(king) & pieces[!Us][KnightType]) |
+      (rookAttacks(king, occupied) & straight) |
+      (bishopAttacks(king, occupied) & diagonal);
+    if (popCount(checkers) > 1) {
+      return count;
+    }
+    if (checkers) {
+      target &= checkers | squaresBetween(lowestSquare(checkers), king);
+    }
 
-// ---------- Getter functions -------------------------------------------------
+    // A Piece which is the only one between its King and a Rook, Bishop or
+    // Queen of the opponent can only move along the line between them
+    Bitboard snipers = (rookAttacks(king, EMPTY_BITBOARD) & straight) |
+      (bishopAttacks(king, EMPTY_BITBOARD) & diagonal);
+    while (snipers) {
+      Bitboard between = squaresBetween(king, popLowestSquare(snipers)) &
+	occupied;
+      if (popCount(between) == 1 && (between & own)) {
+	pinned |= between;
+      }
+    }
+  }
 
-Square ChessBoard::getKingStartSquare(Player player) {
-  if (player == White) {
-    return Square{WHITE_KING_START_SQUARE};
-  } else {
-    return Square{BLACK_KING_START_SQUARE};
+  // Pawns move forward onto empty squares, two at a time from their
+  // starting rank, and take diagonally. There is no promotion, so a Pawn
+  // on the last rank cannot move.
+  Bitboard empty = ~occupied;
+  for (int t = PawnType; t < KingType; t++) {
+    Bitboard sources = pieces[Us][t];
+    while (sources) {
+      int source = popLowestSquare(sources);
+      Bitboard destinations = EMPTY_BITBOARD;
+      switch (static_cast<PieceType>(t)) {
+      case PawnType: {
+	Bitboard pawn = squareBit(source);
+	Bitboard oneStep = pawnPushes<Us>(pawn) & empty;
+	Bitboard twoSteps = pawnPushes<Us>(
+	  oneStep & pawnPushes<Us>(relativeRankBitboard<Us>(RANK_TWO))) &
+	  empty;
+	destinations = oneStep | twoSteps | (pawnAttacks(Us, source) & theirs);
+	break;
+      }
+      case KnightType: destinations = knightAttacks(source); break;
+      case BishopType: destinations = bishopAttacks(source, occupied); break;
+      case RookType: destinations = rookAttacks(source, occupied); break;
+      case QueenType: destinations = queenAttacks(source, occupied); break;
+      default: break;
+      }
+      destinations &= target;
+      if (pinned & squareBit(source)) {
+	destinations &= lineThrough(king, source);
+      }
+      count += popCount(destinations);
+    }
   }
-}
 
-Square ChessBoard::getKingsideRookStartSquare(Player player) {
-  if (player == White) {
-    return Square{WHITE_KING_ROOK};
-  } else {
-    return Square{BLACK_KING_ROOK};
+  if (isCastlePossible<Us>(true)) {
+    count++;
+  }
+  if (isCastlePossible<Us>(false)) {
+    count++;
   }
+  return count;
 }
 
-Square ChessBoard::getQueensideRookStartSquare(Player player) {
-  if (player == White) {
-    return Square{WHITE_QUEEN_ROOK};
-  } else {
-    return Square{BLACK_QUEEN_ROOK};
-  }
+template <Player Us>
+Square ChessBoard::getKingStartSquare() const {
+  return Square{relativeRank<Us>(MIN_RANK), KING_START_FILE};
 }
 
-Square ChessBoard::getKingPosition(Player p) const {
-  for (int i = 0; i < BOARD_LENGTH; i++) {
-    for (int j = 0; j < BOARD_WIDTH; j++) {
-      if (board[i][j] != nullptr &&
-	  board[i][j]->getColour() == p &&
-	  board[i][j]->getName() == "King") {
-	return Square{i, j};
-      }
-    }
-  }
-  string colour = (p == White) ? "White" : "Black";
-  string message = "The " + colour + " King";
-  throw OffBoardError{message};
+template <Player Us>
+Square ChessBoard::getKingsideRookStartSquare() const {
+  return Square{relativeRank<Us>(MIN_RANK), KINGSIDE_ROOK_START_FILE};
 }
 
-Piece* ChessBoard::getPiece(Square square) const {
-  int rank = square.getRank();
-  int file = square.getFile();
-  return board[rank][file];
+template <Player Us>
+Square ChessBoard::getQueensideRookStartSquare() const {
+  return Square{relativeRank<Us>(MIN_RANK), QUEENSIDE_ROOK_START_FILE};
 }
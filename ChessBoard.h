@@ -2,6 +2,7 @@
 #define CHESSBOARD_H
 
 #include "Square.h"
+#include "Bitboard.h"
 #include "Player.h"
 #include "Piece.h"
 #include "Pawn.h"
@@ -10,15 +11,66 @@
 #include "Rook.h"
 #include "Queen.h"
 #include "King.h"
+#include "PieceArena.h"
+#include "Move.h"
+#include "GameStatus.h"
+#include "PieceType.h"
+#include "Zobrist.h"
 #include "constants.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <type_traits>
+#include <vector>
 
-/* The ChessBoard class contains a Player enumerator and and a Piece
-   (triple) pointer. When a ChessBoard object is constructed, an 8x8
-   array of Piece pointers is constructed. This array represents the 
-   squares on a chessboard, and the Piece pointers point to Piece objects
-   or null if there is no Piece there. A Square object's rank and
-   file can be used to index a location on the board. */
+class SnapshotPublisher; // Forward declaration to avoid circular dependencies
+
+/* A Snapshot holds the state of a ChessBoard, apart from its move history,
+   in 66 bytes: one byte for each square, giving the type and colour of the
+   Piece there and whether it has moved (0 for an empty square), one byte
+   for the player to move and one for the halfmove clock, which stops at
+   255 as in GameState. It has no pointers, so it can be copied and stored
+   freely, and put back on any ChessBoard with ChessBoard::restore(). */
+
+struct Snapshot {
+  uint8_t squares[BOARD_LENGTH][BOARD_WIDTH];
+  uint8_t player;
+  uint8_t halfmoveClock;
+};
+
+static_assert(std::is_trivially_copyable<Snapshot>::value,
+	      "a Snapshot must be copyable with memcpy");
+
+/* A HistoryEntry records one move made on a ChessBoard, with what is needed
+   to take it back without replaying the game.
+   move is the move that was made.
+   hash is the hash of the position before the move.
+   halfmoveClock is the halfmove clock before the move.
+   captured is the type of the Piece that was taken, or NoPieceType.
+   hadMoved and capturedHadMoved are the hasMoved values of the moving and
+   the taken Piece before the move, which hold the castling rights.
+   isPlayerSwapped is false if the move ended the game, in which case the
+   player was not swapped over. */
+
+struct HistoryEntry {
+  Move move;
+  HashKey hash = 0;
+  int halfmoveClock = 0;
+  PieceType captured = NoPieceType;
+  bool hadMoved = false;
+  bool capturedHadMoved = false;
+  bool isPlayerSwapped = true;
+};
+
+/* The ChessBoard class contains a Player enumerator, an 8x8 array of Piece
+   pointers and a PieceArena. The array represents the squares on a
+   chessboard, and the Piece pointers point to Piece objects or null if
+   there is no Piece there. A Square object's rank and file can be used to
+   index a location on the board. The Piece objects are all constructed in
+   the board's own PieceArena, so setting up, copying or restoring the
+   Pieces never allocates memory on the heap. The move history is a vector,
+   though, which grows as moves are made and is copied with the board, so
+   copying a board with a history does allocate. */
 
 class ChessBoard {
 public:
@@ -28,18 +80,25 @@ public:
      positions and the player set to White. */
   ChessBoard();
 
+  /* Constructs ChessBoard object with the Pieces and the player given by
+     fen, a position in Forsyth-Edwards Notation. No message is output. If 
+     fen is not a valid position then the constructor throws the FenError 
+     exception defined in the "errors.h" file. */
+  ChessBoard(std::string const& fen);
+
   /* Destructor. The ChessBoard object owns all of the objects pointed to
-     in the board array, so this goes through and deletes all of them, and
-     then deletes the array. */
+     in the board array. They are stored in its PieceArena, so they are all
+     freed at once. */
   ~ChessBoard();
 
   /* Overloaded assignement operator. This function ensures deep copies
      are made of the board array, and that the Pieces pointed to by the
-     copied board array contain references to the copied board. */
+     copied board array are in this board's PieceArena and contain 
+     references to the copied board. */
   ChessBoard& operator=(ChessBoard const& otherBoard);
 
-  /* Copy constructor. Creates the board array and then calls the assignment
-     operator to copy the contents of otherBoard to this. */
+  /* Copy constructor. Calls the assignment operator to copy the contents of
+     otherBoard to this. */
   ChessBoard(ChessBoard const& otherBoard);
   
   // ---------- Checker functions ----------------------------------------------
@@ -53,11 +112,81 @@ public:
      which is the same colour as the opponentColour input. */
   bool isOpponentPieceThere(Square square, Player opponentColour) const;
 
+  /* Checks if the squares between sourceSquare and destinationSquare are
+     all empty, using the line tables in "Bitboard.h". If the two squares
+     are not on the same rank, file or diagonal there are no squares
+     between them, so it returns true. */
+  bool isPathClear(Square sourceSquare, Square destinationSquare) const;
+
   /* Checks if a move from sourceSquare to destinationSquare is legal, 
      i.e. that it doesn't move the player into check. This function does 
      not check if the move follows the rules of how the Piece itself can 
      move. */
   bool isMoveLegal(Square sourceSquare, Square destinationSquare);
+
+  /* Checks if the player to move is in check. */
+  bool isInCheck() const;
+
+  /* Checks if the position has occurred before, with the same player to
+     move and the same castling rights. Only the positions since the last
+     capture or Pawn move are compared, and only every other one, so this is
+     cheap enough to call at every node of a search. */
+  bool isRepetition() const;
+
+  /* Checks if the position has occurred three times, which makes the game
+     a draw. */
+  bool isThreefoldRepetition() const;
+
+  /* Checks if there have been fifty moves by each player without a capture
+     or a Pawn move, which makes the game a draw. */
+  bool isFiftyMoveRuleDraw() const;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns a copy of the player to move. */
+  Player getPlayer() const;
+
+  /* Returns the position in Forsyth-Edwards Notation. The en passant square
+     is always "-" and the fullmove number is always 1, because the board
+     does not keep track of them. */
+  std::string getFen() const;
+
+  /* Returns the number of halfmoves since the last capture or Pawn move. */
+  int getHalfmoveClock() const;
+
+  /* Returns the squares with a Piece on them. */
+  Bitboard getOccupied() const;
+
+  /* Returns whether the player to move is in check, checkmate or stalemate,
+     or whether the game is drawn by repetition or the fifty-move rule. */
+  GameStatus getStatus();
+
+  /* Returns every legal move of the player to move, including castles. */
+  std::vector<Move> getLegalMoves();
+
+  /* Returns the number of legal moves of the player to move, including
+     castles, which is the size of getLegalMoves(). The other moves are
+     counted with popcounts of the squares each Piece can legally move to,
+     worked out with Bitboards from the checks and pins on the King, so
+     none of them is made or listed. Castles are still tested as
+     isCastlePossible() does, by moving the King across for a moment. */
+  int countLegalMoves();
+
+  /* Returns the total value of p's Pieces, not counting the King, using the
+     values in "constants.h". */
+  int getMaterial(Player p) const;
+
+  /* Returns the Zobrist hash of the position, which is kept up to date as
+     moves are made. It is the same as GameState::getHash() for the same
+     position. */
+  HashKey getHash() const;
+
+  /* Returns the number of moves which can be taken back. */
+  std::size_t getHistoryLength() const;
+
+  /* Returns a Snapshot of the position, including which Pieces have moved,
+     so that it can be put back later with restore(). */
+  Snapshot snapshot() const;
   
   // ---------- Other functions ------------------------------------------------
 
@@ -65,6 +194,48 @@ public:
      board in the correct starting positions. */
   void resetBoard();
 
+  /* Clears the board and sets up the position given by fen, which is in 
+     Forsyth-Edwards Notation, including the halfmove clock if it is given.
+     No message is output. If fen is not a valid position then the function
+     throws the FenError exception defined in the "errors.h" file and the
+     board is left as it was. */
+  void setPosition(std::string const& fen);
+
+  /* Puts the board back to the position in the input Snapshot, taken from
+     this or any other ChessBoard. Only the squares which differ from the
+     Snapshot get new Pieces, in the board's PieceArena, so nothing is
+     allocated on the heap, and the hash is updated rather than worked out
+     again. If a publisher is set, the position is also published, along
+     with its status. The halfmove clock is put back too, but the move
+     history is cleared, so a repetition before the Snapshot was taken is
+     not counted. No message is output. */
+  void restore(Snapshot const& state);
+
+  /* Makes a move taken from getLegalMoves() and swaps the player over. The
+     move is not checked and no message is output, so this is the function
+     to use when searching through moves. The move is added to the history
+     so that it can be taken back. */
+  void playMove(Move move);
+
+  /* Takes back the last move made by submitMove() or playMove(), in 
+     constant time. The move can be made again with redo() until a new move
+     is made. Returns false, and does nothing, if there is no move to take
+     back. No message is output. */
+  bool takeback();
+
+  /* Makes the last move taken back again, in constant time. Returns false, 
+     and does nothing, if there is no move to redo. No message is output. */
+  bool redo();
+
+  /* Makes the board publish a BoardSnapshot to publisher straight away and
+     after every later change: each move made by submitMove(), takeback(),
+     redo(), resetBoard(), setPosition() or restore(), so that other threads
+     can read the position without locks while this one plays. playMove()
+     does not publish, as it is used to search. A null publisher stops the
+     publishing. The publisher must outlive the board, or be replaced first.
+     Copies of the board do not publish. */
+  void setPublisher(SnapshotPublisher* publisher);
+
   /* Allows a move from sourceSquare to destinationSquare to be made as long
      as it is in line with the rules of chess. If it is not, it outputs
      an informative error message. If it is, it outputs a message stating the 
@@ -88,10 +259,45 @@ public:
      castleCode = "O-O" for kingside castle, or "O-O-O" for queenside castle.
      These codes were chosen to be in line with standard chess notation. */
   void submitMove(char playerColour, std::string castleCode);
+
+  /* Makes move if it is in line with the rules of chess, with the same
+     checks and messages as the versions above, which read their inputs
+     into a Move and call this. Nothing is parsed, so this is the version
+     for programs to use. A castle must be flagged as one, with the King's
+     starting square as the source and the square two files towards the
+     Rook as the destination, as in getLegalMoves(). */
+  void submitMove(Move move);
   
 private:
-  Piece*** board;
+  /* Bitbase::probe() reads the board array and the player to look up
+     endgame positions. */
+  friend class Bitbase;
+
+  /* Benchmark times the private primitives, such as isPlayerInCheck(), on
+     their own. */
+  friend class Benchmark;
+
+  /* Validator compares the check, checkmate and stalemate tests with the
+     ones of GameState. */
+  friend class Validator;
+
+  Piece* board[BOARD_LENGTH][BOARD_WIDTH] = {};
+  // The squares of the board array which are not null, kept up to date
+  // whenever a pointer in it changes
+  Bitboard occupied = EMPTY_BITBOARD;
+  PieceArena pieces;
   Player player = White;
+  HashKey hash = 0;
+  int halfmoveClock = 0;
+
+  // Moves [0, historyLength) have been made, and any after that have been
+  // taken back and can be redone
+  std::vector<HistoryEntry> history;
+  std::size_t historyLength = 0;
+
+  // Where a BoardSnapshot is published after each change, if anywhere. It is
+  // not copied with the board, so copies made to search are never seen.
+  SnapshotPublisher* publisher = nullptr;
   
   // ---------- Helper functions -----------------------------------------------
 
@@ -103,16 +309,70 @@ private:
      input, which is a string in rank and file form, e.g. "E2". */
   void putPieceOnBoard(Piece* piece, std::string square);
 
-  /* Removes all the Pieces from the board. Does not delete the board itself. */
+  /* Returns a pointer to a new Piece in the PieceArena, described by the
+     Forsyth-Edwards Notation letter input, e.g. 'P' for a White Pawn and 'k'
+     for a Black King. Returns nullptr if the letter is not a Piece. */
+  Piece* createPiece(char fenLetter);
+
+  /* Returns a pointer to a new Piece in the PieceArena of the input type
+     and colour. */
+  Piece* createPiece(PieceType type, Player colour);
+
+  /* Returns the Forsyth-Edwards Notation letter of the input Piece. */
+  char getFenLetter(Piece const* piece) const;
+
+  /* Removes all the Pieces from the board, frees their slots in the
+     PieceArena and clears the move history. */
   void clearBoard();
 
   /* Changes the player over. */
   void swapPlayer();
 
-  /* Moves a piece from sourceSquare to destinationSquare. If there was a 
-     piece on the destinationSquare then makeMove returns a string containing
-     the name of the piece. If there wasn't a piece there it returns an empty
-     string. */
+  /* Works out the hash of the position from scratch. */
+  HashKey computeHash() const;
+
+  /* Returns the castling rights as bits of the kind defined in "Zobrist.h",
+     i.e. which Kings and Rooks are both on their starting squares and have
+     not moved. */
+  int getCastlingRights() const;
+
+  /* Returns how many times the position with hash key has occurred in the
+     history since the last capture or Pawn move, with the same player to
+     move as now, stopping once maxCount is reached. */
+  int countRepetitions(HashKey key, int maxCount) const;
+
+  /* Adds move, which is about to be made, to the history, removing any 
+     moves that had been taken back. */
+  void recordMove(Move move);
+
+  /* Makes a move taken from getLegalMoves(), including moving the Rook of a
+     castle, setting hasMoved and updating the hash, but does not swap the
+     player over. Returns the name of the Piece taken, as makeMove() does. */
+  std::string applyMove(Move move);
+
+  /* Swaps the player over if announceStatus() says the game is not over,
+     and otherwise marks the last move in the history as having ended the
+     game. Then publishes the position, if there is a publisher. */
+  void finishMove();
+
+  /* Gives the publisher, if there is one, a BoardSnapshot of the position,
+     with status as its GameStatus. */
+  void publish(GameStatus status);
+
+  /* Works out the GameStatus and publishes the position, if there is a
+     publisher, for the functions which change the board without checking
+     the status themselves. */
+  void publishPosition();
+
+  /* Makes move, a castle by the player to move, if it is in line with the
+     rules of chess, and outputs the messages of the castle version of
+     submitMove(). */
+  void submitCastle(Move move);
+
+  /* Moves a piece from sourceSquare to destinationSquare, updating the hash
+     for the Pieces moved and taken. If there was a piece on the 
+     destinationSquare then makeMove returns a string containing the name of
+     the piece. If there wasn't a piece there it returns an empty string. */
   std::string makeMove(Square sourceSquare, Square destinationSquare);
 
   // ---------- Checker functions ----------------------------------------------
@@ -132,26 +392,54 @@ private:
      the threatening piece and the king.*/
   bool isAbleToTakeOrBlock(Square defender, Square threat, Square king);
 
-  /* Goes through each piece on the board and checks if it's colour matches
-     the player. If yes, check if the piece has any legal moves. */
+  /* Checks if the player to move can castle on the input side, in the same
+     way as the castle version of submitMove(), but without any output. */
+  bool isCastlePossible(bool isKingside);
+
+  /* Checks if the player has no legal moves, by counting them in the same
+     way as countLegalMoves(). */
   bool isPlayerInStalemate(Player p);
 
   /* Checks if the opponent is in check, if yes then it checks for checkmate.
-     Otherwise it checks for stalemate. It outputs an informative message
-     if any of these are true. It returns false if the opponent is in 
-     checkmate or stalemate, and true otherwise. */
-  bool isGameContinuing();
+     Otherwise it checks for stalemate. Then it checks for a draw by 
+     threefold repetition or the fifty-move rule. It outputs an informative
+     message if any of these are true, and returns the GameStatus of the
+     opponent. */
+  GameStatus announceStatus();
+
+  /* The versions of isMoveLegal(), isPlayerInCheck(), isPlayerInCheckmate(),
+     isAbleToTakeOrBlock(), isCastlePossible() and isPlayerInStalemate()
+     for the Pieces of player Us, with getLegalMoves() and countLegalMoves()
+     for Us to move. The functions above find the colour and call one of
+     these, so the colour is a constant in all the work they do, and the
+     starting squares and the opponent's colour cost nothing to work out. */
+  template <Player Us>
+  bool isMoveLegal(Square sourceSquare, Square destinationSquare);
+  template <Player Us> bool isPlayerInCheck() const;
+  template <Player Us> bool isPlayerInCheckmate();
+  template <Player Us>
+  bool isAbleToTakeOrBlock(Square defender, Square threat, Square king);
+  template <Player Us> bool isCastlePossible(bool isKingside);
+  template <Player Us> bool isPlayerInStalemate();
+  template <Player Us> std::vector<Move> getLegalMoves();
+  template <Player Us> int countLegalMoves();
 
   // ---------- Getter functions -----------------------------------------------
 
   /* Returns the square that the input player's King starts on. */
-  Square getKingStartSquare(Player player);
+  Square getKingStartSquare(Player player) const;
 
   /* Returns the square that the input player's kingside Rook starts on. */
-  Square getKingsideRookStartSquare(Player player);
+  Square getKingsideRookStartSquare(Player player) const;
 
   /* Returns the square that the input player's queenside Rook starts on. */
-  Square getQueensideRookStartSquare(Player player);
+  Square getQueensideRookStartSquare(Player player) const;
+
+  /* The versions of the three functions above for player Us, which do not
+     have to look at the colour. */
+  template <Player Us> Square getKingStartSquare() const;
+  template <Player Us> Square getKingsideRookStartSquare() const;
+  template <Player Us> Square getQueensideRookStartSquare() const;
 
   /* Returns the current position of p's King. If it is not on the board
      then it throws the OffBoardError exception. */
@@ -0,0 +1,273 @@
+/* This file contains the member functions of the GameDatabaseWriter,
+   GameDatabase and GameReplay classes, the operator overload for the
+   GameOutcome enumeration and the functions which read and write
+   little-endian numbers. */
+
+#include "GameDatabase.h"
+#include "GameState.h"
+#include "Move.h"
+#include "errors.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char FILE_MAGIC[] = "CHESSGD1";
+const int FILE_MAGIC_LENGTH = 8;
+
+// Number of bytes the offset of a game's moves takes in its index entry
+const int OFFSET_BYTES = 6;
+
+// ---------- Functions --------------------------------------------------------
+
+void writeLittleEndian(uint8_t* bytes, uint64_t value, int size) {
+  for (int i = 0; i < size; i++) {
+    bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint64_t readLittleEndian(uint8_t const* bytes, int size) {
+  uint64_t value = 0;
+  for (int i = 0; i < size; i++) {
+    value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+// ---------- Enumeration operator overloads -----------------------------------
+
+ostream& operator<<(ostream& os, const GameOutcome& outcome) {
+  switch (outcome) {
+  case WhiteWins: os << "1-0"; break;
+  case BlackWins: os << "0-1"; break;
+  case Drawn: os << "1/2-1/2"; break;
+  case Unfinished: os << "*"; break;
+  }
+  return os;
+}
+
+// ---------- GameDatabaseWriter -----------------------------------------------
+
+GameDatabaseWriter::GameDatabaseWriter(string const& fileName)
+  : fileName(fileName), file(fileName, ios::binary | ios::trunc) {
+  if (!file) {
+    throw GameDatabaseError{fileName, "could not be opened"};
+  }
+
+  // The header is written again by close(), once the counts are known
+  uint8_t header[GAMEDB_HEADER_BYTES] = {};
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+GameDatabaseWriter::~GameDatabaseWriter() {
+  try {
+    close();
+  } catch (GameDatabaseError const&) {}
+}
+
+size_t GameDatabaseWriter::getGameCount() const {
+  return index.size() / GAMEDB_ENTRY_BYTES;
+}
+
+size_t GameDatabaseWriter::addGame(GameHeader const& header,
+				   vector<Move> const& moves) {
+  size_t game = getGameCount();
+  if (isClosed) {
+    throw GameDatabaseError{fileName, "is closed"};
+  }
+
+  // Encode the whole game before writing any of it, so that a game with an
+  // illegal move is left out altogether
+  vector<uint8_t> encoded;
+  encoded.reserve(moves.size());
+  GameState state;
+  Move legalMoves[MAX_MOVES];
+  for (size_t ply = 0; ply < moves.size(); ply++) {
+    int moveCount = state.getLegalMoves(legalMoves);
+    int i = 0;
+    while (i < moveCount && !(legalMoves[i] == moves[ply])) {
+      i++;
+    }
+    if (i == moveCount) {
+      throw GameDatabaseError{fileName, "cannot store game " +
+			      to_string(game) + ", whose move " +
+			      to_string(ply + 1) + " is not legal"};
+    }
+    encoded.push_back(static_cast<uint8_t>(i));
+    state.playMove(moves[ply]);
+  }
+
+  file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+  if (!file) {
+    throw GameDatabaseError{fileName, "could not be written"};
+  }
+
+  uint8_t entry[GAMEDB_ENTRY_BYTES] = {};
+  writeLittleEndian(entry, offset, OFFSET_BYTES);
+  entry[OFFSET_BYTES] = static_cast<uint8_t>(header.outcome);
+  writeLittleEndian(entry + 8, header.whiteId, 4);
+  writeLittleEndian(entry + 12, header.blackId, 4);
+  index.insert(index.end(), entry, entry + GAMEDB_ENTRY_BYTES);
+  offset += encoded.size();
+  return game;
+}
+
+void GameDatabaseWriter::close() {
+  if (isClosed) {
+    return;
+  }
+  isClosed = true;
+
+  file.write(reinterpret_cast<const char*>(index.data()), index.size());
+  uint8_t header[GAMEDB_HEADER_BYTES] = {};
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    header[i] = static_cast<uint8_t>(FILE_MAGIC[i]);
+  }
+  writeLittleEndian(header + 8, getGameCount(), 8);
+  writeLittleEndian(header + 16, offset, 8);
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.close();
+  if (!file) {
+    throw GameDatabaseError{fileName, "could not be written"};
+  }
+}
+
+// ---------- GameDatabase -----------------------------------------------------
+
+GameDatabase::GameDatabase(string const& fileName) : fileName(fileName) {
+  int descriptor = open(fileName.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw GameDatabaseError{fileName, "could not be opened"};
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 || status.st_size < GAMEDB_HEADER_BYTES) {
+    ::close(descriptor);
+    throw GameDatabaseError{fileName, "is too short"};
+  }
+  fileSize = static_cast<size_t>(status.st_size);
+  void* address = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (address == MAP_FAILED) {
+    throw GameDatabaseError{fileName, "could not be mapped into memory"};
+  }
+  bytes = static_cast<uint8_t const*>(address);
+
+  bool isCorrectMagic = true;
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    isCorrectMagic = isCorrectMagic && (bytes[i] == FILE_MAGIC[i]);
+  }
+  uint64_t count = readLittleEndian(bytes + 8, 8);
+  indexOffset = readLittleEndian(bytes + 16, 8);
+  if (!isCorrectMagic || indexOffset < GAMEDB_HEADER_BYTES ||
+      indexOffset > fileSize ||
+      count != (fileSize - indexOffset) / GAMEDB_ENTRY_BYTES ||
+      (fileSize - indexOffset) % GAMEDB_ENTRY_BYTES != 0) {
+    munmap(const_cast<uint8_t*>(bytes), fileSize);
+    throw GameDatabaseError{fileName, "does not hold a game database"};
+  }
+  gameCount = static_cast<size_t>(count);
+}
+
+GameDatabase::~GameDatabase() {
+  munmap(const_cast<uint8_t*>(bytes), fileSize);
+}
+
+string const& GameDatabase::getFileName() const {
+  return fileName;
+}
+
+size_t GameDatabase::getGameCount() const {
+  return gameCount;
+}
+
+size_t GameDatabase::getFileSize() const {
+  return fileSize;
+}
+
+GameHeader GameDatabase::getHeader(size_t game) const {
+  uint8_t const* entry = bytes + indexOffset + game * GAMEDB_ENTRY_BYTES;
+  GameHeader header;
+  uint8_t outcome = entry[OFFSET_BYTES];
+  if (outcome > Unfinished) {
+    throw GameDatabaseError{fileName, "has no valid result for game " +
+			    to_string(game)};
+  }
+  header.outcome = static_cast<GameOutcome>(outcome);
+  header.whiteId = static_cast<uint32_t>(readLittleEndian(entry + 8, 4));
+  header.blackId = static_cast<uint32_t>(readLittleEndian(entry + 12, 4));
+  getMoveIndices(game, header.plyCount);
+  return header;
+}
+
+uint8_t const* GameDatabase::getMoveIndices(size_t game, int& plyCount) const {
+  uint64_t start = getMoveOffset(game);
+  uint64_t end = getMoveOffset(game + 1);
+  if (start < GAMEDB_HEADER_BYTES || end < start || end > indexOffset) {
+    throw GameDatabaseError{fileName, "has no valid moves for game " +
+			    to_string(game)};
+  }
+  plyCount = static_cast<int>(end - start);
+  return bytes + start;
+}
+
+vector<Move> GameDatabase::readGame(size_t game) const {
+  GameReplay replay{*this, game};
+  vector<Move> moves;
+  moves.reserve(replay.getPlyCount());
+  Move move;
+  while (replay.next(move)) {
+    moves.push_back(move);
+  }
+  return moves;
+}
+
+uint64_t GameDatabase::getMoveOffset(size_t game) const {
+  if (game == gameCount) {
+    return indexOffset;
+  }
+  return readLittleEndian(bytes + indexOffset + game * GAMEDB_ENTRY_BYTES,
+			  OFFSET_BYTES);
+}
+
+// ---------- GameReplay -------------------------------------------------------
+
+GameReplay::GameReplay(GameDatabase const& database, size_t game)
+  : database(database), game(game),
+    indices(database.getMoveIndices(game, plyCount)) {}
+
+GameState const& GameReplay::getState() const {
+  return state;
+}
+
+int GameReplay::getPly() const {
+  return ply;
+}
+
+int GameReplay::getPlyCount() const {
+  return plyCount;
+}
+
+bool GameReplay::next(Move& move) {
+  if (ply == plyCount) {
+    return false;
+  }
+  Move legalMoves[MAX_MOVES];
+  int moveCount = state.getLegalMoves(legalMoves);
+  if (indices[ply] >= moveCount) {
+    throw GameDatabaseError{database.getFileName(), "has a move of game " +
+			    to_string(game) + " which is not legal"};
+  }
+  move = legalMoves[indices[ply]];
+  state.playMove(move);
+  ply++;
+  return true;
+}
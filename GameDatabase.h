@@ -0,0 +1,217 @@
+#ifndef GAMEDATABASE_H
+#define GAMEDATABASE_H
+
+#include "GameState.h"
+#include "Move.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Number of bytes in the header at the start of a game database file, and
+// in the entry of each game in the index at its end
+const int GAMEDB_HEADER_BYTES = 32;
+const int GAMEDB_ENTRY_BYTES = 16;
+
+/* Writes the lowest size bytes of value into bytes, lowest byte first,
+   which is how every number in a game database or position index file is
+   stored. */
+void writeLittleEndian(uint8_t* bytes, uint64_t value, int size);
+
+/* Returns the number stored in the size bytes at bytes, lowest byte
+   first. */
+uint64_t readLittleEndian(uint8_t const* bytes, int size);
+
+/* The GameOutcome enumeration is the result of a game stored in a game
+   database. Unfinished is for games which were stopped before the end. */
+
+enum GameOutcome { WhiteWins, BlackWins, Drawn, Unfinished };
+
+/* This function allows a GameOutcome enumerator to be output to the output
+   stream specified, as it is written in PGN: "1-0", "0-1", "1/2-1/2" or
+   "*". */
+std::ostream& operator<<(std::ostream& os, const GameOutcome& outcome);
+
+/* The GameHeader struct holds what a game database knows about a game
+   besides its moves.
+   whiteId and blackId are numbers standing for the two players, which the
+   database does not give any other meaning to.
+   outcome is the result of the game.
+   plyCount is the number of moves made by both players. */
+
+struct GameHeader {
+  uint32_t whiteId = 0;
+  uint32_t blackId = 0;
+  GameOutcome outcome = Unfinished;
+  int plyCount = 0;
+};
+
+/* A game database file holds games which start from the normal starting
+   position, in three parts, with every number stored little-endian:
+   - a header of GAMEDB_HEADER_BYTES bytes: the eight characters "CHESSGD1",
+     the number of games, the offset of the index and eight zero bytes,
+     each number taking eight bytes,
+   - the moves of every game, one after another, one byte per ply. Each
+     move is stored as its index in GameState::getLegalMoves() in the
+     position it is made from, which is never more than 255, so the order
+     of getLegalMoves() is part of the format,
+   - the index, with an entry of GAMEDB_ENTRY_BYTES bytes for each game: the
+     offset of its moves in six bytes, its GameOutcome in one byte, a zero
+     byte, then whiteId and blackId in four bytes each. A game's moves end
+     where the next game's begin, or at the index for the last game.
+   Because the entries are all the same size, game N is found without
+   reading any other game.
+
+   The GameDatabaseWriter class writes a game database file. The moves are
+   written as the games are added, and the index, which is kept in memory
+   until then, is written by close(). */
+
+class GameDatabaseWriter {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a GameDatabaseWriter object which writes to the file with
+     the input name, replacing any file already there. Throws the
+     GameDatabaseError exception defined in "errors.h" if the file cannot
+     be opened. */
+  GameDatabaseWriter(std::string const& fileName);
+
+  /* Destructor. Calls close() if it has not been called, and ignores any
+     error, so close() should be called to find out if the file is
+     complete. */
+  ~GameDatabaseWriter();
+
+  GameDatabaseWriter(GameDatabaseWriter const&) = delete;
+  GameDatabaseWriter& operator=(GameDatabaseWriter const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of games added so far. */
+  std::size_t getGameCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Adds a game with the input header, whose plyCount is not used, and
+     moves, played from the starting position, and returns its number.
+     Throws GameDatabaseError, and adds nothing, if one of the moves is not
+     legal or if the file cannot be written. */
+  std::size_t addGame(GameHeader const& header,
+		      std::vector<Move> const& moves);
+
+  /* Writes the index and the header and closes the file. Throws
+     GameDatabaseError if they cannot be written. No games can be added
+     afterwards. */
+  void close();
+
+private:
+  std::string fileName;
+  std::ofstream file;
+  std::vector<uint8_t> index;
+  uint64_t offset = GAMEDB_HEADER_BYTES;
+  bool isClosed = false;
+};
+
+/* The GameDatabase class reads a game database file, which is mapped into
+   memory rather than read, so that opening it costs the same however many
+   games it holds, and only the pages of the games looked at are read from
+   disk. Nothing in it is changed after it is opened, so any number of
+   threads can read it at once. */
+
+class GameDatabase {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a GameDatabase object and maps the file with the input name
+     into memory. Throws the GameDatabaseError exception defined in
+     "errors.h" if the file cannot be opened or mapped, or does not hold a
+     game database. */
+  GameDatabase(std::string const& fileName);
+
+  /* Destructor. Unmaps the file. */
+  ~GameDatabase();
+
+  GameDatabase(GameDatabase const&) = delete;
+  GameDatabase& operator=(GameDatabase const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the name of the file. */
+  std::string const& getFileName() const;
+
+  /* Returns the number of games in the file. */
+  std::size_t getGameCount() const;
+
+  /* Returns the size of the file in bytes. */
+  std::size_t getFileSize() const;
+
+  /* Returns the header of game number game, which must be less than
+     getGameCount(). Throws GameDatabaseError if its index entry is not
+     valid. */
+  GameHeader getHeader(std::size_t game) const;
+
+  /* Returns the stored moves of game number game, one byte per ply, with
+     the number of plies in plyCount. Throws GameDatabaseError if its index
+     entry is not valid. */
+  uint8_t const* getMoveIndices(std::size_t game, int& plyCount) const;
+
+  /* Returns every move of game number game. */
+  std::vector<Move> readGame(std::size_t game) const;
+
+private:
+  std::string fileName;
+  uint8_t const* bytes = nullptr;
+  std::size_t fileSize = 0;
+  std::size_t gameCount = 0;
+  uint64_t indexOffset = 0;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Returns the offset of the moves of game number game, or indexOffset
+     if game is getGameCount(). */
+  uint64_t getMoveOffset(std::size_t game) const;
+};
+
+/* The GameReplay class decodes the moves of one game of a GameDatabase one
+   at a time, by playing them on a GameState, so a game can be followed
+   move by move without decoding the whole of it first. The GameDatabase
+   must outlive it. */
+
+class GameReplay {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a GameReplay object at the start of game number game of
+     database. */
+  GameReplay(GameDatabase const& database, std::size_t game);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the position reached so far. */
+  GameState const& getState() const;
+
+  /* Returns the number of moves decoded so far. */
+  int getPly() const;
+
+  /* Returns the number of moves in the game. */
+  int getPlyCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Decodes the next move into move, plays it and returns true. Returns
+     false if every move has been decoded. Throws GameDatabaseError if the
+     stored index is not one of the legal moves. */
+  bool next(Move& move);
+
+private:
+  // plyCount comes before indices because it is set while indices is
+  GameDatabase const& database;
+  std::size_t game;
+  int plyCount = 0;
+  uint8_t const* indices;
+  int ply = 0;
+  GameState state;
+};
+
+#endif
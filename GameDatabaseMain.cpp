@@ -0,0 +1,250 @@
+/* This file contains the main function of the gamedb tool, which packs
+   games into a game database file, shows one game of it, decodes every
+   game of it to time how fast it can be scanned, builds a position index
+   of it, or finds the games which reach a position in a position index.
+   Usage:
+   >> gamedb pack games.txt games.gdb
+   >> gamedb show games.gdb 42
+   >> gamedb scan games.gdb
+   >> gamedb index games.gdb games.gdx 8
+   >> gamedb find games.gdx "<position in Forsyth-Edwards Notation>"
+   Each line of the file packed is one game from the starting position: the
+   number of the White player, the number of the Black player, the result
+   ("1-0", "0-1", "1/2-1/2" or "*") and then the moves in Standard
+   Algebraic Notation. Move numbers such as "1." are skipped, as are empty
+   lines and lines starting with '#'. The last input of index is the number
+   of threads. If it is left out, one thread is used for every core. */
+
+#include "GameDatabase.h"
+#include "PositionIndex.h"
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "San.h"
+#include "Move.h"
+#include "constants.h"
+#include "errors.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Most occurrences of a position that find outputs
+const size_t FIND_SHOWN_COUNT = 20;
+
+/* Reads the result of a game from input into outcome. Returns false if
+   input is not a result. */
+static bool readOutcome(string const& input, GameOutcome& outcome) {
+  if (input == "1-0") {
+    outcome = WhiteWins;
+  } else if (input == "0-1") {
+    outcome = BlackWins;
+  } else if (input == "1/2-1/2") {
+    outcome = Drawn;
+  } else if (input == "*") {
+    outcome = Unfinished;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/* Packs the games in the text file inputName into the game database file
+   outputName. Returns the exit code of the program. */
+static int pack(string const& inputName, string const& outputName) {
+  ifstream input{inputName};
+  if (!input) {
+    cerr << inputName << " could not be opened!" << endl;
+    return 1;
+  }
+
+  GameDatabaseWriter writer{outputName};
+  string line;
+  int lineNumber = 0;
+  while (getline(input, line)) {
+    lineNumber++;
+    istringstream fields{line};
+    string white, black, result;
+    if (!(fields >> white) || white[0] == '#') {
+      continue;
+    }
+    GameHeader header;
+    try {
+      fields >> black >> result;
+      header.whiteId = static_cast<uint32_t>(stoul(white));
+      header.blackId = static_cast<uint32_t>(stoul(black));
+    } catch (exception const& e) {
+      cerr << "Line " << lineNumber << " does not start with two player ";
+      cerr << "numbers!" << endl;
+      return 1;
+    }
+    if (!readOutcome(result, header.outcome)) {
+      cerr << "Line " << lineNumber << " has no result!" << endl;
+      return 1;
+    }
+
+    vector<string> sanMoves;
+    string san;
+    while (fields >> san) {
+      if (san.back() != '.') {
+	sanMoves.push_back(san);
+      }
+    }
+    try {
+      writer.addGame(header, parseSanLine(GameState{}, sanMoves));
+    } catch (SanError const& e) {
+      cerr << "Line " << lineNumber << ": " << e.what() << endl;
+      return 1;
+    }
+  }
+  writer.close();
+  cout << "Packed " << writer.getGameCount() << " games into " << outputName;
+  cout << endl;
+  return 0;
+}
+
+/* Outputs game number game of the database with its header. Returns the exit
+   code of the program. */
+static int show(GameDatabase const& database, size_t game) {
+  if (game >= database.getGameCount()) {
+    cerr << "There are only " << database.getGameCount() << " games!" << endl;
+    return 1;
+  }
+  GameHeader header = database.getHeader(game);
+  cout << "Game " << game << ": White " << header.whiteId << ", Black ";
+  cout << header.blackId << ", " << header.outcome << ", " << header.plyCount;
+  cout << " plies" << endl;
+
+  vector<string> sanMoves = toSanLine(GameState{}, database.readGame(game));
+  for (size_t ply = 0; ply < sanMoves.size(); ply++) {
+    if (ply % 2 == 0) {
+      cout << ply / 2 + 1 << ". ";
+    }
+    cout << sanMoves[ply] << " ";
+  }
+  cout << header.outcome << endl;
+  return 0;
+}
+
+/* Decodes every game of the database and outputs how long it took. Returns
+   the exit code of the program. */
+static int scan(GameDatabase const& database) {
+  auto start = chrono::steady_clock::now();
+  long long plies = 0;
+  for (size_t game = 0; game < database.getGameCount(); game++) {
+    GameReplay replay{database, game};
+    Move move;
+    while (replay.next(move)) {
+      plies++;
+    }
+  }
+  long long microseconds = chrono::duration_cast<chrono::microseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  cout << database.getGameCount() << " games, " << plies << " plies, ";
+  cout << database.getFileSize() << " bytes" << endl;
+  cout << "Decoded in " << microseconds / 1000 << " ms, ";
+  cout << plies * 1000000 / max(microseconds, 1LL) << " plies per second";
+  cout << endl;
+  return 0;
+}
+
+/* Builds a position index of the database in the file indexName with
+   threadCount threads. Returns the exit code of the program. */
+static int buildIndex(GameDatabase const& database, string const& indexName,
+		      int threadCount) {
+  auto start = chrono::steady_clock::now();
+  buildPositionIndex(database, indexName, threadCount);
+  long long milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  PositionIndex positionIndex{indexName};
+  cout << "Indexed " << positionIndex.getPositionCount() << " positions of ";
+  cout << database.getGameCount() << " games in " << milliseconds << " ms, ";
+  cout << positionIndex.getFileSize() << " bytes" << endl;
+  return 0;
+}
+
+/* Outputs the games in the position index file indexName which reach the
+   position fen, in Forsyth-Edwards Notation. Returns the exit code of the
+   program. */
+static int findPosition(string const& indexName, string const& fen) {
+  ChessBoard board{START_FEN};
+  try {
+    board.setPosition(fen);
+  } catch (FenError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  PositionIndex positionIndex{indexName};
+  auto start = chrono::steady_clock::now();
+  vector<PositionOccurrence> occurrences = positionIndex.find(board);
+  long long microseconds = chrono::duration_cast<chrono::microseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  cout << occurrences.size() << " occurrences, found in " << microseconds;
+  cout << " us" << endl;
+  for (size_t i = 0; i < occurrences.size() && i < FIND_SHOWN_COUNT; i++) {
+    cout << "Game " << occurrences[i].game << " at ply " << occurrences[i].ply;
+    cout << endl;
+  }
+  if (occurrences.size() > FIND_SHOWN_COUNT) {
+    cout << "..." << endl;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  string command = (argc > 1) ? argv[1] : "";
+  if (!((command == "pack" && argc == 4) || (command == "show" && argc == 4) ||
+	(command == "scan" && argc == 3) || (command == "find" && argc == 4) ||
+	(command == "index" && (argc == 4 || argc == 5)))) {
+    cerr << "Usage: gamedb pack <games file> <database file>" << endl;
+    cerr << "       gamedb show <database file> <game number>" << endl;
+    cerr << "       gamedb scan <database file>" << endl;
+    cerr << "       gamedb index <database file> <index file> [threads]";
+    cerr << endl;
+    cerr << "       gamedb find <index file> <position>" << endl;
+    return 1;
+  }
+
+  size_t game = 0;
+  if (command == "show") {
+    try {
+      game = stoul(argv[3]);
+    } catch (exception const& e) {
+      cerr << "The game number must be a number!" << endl;
+      return 1;
+    }
+  }
+  int threadCount = (command == "index" && argc == 5) ? stoi(argv[4]) : 0;
+
+  try {
+    if (command == "pack") {
+      return pack(argv[2], argv[3]);
+    }
+    if (command == "find") {
+      return findPosition(argv[2], argv[3]);
+    }
+    GameDatabase database{argv[2]};
+    if (command == "show") {
+      return show(database, game);
+    }
+    if (command == "index") {
+      return buildIndex(database, argv[3], threadCount);
+    }
+    return scan(database);
+  } catch (GameDatabaseError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  } catch (PositionIndexError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
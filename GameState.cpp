@@ -0,0 +1,639 @@
+/* This file contains the member functions of the GameState class and the
+   operator overloads for the MoveResult enumeration. */
+
+#include "GameState.h"
+#include "Bitboard.h"
+#include "PieceType.h"
+#include "Player.h"
+#include "Square.h"
+#include "Move.h"
+#include "GameStatus.h"
+#include "Zobrist.h"
+#include "constants.h"
+#include "errors.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+static_assert(is_trivially_copyable<GameState>::value,
+	      "GameState must be trivially copyable");
+static_assert(sizeof(GameState) <= 72, "GameState must stay compact");
+
+// Bits of GameState::unmoved. The Black bits are the White bits shifted up
+// by BLACK_UNMOVED_SHIFT.
+const uint8_t KING_UNMOVED = 1;
+const uint8_t KINGSIDE_ROOK_UNMOVED = 2;
+const uint8_t QUEENSIDE_ROOK_UNMOVED = 4;
+const int BLACK_UNMOVED_SHIFT = 3;
+const uint8_t ALL_UNMOVED = 63;
+
+// Starting squares of the Kings and Rooks, and the files they are on
+const int KING_FILE = 4;
+const int WHITE_KING_SQUARE = 4;
+const int BLACK_KING_SQUARE = 60;
+
+// Letters of the PieceTypes in Forsyth-Edwards Notation
+const char FEN_LETTERS[] = "pnbrqk";
+
+/* Returns the unmoved bit for a King or Rook of the input colour. */
+static uint8_t unmovedBit(Player colour, uint8_t whiteBit) {
+  return static_cast<uint8_t>(whiteBit << ((colour == White) ? 0 :
+					   BLACK_UNMOVED_SHIFT));
+}
+
+/* Returns the unmoved bit belonging to the square with the input index, or
+   0 if no King or Rook starts there. */
+static uint8_t unmovedBitOfSquare(int squareIndex) {
+  switch (squareIndex) {
+  case 4: return unmovedBit(White, KING_UNMOVED);
+  case 7: return unmovedBit(White, KINGSIDE_ROOK_UNMOVED);
+  case 0: return unmovedBit(White, QUEENSIDE_ROOK_UNMOVED);
+  case 60: return unmovedBit(Black, KING_UNMOVED);
+  case 63: return unmovedBit(Black, KINGSIDE_ROOK_UNMOVED);
+  case 56: return unmovedBit(Black, QUEENSIDE_ROOK_UNMOVED);
+  }
+  return 0;
+}
+
+// ---------- MoveResult operator overload -------------------------------------
+
+ostream& operator<<(ostream& os, const MoveResult& result) {
+  switch (result) {
+  case MoveAccepted: os << "the move was made"; break;
+  case InvalidInput: os << "the input is not a square or a castle"; break;
+  case SameSquare: os << "a piece cannot move to the square it's already on";
+    break;
+  case NoPieceThere: os << "there is no piece on the source square"; break;
+  case WrongPlayer: os << "it is not that player's turn to move"; break;
+  case MoveNotAllowed: os << "the piece cannot move there"; break;
+  case KingHasMoved: os << "the King has moved previously"; break;
+  case RookHasMoved: os << "the Rook has moved previously"; break;
+  case CastlePathBlocked:
+    os << "the squares between the King and the Rook are not clear"; break;
+  case CastleInCheck: os << "the King is in check"; break;
+  case CastleThroughCheck: os << "the King would pass through check"; break;
+  case CastleIntoCheck: os << "the King would move into check"; break;
+  case GameOver: os << "the game is over"; break;
+  }
+  return os;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+GameState::GameState() {
+  pieces[PawnType] = 0x00FF00000000FF00ULL;
+  pieces[KnightType] = 0x4200000000000042ULL;
+  pieces[BishopType] = 0x2400000000000024ULL;
+  pieces[RookType] = 0x8100000000000081ULL;
+  pieces[QueenType] = 0x0800000000000008ULL;
+  pieces[KingType] = 0x1000000000000010ULL;
+  colours[White] = 0x000000000000FFFFULL;
+  colours[Black] = 0xFFFF000000000000ULL;
+  player = White;
+  unmoved = ALL_UNMOVED;
+  status = InProgress;
+  halfmoveClock = 0;
+}
+
+GameState::GameState(string const& fen) {
+  istringstream fields{fen};
+  string placement, side, castling, enPassant, halfmove;
+  fields >> placement >> side >> castling >> enPassant >> halfmove;
+  if (castling.empty()) {
+    castling = "-";
+  }
+  halfmoveClock = 0;
+  if (!halfmove.empty()) {
+    if (halfmove.size() > 4 ||
+	halfmove.find_first_not_of("0123456789") != string::npos) {
+      throw FenError{fen, "the halfmove clock must be a number"};
+    }
+    halfmoveClock = static_cast<uint8_t>(min(stoi(halfmove), UINT8_MAX));
+  }
+
+  for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+    pieces[t] = EMPTY_BITBOARD;
+  }
+  colours[White] = EMPTY_BITBOARD;
+  colours[Black] = EMPTY_BITBOARD;
+
+  int rank = MAX_RANK;
+  int file = MIN_FILE;
+  for (char c : placement) {
+    if (c == '/') {
+      if (file != BOARD_WIDTH || rank == MIN_RANK) {
+	throw FenError{fen, "there must be 8 ranks of 8 squares"};
+      }
+      rank--;
+      file = MIN_FILE;
+    } else if (c >= '1' && c <= '8') {
+      file += c - '0';
+    } else if (string{FEN_LETTERS}.find(tolower(c)) != string::npos) {
+      if (file > MAX_FILE) {
+	throw FenError{fen, "there must be 8 ranks of 8 squares"};
+      }
+      PieceType type = static_cast<PieceType>(string{FEN_LETTERS}.find(
+						tolower(c)));
+      putPiece(type, (isupper(c)) ? White : Black, squareAt(rank, file++));
+    } else {
+      throw FenError{fen, string{"'"} + c + "' is not a Piece"};
+    }
+    if (file > BOARD_WIDTH) {
+      throw FenError{fen, "there must be 8 ranks of 8 squares"};
+    }
+  }
+  if (rank != MIN_RANK || file != BOARD_WIDTH) {
+    throw FenError{fen, "there must be 8 ranks of 8 squares"};
+  }
+  if (popCount(getPieces(White, KingType)) != 1 ||
+      popCount(getPieces(Black, KingType)) != 1) {
+    throw FenError{fen, "each player must have exactly one King"};
+  }
+  if (side != "w" && side != "b") {
+    throw FenError{fen, "the player to move must be \"w\" or \"b\""};
+  }
+  player = (side == "w") ? White : Black;
+  if (isInCheck(!getPlayer())) {
+    throw FenError{fen, "the player who is not to move is in check"};
+  }
+
+  // Each castling right needs the King and the Rook on their start squares
+  unmoved = 0;
+  if (castling != "-") {
+    for (char c : castling) {
+      if (string{"KQkq"}.find(c) == string::npos) {
+	throw FenError{fen, "the castling rights do not match the Pieces"};
+      }
+      Player colour = (isupper(c)) ? White : Black;
+      int kingSquare = (colour == White) ? WHITE_KING_SQUARE :
+	BLACK_KING_SQUARE;
+      int rookSquare = kingSquare + ((toupper(c) == 'K') ? 3 : -KING_FILE);
+      if (!(getPieces(colour, KingType) & squareBit(kingSquare)) ||
+	  !(getPieces(colour, RookType) & squareBit(rookSquare))) {
+	throw FenError{fen, "the castling rights do not match the Pieces"};
+      }
+      unmoved |= unmovedBitOfSquare(kingSquare) | unmovedBitOfSquare(rookSquare);
+    }
+  }
+
+  updateStatus(getPlayer());
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+Player GameState::getPlayer() const {
+  return static_cast<Player>(player);
+}
+
+GameStatus GameState::getStatus() const {
+  return static_cast<GameStatus>(status);
+}
+
+Bitboard GameState::getPieces(PieceType type) const {
+  return pieces[type];
+}
+
+Bitboard GameState::getPieces(Player colour, PieceType type) const {
+  return pieces[type] & colours[colour];
+}
+
+Bitboard GameState::getPieces(Player colour) const {
+  return colours[colour];
+}
+
+Bitboard GameState::getOccupied() const {
+  return colours[White] | colours[Black];
+}
+
+PieceType GameState::getPieceType(int squareIndex) const {
+  Bitboard bit = squareBit(squareIndex);
+  for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+    if (pieces[t] & bit) {
+      return static_cast<PieceType>(t);
+    }
+  }
+  return NoPieceType;
+}
+
+Player GameState::getColour(int squareIndex) const {
+  return (colours[White] & squareBit(squareIndex)) ? White : Black;
+}
+
+string GameState::getFen() const {
+  string fen;
+  for (int rank = MAX_RANK; rank >= MIN_RANK; rank--) {
+    int emptySquares = 0;
+    for (int file = MIN_FILE; file <= MAX_FILE; file++) {
+      int square = squareAt(rank, file);
+      PieceType type = getPieceType(square);
+      if (type == NoPieceType) {
+	emptySquares++;
+	continue;
+      }
+      if (emptySquares > 0) {
+	fen += to_string(emptySquares);
+	emptySquares = 0;
+      }
+      char letter = FEN_LETTERS[type];
+      fen += (getColour(square) == White) ?
+	static_cast<char>(toupper(letter)) : letter;
+    }
+    if (emptySquares > 0) {
+      fen += to_string(emptySquares);
+    }
+    if (rank > MIN_RANK) {
+      fen += '/';
+    }
+  }
+
+  fen += (getPlayer() == White) ? " w " : " b ";
+
+  string castling;
+  int castlingRights = getCastlingRights();
+  char letters[4] = {'K', 'Q', 'k', 'q'};
+  for (int i = 0; i < 4; i++) {
+    if (castlingRights & (1 << i)) {
+      castling += letters[i];
+    }
+  }
+  fen += (castling.empty()) ? "-" : castling;
+
+  fen += " - " + to_string(halfmoveClock) + " 1";
+  return fen;
+}
+
+int GameState::getHalfmoveClock() const {
+  return halfmoveClock;
+}
+
+HashKey GameState::getHash() const {
+  HashKey hash = castlingKey(getCastlingRights());
+  for (int c = 0; c < 2; c++) {
+    Player colour = static_cast<Player>(c);
+    for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+      PieceType type = static_cast<PieceType>(t);
+      Bitboard squares = getPieces(colour, type);
+      while (squares) {
+	hash ^= pieceKey(colour, type, popLowestSquare(squares));
+      }
+    }
+  }
+  if (getPlayer() == Black) {
+    hash ^= blackToMoveKey();
+  }
+  return hash;
+}
+
+int GameState::getLegalMoves(Move* moves) const {
+  return (getPlayer() == White) ? getLegalMoves<White>(moves) :
+    getLegalMoves<Black>(moves);
+}
+
+// ---------- Checker functions ------------------------------------------------
+
+bool GameState::isInCheck(Player p) const {
+  return (p == White) ? isInCheck<White>() : isInCheck<Black>();
+}
+
+bool GameState::isSquareAttacked(int squareIndex, Player attacker) const {
+  return (attacker == White) ? isSquareAttacked<White>(squareIndex) :
+    isSquareAttacked<Black>(squareIndex);
+}
+
+bool GameState::canCastle(Player p, bool isKingside) const {
+  return (getCastleResult(p, isKingside) == MoveAccepted);
+}
+
+// ---------- Other functions --------------------------------------------------
+
+MoveResult GameState::submitMove(string sourceSquare,
+				 string destinationSquare) {
+  if (sourceSquare == "W" || sourceSquare == "B") {
+    return submitMove(static_cast<char>(sourceSquare[0]), destinationSquare);
+  }
+
+  Square sourceInput, destinationInput;
+  try {
+    sourceInput = Square{sourceSquare};
+    destinationInput = Square{destinationSquare};
+  } catch (OffBoardError const& e) {
+    return InvalidInput;
+  }
+  return submitMove(Move{sourceInput, destinationInput});
+}
+
+MoveResult GameState::submitMove(char playerColour, string castleCode) {
+  bool validInput = ((playerColour == 'W' || playerColour == 'B') &&
+		     (castleCode == "O-O" || castleCode == "O-O-O"));
+  if (!validInput) {
+    return InvalidInput;
+  }
+  if (isGameOver(getStatus())) {
+    return GameOver;
+  }
+  if ((playerColour == 'W') != (getPlayer() == White)) {
+    return WrongPlayer;
+  }
+
+  // King always moves two towards the Rook
+  int king = (getPlayer() == White) ? WHITE_KING_SQUARE : BLACK_KING_SQUARE;
+  int step = (castleCode == "O-O") ? 1 : -1;
+  return submitMove(Move{king, king + 2 * step, true});
+}
+
+MoveResult GameState::submitMove(Move move) {
+  if (isGameOver(getStatus())) {
+    return GameOver;
+  }
+
+  int source = move.getSourceIndex();
+  int destination = move.getDestinationIndex();
+  if (move.isCastle()) {
+    // The King must move two squares from its starting square
+    int king = (getPlayer() == White) ? WHITE_KING_SQUARE : BLACK_KING_SQUARE;
+    if (source != king ||
+	(destination != king + 2 && destination != king - 2)) {
+      return MoveNotAllowed;
+    }
+    bool isKingside = move.isKingsideCastle();
+    MoveResult result = getCastleResult(getPlayer(), isKingside);
+    if (result != MoveAccepted) {
+      return result;
+    }
+
+    // Rook always ends up on other side of King - one away from where King
+    // was originally
+    int step = (isKingside) ? 1 : -1;
+    movePiece((isKingside) ? king + 3 : king - KING_FILE, king + step);
+  } else {
+    if (source == destination) {
+      return SameSquare;
+    }
+    if (!(getOccupied() & squareBit(source))) {
+      return NoPieceThere;
+    }
+    if (getColour(source) != getPlayer()) {
+      return WrongPlayer;
+    }
+    if (!(getPossibleDestinations(source) & squareBit(destination)) ||
+	!isMoveLegal(source, destination)) {
+      return MoveNotAllowed;
+    }
+  }
+
+  countHalfmove(source, destination);
+  movePiece(source, destination);
+  updateStatus(!getPlayer());
+  finishMove();
+  return MoveAccepted;
+}
+
+void GameState::playMove(Move move) {
+  int source = move.getSourceIndex();
+  int destination = move.getDestinationIndex();
+
+  // The Rook ends up on the other side of the King, one square away from
+  // where the King started
+  if (move.isCastle()) {
+    bool isKingside = move.isKingsideCastle();
+    int rookSource = (isKingside) ? source + 3 : source - KING_FILE;
+    int rookDestination = (isKingside) ? source + 1 : source - 1;
+    movePiece(rookSource, rookDestination);
+  }
+  countHalfmove(source, destination);
+  movePiece(source, destination);
+  player = !getPlayer();
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+void GameState::putPiece(PieceType type, Player colour, int squareIndex) {
+  pieces[type] |= squareBit(squareIndex);
+  colours[colour] |= squareBit(squareIndex);
+}
+
+void GameState::movePiece(int source, int destination) {
+  Bitboard sourceBit = squareBit(source);
+  Bitboard destinationBit = squareBit(destination);
+  Player colour = getColour(source);
+
+  // Take any Piece on the destination
+  for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+    pieces[t] &= ~destinationBit;
+  }
+  colours[!colour] &= ~destinationBit;
+
+  PieceType type = getPieceType(source);
+  pieces[type] ^= sourceBit | destinationBit;
+  colours[colour] ^= sourceBit | destinationBit;
+
+  unmoved &= ~(unmovedBitOfSquare(source) | unmovedBitOfSquare(destination));
+}
+
+Bitboard GameState::getPossibleDestinations(int source) const {
+  return (getColour(source) == White) ?
+    getPossibleDestinations<White>(source) :
+    getPossibleDestinations<Black>(source);
+}
+
+void GameState::countHalfmove(int source, int destination) {
+  // Captures and Pawn moves cannot be undone, so they restart the clock
+  bool isIrreversible = ((getPieces(PawnType) & squareBit(source)) ||
+			 (getOccupied() & squareBit(destination)));
+  if (isIrreversible) {
+    halfmoveClock = 0;
+  } else if (halfmoveClock < UINT8_MAX) {
+    halfmoveClock++;
+  }
+}
+
+bool GameState::isMoveLegal(int source, int destination) const {
+  return (getColour(source) == White) ? isMoveLegal<White>(source, destination)
+    : isMoveLegal<Black>(source, destination);
+}
+
+MoveResult GameState::getCastleResult(Player p, bool isKingside) const {
+  return (p == White) ? getCastleResult<White>(isKingside) :
+    getCastleResult<Black>(isKingside);
+}
+
+bool GameState::hasLegalMove(Player p) const {
+  return (p == White) ? hasLegalMove<White>() : hasLegalMove<Black>();
+}
+
+int GameState::getCastlingRights() const {
+  // The rights are in the order White kingside, White queenside, Black
+  // kingside, Black queenside
+  uint8_t rookBits[2] = {KINGSIDE_ROOK_UNMOVED, QUEENSIDE_ROOK_UNMOVED};
+  int castlingRights = 0;
+  for (int c = 0; c < 2; c++) {
+    for (int side = 0; side < 2; side++) {
+      uint8_t bits = unmovedBit(static_cast<Player>(c),
+				KING_UNMOVED | rookBits[side]);
+      if ((unmoved & bits) == bits) {
+	castlingRights |= 1 << (2 * c + side);
+      }
+    }
+  }
+  return castlingRights;
+}
+
+void GameState::updateStatus(Player p) {
+  bool isAnyMove = hasLegalMove(p);
+  if (isInCheck(p)) {
+    status = (isAnyMove) ? Check : Checkmate;
+  } else {
+    status = (isAnyMove) ? InProgress : Stalemate;
+  }
+  if (isAnyMove && halfmoveClock >= FIFTY_MOVE_HALFMOVES) {
+    status = FiftyMoveRule;
+  }
+}
+
+void GameState::finishMove() {
+  if (!isGameOver(getStatus())) {
+    player = !getPlayer();
+  }
+}
+
+// ---------- Helper functions for one colour ----------------------------------
+
+template <Player Us>
+int GameState::getLegalMoves(Move* moves) const {
+  int count = 0;
+
+  // Go through the Pieces and their destinations in square order, which
+  // gives the same order as ChessBoard::getLegalMoves()
+  Bitboard ownPieces = colours[Us];
+  while (ownPieces) {
+    int source = popLowestSquare(ownPieces);
+    Bitboard destinations = getPossibleDestinations<Us>(source);
+    while (destinations) {
+      int destination = popLowestSquare(destinations);
+      if (isMoveLegal<Us>(source, destination)) {
+	moves[count++] = Move{source, destination};
+      }
+    }
+  }
+
+  constexpr int king = squareAt(relativeRank<Us>(MIN_RANK), KING_FILE);
+  if (getCastleResult<Us>(true) == MoveAccepted) {
+    moves[count++] = Move{king, king + 2, true};
+  }
+  if (getCastleResult<Us>(false) == MoveAccepted) {
+    moves[count++] = Move{king, king - 2, true};
+  }
+  return count;
+}
+
+template <Player Us>
+bool GameState::isInCheck() const {
+  Bitboard king = getPieces(Us, KingType);
+  return (king != EMPTY_BITBOARD &&
+	  isSquareAttacked<!Us>(lowestSquare(king)));
+}
+
+template <Player Them>
+bool GameState::isSquareAttacked(int squareIndex) const {
+  Bitboard occupied = getOccupied();
+  Bitboard attackers = colours[Them];
+  Bitboard straight = (pieces[RookType] | pieces[QueenType]) & attackers;
+  Bitboard diagonal = (pieces[BishopType] | pieces[QueenType]) & attackers;
+
+  return ((pawnAttacks<Them>(pieces[PawnType] & attackers) &
+	   squareBit(squareIndex)) ||
+	  (knightAttacks(squareIndex) & pieces[KnightType] & attackers) ||
+	  (kingAttacks(squareIndex) & pieces[KingType] & attackers) ||
+	  (rookAttacks(squareIndex, occupied) & straight) ||
+	  (bishopAttacks(squareIndex, occupied) & diagonal));
+}
+
+template <Player Us>
+Bitboard GameState::getPossibleDestinations(int source) const {
+  Bitboard occupied = getOccupied();
+  Bitboard notOwn = ~colours[Us];
+
+  switch (getPieceType(source)) {
+  case PawnType: {
+    // A Pawn moves forward onto empty squares, two at a time from its
+    // starting rank, and takes diagonally. A push off the end of the board
+    // is shifted out of the Bitboard.
+    Bitboard pawn = squareBit(source);
+    Bitboard empty = ~occupied;
+    Bitboard oneStep = pawnPushes<Us>(pawn) & empty;
+    Bitboard twoSteps = pawnPushes<Us>(
+      oneStep & pawnPushes<Us>(relativeRankBitboard<Us>(RANK_TWO))) & empty;
+    return oneStep | twoSteps | (pawnAttacks<Us>(pawn) & colours[!Us]);
+  }
+  case KnightType: return knightAttacks(source) & notOwn;
+  case BishopType: return bishopAttacks(source, occupied) & notOwn;
+  case RookType: return rookAttacks(source, occupied) & notOwn;
+  case QueenType: return queenAttacks(source, occupied) & notOwn;
+  case KingType: return kingAttacks(source) & notOwn;
+  case NoPieceType: break;
+  }
+  return EMPTY_BITBOARD;
+}
+
+template <Player Us>
+bool GameState::isMoveLegal(int source, int destination) const {
+  // Make the move on a copy, which is only 72 bytes, and see whether the
+  // player is in check as a result
+  GameState copyState = *this;
+  copyState.movePiece(source, destination);
+  return !copyState.isInCheck<Us>();
+}
+
+template <Player Us>
+MoveResult GameState::getCastleResult(bool isKingside) const {
+  constexpr int king = squareAt(relativeRank<Us>(MIN_RANK), KING_FILE);
+  int rook = (isKingside) ? king + 3 : king - KING_FILE;
+  uint8_t rookBit = (isKingside) ? KINGSIDE_ROOK_UNMOVED :
+    QUEENSIDE_ROOK_UNMOVED;
+
+  if (!(unmoved & unmovedBit(Us, KING_UNMOVED))) {
+    return KingHasMoved;
+  }
+  if (!(unmoved & unmovedBit(Us, rookBit))) {
+    return RookHasMoved;
+  }
+
+  int step = (isKingside) ? 1 : -1;
+  for (int square = king + step; square != rook; square += step) {
+    if (getOccupied() & squareBit(square)) {
+      return CastlePathBlocked;
+    }
+  }
+
+  if (isInCheck<Us>()) {
+    return CastleInCheck;
+  }
+  if (!isMoveLegal<Us>(king, king + step)) {
+    return CastleThroughCheck;
+  }
+  if (!isMoveLegal<Us>(king, king + 2 * step)) {
+    return CastleIntoCheck;
+  }
+  return MoveAccepted;
+}
+
+template <Player Us>
+bool GameState::hasLegalMove() const {
+  Bitboard ownPieces = colours[Us];
+  while (ownPieces) {
+    int source = popLowestSquare(ownPieces);
+    Bitboard destinations = getPossibleDestinations<Us>(source);
+    while (destinations) {
+      if (isMoveLegal<Us>(source, popLowestSquare(destinations))) {
+	return true;
+      }
+    }
+  }
+  return false;
+}
@@ -0,0 +1,210 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include "Bitboard.h"
+#include "PieceType.h"
+#include "Player.h"
+#include "Square.h"
+#include "Move.h"
+#include "GameStatus.h"
+#include "Zobrist.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// Most legal moves there can be in any position
+const int MAX_MOVES = 256;
+
+/* The MoveResult enumeration is the outcome of submitting a move to a
+   GameState. MoveAccepted means the move was made. Every other enumerator
+   is a reason for the move being refused, matching the messages output by
+   ChessBoard::submitMove(). */
+
+enum MoveResult { MoveAccepted, InvalidInput, SameSquare, NoPieceThere,
+		  WrongPlayer, MoveNotAllowed, KingHasMoved, RookHasMoved,
+		  CastlePathBlocked, CastleInCheck, CastleThroughCheck,
+		  CastleIntoCheck, GameOver };
+
+/* This function allows a MoveResult enumerator to be output to the output
+   stream specified, as a short explanation, e.g. "the King has moved". */
+std::ostream& operator<<(std::ostream& os, const MoveResult& result);
+
+/* The GameState class holds a whole game in 72 bytes, so that very many
+   games can be kept in memory at once. It contains eight Bitboards, a
+   Player enumerator and two small sets of flags.
+   pieces holds one Bitboard for each PieceType, and colours one Bitboard
+   for each Player. A Piece of type t and colour c is on square s if bit s
+   is set in both pieces[t] and colours[c]. Together they take 64 bytes.
+   unmoved has a bit for each King and Rook which is still on its starting
+   square and has never moved, so that the castling rules can be followed.
+   status is the GameStatus the last move left the game in.
+   halfmoveClock counts the halfmoves since the last capture or Pawn move,
+   up to 255, for the fifty-move rule.
+   The class has no pointers and no virtual functions, so it is trivially
+   copyable, and copying a GameState copies the game. The rules are the
+   same as ChessBoard's, except that no moves are accepted once the game is
+   over, and that repetitions are not detected because a GameState does not
+   keep the earlier positions of the game. */
+
+class GameState {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs GameState object with all the Pieces in the correct starting
+     positions and the player set to White. */
+  GameState();
+
+  /* Constructs GameState object with the position given by fen, in Forsyth-
+     Edwards Notation. If fen is not a valid position then the constructor
+     throws the FenError exception defined in the "errors.h" file. */
+  GameState(std::string const& fen);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the player to move. */
+  Player getPlayer() const;
+
+  /* Returns the GameStatus of the game. For a new game this is the status of
+     the player to move; after a move it is the status of the opponent of the
+     player who moved. */
+  GameStatus getStatus() const;
+
+  /* Returns the squares with a Piece of the input type, of either colour. */
+  Bitboard getPieces(PieceType type) const;
+
+  /* Returns the squares with a Piece of the input type and colour. */
+  Bitboard getPieces(Player colour, PieceType type) const;
+
+  /* Returns the squares with a Piece of the input colour. */
+  Bitboard getPieces(Player colour) const;
+
+  /* Returns the squares with any Piece on them. */
+  Bitboard getOccupied() const;
+
+  /* Returns the type of the Piece on the square with the input index, or
+     NoPieceType if the square is empty. */
+  PieceType getPieceType(int squareIndex) const;
+
+  /* Returns the colour of the Piece on the square with the input index. The
+     square must not be empty. */
+  Player getColour(int squareIndex) const;
+
+  /* Returns the position in Forsyth-Edwards Notation. As for ChessBoard,
+     the en passant square is always "-" and the fullmove number is always
+     1. */
+  std::string getFen() const;
+
+  /* Returns the number of halfmoves since the last capture or Pawn move. */
+  int getHalfmoveClock() const;
+
+  /* Returns the Zobrist hash of the position, worked out from scratch. It is
+     the same as ChessBoard::getHash() for the same position. */
+  HashKey getHash() const;
+
+  /* Puts every legal move of the player to move, including castles, into
+     moves, which must have room for MAX_MOVES moves, and returns how many
+     there are. */
+  int getLegalMoves(Move* moves) const;
+
+  // ---------- Checker functions ----------------------------------------------
+
+  /* Checks if the King of player p is attacked by one of the opponent's
+     Pieces. */
+  bool isInCheck(Player p) const;
+
+  /* Checks if any Piece of player attacker could take on the square with
+     the input index. */
+  bool isSquareAttacked(int squareIndex, Player attacker) const;
+
+  /* Checks if p can castle on the input side. */
+  bool canCastle(Player p, bool isKingside) const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Makes a move from sourceSquare to destinationSquare if it follows the
+     rules of chess, and returns MoveAccepted. Otherwise the GameState is not
+     changed and the reason is returned. The inputs are the same as for
+     ChessBoard::submitMove(), including "W" or "B" as the sourceSquare for a
+     castle. After the move the status is updated, and the player is swapped
+     over unless the game is over. */
+  MoveResult submitMove(std::string sourceSquare,
+			std::string destinationSquare);
+
+  /* Castles for playerColour ('W' or 'B') on the side given by castleCode
+     ("O-O" or "O-O-O"), following the same rules as the castle version of
+     ChessBoard::submitMove(). */
+  MoveResult submitMove(char playerColour, std::string castleCode);
+
+  /* Makes move if it follows the rules of chess, in the same way as the
+     versions above, which read their inputs into a Move and call this.
+     Nothing is parsed. A castle must be flagged as one, with the King's
+     starting square as the source, as in getLegalMoves(). */
+  MoveResult submitMove(Move move);
+
+  /* Makes a move taken from getLegalMoves() and swaps the player over. The
+     move is not checked and the status is not updated. */
+  void playMove(Move move);
+
+private:
+  Bitboard pieces[PIECE_TYPE_COUNT];
+  Bitboard colours[2];
+  uint8_t player;
+  uint8_t unmoved;
+  uint8_t status;
+  uint8_t halfmoveClock;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Puts the Piece of the input type and colour on the empty square with the
+     input index. */
+  void putPiece(PieceType type, Player colour, int squareIndex);
+
+  /* Moves the Piece on source to destination, taking any Piece there, and
+     clears the unmoved bits of both squares. */
+  void movePiece(int source, int destination);
+
+  /* Returns the squares the Piece on source could move to by the rules of
+     how it moves, without checking whether the move is legal. */
+  Bitboard getPossibleDestinations(int source) const;
+
+  /* Updates the halfmove clock for the move of the Piece on source to
+     destination, which is about to be made. */
+  void countHalfmove(int source, int destination);
+
+  /* Checks that moving the Piece on source to destination does not leave
+     its own King in check. */
+  bool isMoveLegal(int source, int destination) const;
+
+  /* Works out the reason p cannot castle on the input side, or returns
+     MoveAccepted if p can castle. */
+  MoveResult getCastleResult(Player p, bool isKingside) const;
+
+  /* Checks if p has any legal move. */
+  bool hasLegalMove(Player p) const;
+
+  /* Returns the castling rights as bits of the kind defined in "Zobrist.h",
+     i.e. which Kings and Rooks are both unmoved. */
+  int getCastlingRights() const;
+
+  /* The versions of getLegalMoves(), isInCheck(), isSquareAttacked(),
+     getPossibleDestinations(), isMoveLegal(), getCastleResult() and
+     hasLegalMove() for the Pieces of player Us, or for attacks by player
+     Them. The functions above find the colour and call one of these, so
+     the colour is a constant in all the work they do, and the directions,
+     ranks and starting squares that depend on it cost nothing. */
+  template <Player Us> int getLegalMoves(Move* moves) const;
+  template <Player Us> bool isInCheck() const;
+  template <Player Them> bool isSquareAttacked(int squareIndex) const;
+  template <Player Us> Bitboard getPossibleDestinations(int source) const;
+  template <Player Us> bool isMoveLegal(int source, int destination) const;
+  template <Player Us> MoveResult getCastleResult(bool isKingside) const;
+  template <Player Us> bool hasLegalMove() const;
+
+  /* Sets the status to the GameStatus of p. */
+  void updateStatus(Player p);
+
+  /* Swaps the player over, unless the last move ended the game. */
+  void finishMove();
+};
+
+#endif
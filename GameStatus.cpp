@@ -0,0 +1,22 @@
+/* This file contains the functions for the GameStatus enumeration. */
+
+#include "GameStatus.h"
+#include <iostream>
+
+using namespace std;
+
+ostream& operator<<(ostream& os, const GameStatus& status) {
+  switch (status) {
+  case InProgress: os << "In progress"; break;
+  case Check: os << "Check"; break;
+  case Checkmate: os << "Checkmate"; break;
+  case Stalemate: os << "Stalemate"; break;
+  case ThreefoldRepetition: os << "Threefold repetition"; break;
+  case FiftyMoveRule: os << "Fifty-move rule"; break;
+  }
+  return os;
+}
+
+bool isGameOver(GameStatus status) {
+  return (status != InProgress && status != Check);
+}
@@ -0,0 +1,22 @@
+#ifndef GAMESTATUS_H
+#define GAMESTATUS_H
+
+#include <iostream>
+
+/* The GameStatus enumeration describes the state of a game for the player
+   who is to move: the game is either still going (InProgress or Check), or
+   it is over (Checkmate, Stalemate, or a draw by ThreefoldRepetition or by
+   the FiftyMoveRule). */
+
+enum GameStatus { InProgress, Check, Checkmate, Stalemate, ThreefoldRepetition,
+		  FiftyMoveRule };
+
+/* This function allows a GameStatus enumerator to be output to the output
+   stream specified, e.g. "Checkmate". */
+std::ostream& operator<<(std::ostream& os, const GameStatus& status);
+
+/* Returns true if the game is over, i.e. for every status except InProgress
+   and Check. */
+bool isGameOver(GameStatus status);
+
+#endif
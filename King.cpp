@@ -4,10 +4,12 @@
 #include "Piece.h"
 #include "Player.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
@@ -15,16 +17,18 @@ using namespace std;
 // ---------- Contructors, destructors and operator overloads ------------------
 
 King::King(Player colour, ChessBoard& board) :
-  Piece(colour, board, "King") {}
+  Piece(colour, board, KingType) {}
 
 King::King(King const& otherKing, ChessBoard& board) :
-  Piece(otherKing.colour, board, otherKing.name) {}
+  Piece(otherKing, board) {}
 
 King::~King() {}
 
 // ---------- Checker functions ------------------------------------------------
 
 bool King::isMovePossible(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(KingMovePossibleCount);
+
   int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
   int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
 
@@ -73,6 +77,6 @@ bool King::isAnyLegalMovePossible(Square square) {
 
 // ---------- Other functions --------------------------------------------------
 
-Piece* King::copyPiece(ChessBoard& board) {
-  return (new King{*this, board});
+Piece* King::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) King{*this, board});
 }
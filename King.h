@@ -14,7 +14,7 @@
    variables: 
    Player colour - contains the colour of the King
    ChessBoard& board - reference to the ChessBoard object which owns the King
-   std::string name - the name of the Piece, in this case "King"
+   PieceType type - the kind of Piece, in this case KingType
    bool hasMoved - false if the King has not moved yet */
 
 class King : public Piece {
@@ -22,7 +22,7 @@ public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
   /* Constructs a King object with colour and board set to the input variables,
-     name set to "King" and hasMoved set to false.*/
+     type set to KingType and hasMoved set to false.*/
   King(Player colour, ChessBoard& board);
 
   /* Constructs a King object which is a copy of the input King object, except
@@ -47,10 +47,11 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a Piece pointer to a copy of the King object on which this function
-     is called, but with the ChessBoard reference of the new object set to the 
+  /* Constructs a copy of the King object on which this function is called in
+     storage, a PieceArena slot of the board input, and returns a Piece
+     pointer to it. The ChessBoard reference of the new object is set to the
      board input. */
-  Piece* copyPiece(ChessBoard& board) override;
+  Piece* copyPiece(ChessBoard& board, void* storage) override;
 };
 
 #endif
@@ -4,10 +4,12 @@
 #include "Piece.h"
 #include "Player.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
@@ -15,16 +17,18 @@ using namespace std;
 // ---------- Contructors, destructors and operator overloads ------------------
 
 Knight::Knight(Player colour, ChessBoard& board) :
-  Piece(colour, board, "Knight") {}
+  Piece(colour, board, KnightType) {}
 
 Knight::Knight(Knight const& otherKnight, ChessBoard& board) :
-  Piece(otherKnight.colour, board, otherKnight.name) {}
+  Piece(otherKnight, board) {}
 
 Knight::~Knight() {}
 
 // ---------- Checker functions ------------------------------------------------
 
 bool Knight::isMovePossible(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(KnightMovePossibleCount);
+
   int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
   int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
 
@@ -69,6 +73,6 @@ bool Knight::isAnyLegalMovePossible(Square square) {
 
 // ---------- Other functions --------------------------------------------------
 
-Piece* Knight::copyPiece(ChessBoard& board) {
-  return (new Knight{*this, board});
+Piece* Knight::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) Knight{*this, board});
 }
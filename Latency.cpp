@@ -0,0 +1,251 @@
+/* This file contains the functions which read, reset and output the latency
+   histograms kept about the rules engine, and the member functions of the
+   LatencyHistogram and ThreadLatencies classes. */
+
+#include "Latency.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+ostream& operator<<(ostream& os, const LatencyOperation& operation) {
+  switch (operation) {
+  case SubmitSquaresLatency:
+    return os << "submitMove(squares)";
+  case SubmitCastleLatency:
+    return os << "submitMove(castle)";
+  case SubmitMoveLatency:
+    return os << "submitMove(Move)";
+  case CheckLatency:
+    return os << "isPlayerInCheck";
+  case CheckmateLatency:
+    return os << "isPlayerInCheckmate";
+  case StalemateLatency:
+    return os << "isPlayerInStalemate";
+  }
+  return os;
+}
+
+long long getLatencyBucketLowest(int bucket) {
+  if (bucket < 2 * LATENCY_SUB_BUCKET_COUNT) {
+    return bucket;
+  }
+  if (bucket == LATENCY_BUCKET_COUNT - 1) {
+    return 1LL << LATENCY_MAX_EXPONENT;
+  }
+  int shift = bucket / LATENCY_SUB_BUCKET_COUNT - 1;
+  return static_cast<long long>(LATENCY_SUB_BUCKET_COUNT +
+				bucket % LATENCY_SUB_BUCKET_COUNT) << shift;
+}
+
+long long getLatencyBucketHighest(int bucket) {
+  if (bucket < 2 * LATENCY_SUB_BUCKET_COUNT) {
+    return bucket;
+  }
+  if (bucket == LATENCY_BUCKET_COUNT - 1) {
+    return -1;
+  }
+  int shift = bucket / LATENCY_SUB_BUCKET_COUNT - 1;
+  return getLatencyBucketLowest(bucket) + (1LL << shift) - 1;
+}
+
+ostream& operator<<(ostream& os, const EngineLatencies& latencies) {
+  os << "Latencies in nanoseconds:" << endl;
+  os << left << setw(22) << "operation" << right << setw(12) << "count";
+  os << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p90";
+  os << setw(10) << "p99" << setw(10) << "p99.9" << setw(12) << "max" << endl;
+  for (int i = 0; i < LATENCY_OPERATION_COUNT; i++) {
+    LatencyHistogram const& histogram = latencies.operations[i];
+    if (histogram.getCount() == 0) {
+      continue;
+    }
+    ostringstream name;
+    name << static_cast<LatencyOperation>(i);
+    os << left << setw(22) << name.str() << right << setw(12);
+    os << histogram.getCount() << setw(10) << llround(histogram.getMean());
+    os << setw(10) << histogram.getPercentile(50);
+    os << setw(10) << histogram.getPercentile(90);
+    os << setw(10) << histogram.getPercentile(99);
+    os << setw(10) << histogram.getPercentile(99.9);
+    os << setw(12) << histogram.getMax() << endl;
+  }
+  return os;
+}
+
+void printLatencyCsv(ostream& os, EngineLatencies const& latencies) {
+  os << "operation,lowest_ns,highest_ns,count" << endl;
+  for (int i = 0; i < LATENCY_OPERATION_COUNT; i++) {
+    LatencyHistogram const& histogram = latencies.operations[i];
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+      if (histogram.getBucketCount(bucket) != 0) {
+	os << static_cast<LatencyOperation>(i) << ",";
+	os << getLatencyBucketLowest(bucket) << ",";
+	os << getLatencyBucketHighest(bucket) << ",";
+	os << histogram.getBucketCount(bucket) << endl;
+      }
+    }
+  }
+}
+
+// ---------- LatencyHistogram getter functions --------------------------------
+
+long long LatencyHistogram::getCount() const {
+  return count;
+}
+
+long long LatencyHistogram::getBucketCount(int bucket) const {
+  return counts[bucket];
+}
+
+double LatencyHistogram::getMean() const {
+  return (count == 0) ? 0 : static_cast<double>(totalNanoseconds) / count;
+}
+
+long long LatencyHistogram::getPercentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  // The latency wanted is the rank-th lowest, counting from 1
+  long long rank = static_cast<long long>(ceil(percentile / 100 * count));
+  rank = max(1LL, min(rank, count));
+  long long seen = 0;
+  int bucket = 0;
+  while (seen + counts[bucket] < rank) {
+    seen += counts[bucket++];
+  }
+  return (bucket == LATENCY_BUCKET_COUNT - 1) ?
+    getLatencyBucketLowest(bucket) : getLatencyBucketHighest(bucket);
+}
+
+long long LatencyHistogram::getMax() const {
+  return getPercentile(100);
+}
+
+// ---------- LatencyHistogram other functions ---------------------------------
+
+void LatencyHistogram::record(long long nanoseconds) {
+  addBucket(getLatencyBucket(nanoseconds), 1, nanoseconds);
+}
+
+void LatencyHistogram::addBucket(int bucket, long long count,
+				 long long totalNanoseconds) {
+  counts[bucket] += count;
+  this->count += count;
+  this->totalNanoseconds += totalNanoseconds;
+}
+
+void LatencyHistogram::add(LatencyHistogram const& other) {
+  for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+    counts[bucket] += other.counts[bucket];
+  }
+  count += other.count;
+  totalNanoseconds += other.totalNanoseconds;
+}
+
+#ifdef CHESS_STATS
+
+// The ThreadLatencies of every running thread, and the histograms of the
+// threads which have finished, both guarded by registryMutex
+static mutex registryMutex;
+static vector<ThreadLatencies*> registry;
+static EngineLatencies finishedLatencies;
+
+thread_local ThreadLatencies threadLatencies;
+
+/* Adds the histograms of the thread which owns the input ThreadLatencies to
+   latencies. */
+static void addThreadLatencies(EngineLatencies& latencies,
+			       ThreadLatencies const& owner) {
+  for (int i = 0; i < LATENCY_OPERATION_COUNT; i++) {
+    LatencyHistogram& histogram = latencies.operations[i];
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+      long long count = owner.counts[i][bucket].load(memory_order_relaxed);
+      if (count != 0) {
+	histogram.addBucket(bucket, count);
+      }
+    }
+    histogram.addBucket(0, 0,
+			owner.totalNanoseconds[i].load(memory_order_relaxed));
+  }
+}
+
+/* Empties the histograms in the input ThreadLatencies. */
+static void clearThreadLatencies(ThreadLatencies& owner) {
+  for (int i = 0; i < LATENCY_OPERATION_COUNT; i++) {
+    for (atomic<long long>& count : owner.counts[i]) {
+      count.store(0, memory_order_relaxed);
+    }
+    owner.totalNanoseconds[i].store(0, memory_order_relaxed);
+  }
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+ThreadLatencies::ThreadLatencies() {
+  clearThreadLatencies(*this);
+  lock_guard<mutex> lock{registryMutex};
+  registry.push_back(this);
+}
+
+ThreadLatencies::~ThreadLatencies() {
+  lock_guard<mutex> lock{registryMutex};
+  addThreadLatencies(finishedLatencies, *this);
+  registry.erase(find(registry.begin(), registry.end(), this));
+}
+
+// ---------- Functions --------------------------------------------------------
+
+EngineLatencies getThreadLatencies() {
+  EngineLatencies latencies;
+  addThreadLatencies(latencies, threadLatencies);
+  return latencies;
+}
+
+EngineLatencies getLatencies() {
+  EngineLatencies latencies;
+  lock_guard<mutex> lock{registryMutex};
+  for (int i = 0; i < LATENCY_OPERATION_COUNT; i++) {
+    latencies.operations[i].add(finishedLatencies.operations[i]);
+  }
+  for (ThreadLatencies const* thread : registry) {
+    addThreadLatencies(latencies, *thread);
+  }
+  return latencies;
+}
+
+void resetThreadLatencies() {
+  clearThreadLatencies(threadLatencies);
+}
+
+void resetLatencies() {
+  lock_guard<mutex> lock{registryMutex};
+  finishedLatencies = EngineLatencies{};
+  for (ThreadLatencies* thread : registry) {
+    clearThreadLatencies(*thread);
+  }
+}
+
+#else
+
+// ---------- Functions --------------------------------------------------------
+
+EngineLatencies getThreadLatencies() {
+  return EngineLatencies{};
+}
+
+EngineLatencies getLatencies() {
+  return EngineLatencies{};
+}
+
+void resetThreadLatencies() {}
+
+void resetLatencies() {}
+
+#endif
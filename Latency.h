@@ -0,0 +1,229 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/* The LatencyOperation enumeration lists the calls whose latency is
+   recorded when the engine is built with CHESS_STATS defined: the three
+   versions of ChessBoard::submitMove(), taking two squares, a castle or a
+   Move, and the check, checkmate and stalemate tests. The first two
+   versions of submitMove() call the third, so a move submitted as squares
+   is recorded by both, and each time includes the tests it makes. */
+
+enum LatencyOperation { SubmitSquaresLatency, SubmitCastleLatency,
+			SubmitMoveLatency, CheckLatency, CheckmateLatency,
+			StalemateLatency };
+
+const int LATENCY_OPERATION_COUNT = 6;
+
+/* This function allows a LatencyOperation enumerator to be output to the
+   output stream specified, as the function it times, e.g.
+   "isPlayerInCheck". The names have no spaces or commas. */
+std::ostream& operator<<(std::ostream& os, const LatencyOperation& operation);
+
+// Each power of two of nanoseconds is split into 2^LATENCY_SUB_BUCKET_BITS
+// buckets, so a recorded latency is out by at most 1 part in 32, and every
+// latency below 2^(LATENCY_SUB_BUCKET_BITS + 1) nanoseconds is exact
+const int LATENCY_SUB_BUCKET_BITS = 5;
+const int LATENCY_SUB_BUCKET_COUNT = 1 << LATENCY_SUB_BUCKET_BITS;
+
+// Latencies of 2^LATENCY_MAX_EXPONENT nanoseconds (about 69 seconds) or more
+// are all put in one more bucket at the end
+const int LATENCY_MAX_EXPONENT = 36;
+const int LATENCY_BUCKET_COUNT =
+  LATENCY_SUB_BUCKET_COUNT * (LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS +
+			      1) + 1;
+
+/* Returns the number of the bucket that a latency of the input number of
+   nanoseconds is counted in. The buckets are in order of latency. */
+inline int getLatencyBucket(long long nanoseconds) {
+  if (nanoseconds < 2 * LATENCY_SUB_BUCKET_COUNT) {
+    return (nanoseconds < 0) ? 0 : static_cast<int>(nanoseconds);
+  }
+  int exponent = 63 - __builtin_clzll(static_cast<uint64_t>(nanoseconds));
+  if (exponent >= LATENCY_MAX_EXPONENT) {
+    return LATENCY_BUCKET_COUNT - 1;
+  }
+
+  // The top LATENCY_SUB_BUCKET_BITS + 1 bits pick the bucket, and the top
+  // one of them is always set
+  int shift = exponent - LATENCY_SUB_BUCKET_BITS;
+  return (shift + 1) * LATENCY_SUB_BUCKET_COUNT +
+    static_cast<int>(nanoseconds >> shift) - LATENCY_SUB_BUCKET_COUNT;
+}
+
+/* Returns the lowest latency, in nanoseconds, counted in the input
+   bucket. */
+long long getLatencyBucketLowest(int bucket);
+
+/* Returns the highest latency, in nanoseconds, counted in the input bucket,
+   or -1 for the last bucket, which has no highest. */
+long long getLatencyBucketHighest(int bucket);
+
+/* The LatencyHistogram class counts latencies in buckets which grow with the
+   latency, like an HDR histogram, so that percentiles as high as the
+   99.9th can be read from it with a small, fixed error, whatever the
+   range of the latencies. Histograms can be added together, so that the
+   ones recorded by different threads can be merged. */
+
+class LatencyHistogram {
+public:
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of latencies recorded. */
+  long long getCount() const;
+
+  /* Returns the number of latencies counted in the input bucket. */
+  long long getBucketCount(int bucket) const;
+
+  /* Returns the mean latency in nanoseconds, which is exact, or 0 if there
+     are none. */
+  double getMean() const;
+
+  /* Returns the highest latency which is at least as high as percentile
+     percent of the latencies recorded, to within its bucket, e.g. 99.9 for
+     the 99.9th percentile. A latency in the last bucket is given as the
+     lowest of it. Returns 0 if there are none. */
+  long long getPercentile(double percentile) const;
+
+  /* Returns the highest latency recorded, to within its bucket, in the same
+     way as getPercentile(). */
+  long long getMax() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Counts a latency of the input number of nanoseconds. */
+  void record(long long nanoseconds);
+
+  /* Counts count latencies in the input bucket, which were totalNanoseconds
+     long altogether. */
+  void addBucket(int bucket, long long count, long long totalNanoseconds = 0);
+
+  /* Adds the latencies recorded in other to this histogram. */
+  void add(LatencyHistogram const& other);
+
+private:
+  long long counts[LATENCY_BUCKET_COUNT] = {};
+  long long count = 0;
+  long long totalNanoseconds = 0;
+};
+
+/* The EngineLatencies struct holds the LatencyHistogram of each
+   LatencyOperation, read at one moment. */
+
+struct EngineLatencies {
+  LatencyHistogram operations[LATENCY_OPERATION_COUNT];
+};
+
+/* This function allows an EngineLatencies object to be output to the output
+   stream specified, one line for each operation with any latencies, giving
+   the count, the mean, the 50th, 90th, 99th and 99.9th percentiles and the
+   highest latency, in nanoseconds. */
+std::ostream& operator<<(std::ostream& os, const EngineLatencies& latencies);
+
+/* Outputs latencies to os in a form for other programs to read: a header
+   line, "operation,lowest_ns,highest_ns,count", then one line for each
+   bucket with any latencies in it, in order of operation and then of
+   latency. The highest latency of the last bucket is -1, as it has no
+   limit. */
+void printLatencyCsv(std::ostream& os, EngineLatencies const& latencies);
+
+/* Returns the latencies recorded by the calling thread. Every histogram is
+   empty unless the engine was built with CHESS_STATS defined. */
+EngineLatencies getThreadLatencies();
+
+/* Returns the latencies recorded by every thread merged together, including
+   threads which have finished. */
+EngineLatencies getLatencies();
+
+/* Empties the histograms of the calling thread. */
+void resetThreadLatencies();
+
+/* Empties the histograms of every thread. Latencies recorded by other
+   threads while this runs may be lost, so it is best called while they
+   are idle. */
+void resetLatencies();
+
+#ifdef CHESS_STATS
+
+/* The ThreadLatencies class holds the histograms of one thread, in the same
+   way as ThreadStats holds its counters: only the owning thread records
+   into them, with relaxed atomic loads and stores which cost the same as
+   plain ones, and any thread can read them. Each object adds itself to a
+   list when it is constructed, so that getLatencies() can find it, and
+   adds its histograms to the ones of finished threads when it is
+   destroyed. */
+
+class ThreadLatencies {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a ThreadLatencies object with every histogram empty and adds
+     it to the list of threads. */
+  ThreadLatencies();
+
+  /* Destructor. Adds the histograms to the ones of finished threads and
+     takes the object off the list. */
+  ~ThreadLatencies();
+
+  ThreadLatencies(ThreadLatencies const&) = delete;
+  ThreadLatencies& operator=(ThreadLatencies const&) = delete;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Counts a latency of the input number of nanoseconds for operation. */
+  void record(LatencyOperation operation, long long nanoseconds) {
+    increase(counts[operation][getLatencyBucket(nanoseconds)], 1);
+    increase(totalNanoseconds[operation], nanoseconds);
+  }
+
+  std::atomic<long long> counts[LATENCY_OPERATION_COUNT][LATENCY_BUCKET_COUNT];
+  std::atomic<long long> totalNanoseconds[LATENCY_OPERATION_COUNT];
+
+private:
+  /* Adds amount to value, which only this thread writes. */
+  static void increase(std::atomic<long long>& value, long long amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount,
+		std::memory_order_relaxed);
+  }
+};
+
+/* The histograms of the calling thread. */
+extern thread_local ThreadLatencies threadLatencies;
+
+/* The LatencyTimer class records the time from its construction to its
+   destruction in the histogram of a LatencyOperation, so it times the rest
+   of the scope it is declared in. */
+
+class LatencyTimer {
+public:
+  /* Starts timing for the input operation. */
+  LatencyTimer(LatencyOperation operation) : operation(operation),
+    start(std::chrono::steady_clock::now()) {}
+
+  /* Stops timing and records the time taken. */
+  ~LatencyTimer() {
+    threadLatencies.record(operation, std::chrono::duration_cast<
+			   std::chrono::nanoseconds>(
+			     std::chrono::steady_clock::now() - start).count());
+  }
+
+private:
+  LatencyOperation operation;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Records the time until the end of the scope for the input operation
+#define STATS_LATENCY(operation) LatencyTimer latencyTimer{operation}
+
+#else
+
+// Without CHESS_STATS no latencies are recorded and they cost nothing
+#define STATS_LATENCY(operation)
+
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+/* This file contains the main function of the mate tool, which solves a
+   file of mate problems and checks that each one is sound. Usage:
+   >> mate problems.epd
+   >> mate problems.epd 4 8
+   Each line of the file is a position in Extended Position Description,
+   whose first four fields are the position, optionally followed by the
+   operation "dm <n>;", meaning White or Black to play and mate in n moves.
+   Empty lines and lines starting with '#' are skipped. The number after the
+   file is the most moves looked for in problems without "dm", 3 if it is
+   left out, and the number after that is the number of threads. If it is
+   left out, one thread is used for every core. A problem is sound if its
+   shortest mate is in exactly n moves and it has only one first move that
+   mates that quickly. */
+
+#include "MateSolver.h"
+#include "GameState.h"
+#include "San.h"
+#include "Move.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Most positions searched for one problem before giving up on it
+const long long MATE_NODE_LIMIT = 20000000;
+
+// Size of the table of each thread's MateSolver, in megabytes
+const size_t MATE_THREAD_TABLE_MEGABYTES = 64;
+
+/* The Puzzle struct holds one problem of the file.
+   lineNumber is the line of the file it is on.
+   fen is the position, in Forsyth-Edwards Notation.
+   moves is the number of moves of its "dm" operation, or 0 if it has
+   none. */
+
+struct Puzzle {
+  int lineNumber = 0;
+  string fen;
+  int moves = 0;
+};
+
+/* Reads every problem of the file with the input name. Throws the
+   PuzzleError exception defined in "errors.h" if the file cannot be read
+   or one of its lines is not a valid problem. */
+static vector<Puzzle> readPuzzles(string const& fileName) {
+  ifstream file{fileName};
+  if (!file) {
+    throw PuzzleError{fileName, "could not be opened"};
+  }
+
+  vector<Puzzle> puzzles;
+  string line;
+  int lineNumber = 0;
+  while (getline(file, line)) {
+    lineNumber++;
+    istringstream fields{line};
+    string placement, side, castling, enPassant;
+    if (!(fields >> placement) || placement[0] == '#') {
+      continue;
+    }
+    fields >> side >> castling >> enPassant;
+    Puzzle puzzle;
+    puzzle.lineNumber = lineNumber;
+    puzzle.fen = placement + " " + side + " " + castling + " " + enPassant;
+    try {
+      GameState{puzzle.fen};
+    } catch (FenError const& e) {
+      throw PuzzleError{fileName, "line " + to_string(lineNumber) + ": " +
+			e.what()};
+    }
+
+    // Only the "dm" operation is read, and any others are skipped
+    string operation;
+    while (fields >> operation) {
+      if (operation != "dm") {
+	continue;
+      }
+      string moves;
+      fields >> moves;
+      try {
+	puzzle.moves = stoi(moves);
+      } catch (exception const& e) {
+	puzzle.moves = 0;
+      }
+      if (puzzle.moves < 1 || puzzle.moves > MAX_MATE_MOVES) {
+	throw PuzzleError{fileName, "line " + to_string(lineNumber) +
+			  ": the dm operation must be from 1 to " +
+			  to_string(MAX_MATE_MOVES) + " moves"};
+      }
+    }
+    puzzles.push_back(puzzle);
+  }
+  return puzzles;
+}
+
+/* Returns whether result shows puzzle to be sound. */
+static bool isSound(Puzzle const& puzzle, MateResult const& result) {
+  return result.status == MateFound && result.moves == puzzle.moves &&
+    result.keyMoves.size() == 1;
+}
+
+/* Outputs the line of the file puzzle is on and what result found. */
+static void printResult(Puzzle const& puzzle, MateResult const& result) {
+  GameState state{puzzle.fen};
+  cout << "Line " << puzzle.lineNumber << ": ";
+  if (result.status == MateFound) {
+    cout << "mate in " << result.moves << ":";
+    for (string const& san : toSanLine(state, result.line)) {
+      cout << " " << san;
+    }
+    if (result.keyMoves.size() > 1) {
+      cout << " (" << result.keyMoves.size() << " keys:";
+      for (Move const& key : result.keyMoves) {
+	cout << " " << toSanLine(state, {key})[0];
+      }
+      cout << ")";
+    }
+  } else if (result.status == NoMate) {
+    cout << "no mate";
+  } else {
+    cout << "gave up after " << result.nodes << " nodes";
+  }
+  if (puzzle.moves > 0) {
+    cout << ((isSound(puzzle, result)) ? " - sound" : " - unsound");
+  }
+  cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 4) {
+    cerr << "Usage: mate <puzzle file> [moves] [threads]" << endl;
+    return 1;
+  }
+
+  vector<Puzzle> puzzles;
+  int defaultMoves = 3;
+  int threadCount = 0;
+  try {
+    puzzles = readPuzzles(argv[1]);
+    defaultMoves = (argc >= 3) ? stoi(argv[2]) : defaultMoves;
+    threadCount = (argc == 4) ? stoi(argv[3]) : 0;
+  } catch (PuzzleError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  } catch (exception const& e) {
+    cerr << "The moves and threads must be numbers!" << endl;
+    return 1;
+  }
+  if (defaultMoves < 1 || defaultMoves > MAX_MATE_MOVES) {
+    cerr << "The moves must be from 1 to " << MAX_MATE_MOVES << "!" << endl;
+    return 1;
+  }
+  if (threadCount < 1) {
+    threadCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+  cout << "Solving " << puzzles.size() << " problems with " << threadCount;
+  cout << " thread(s)" << endl;
+
+  // The problems are handed out one at a time, and each thread keeps its
+  // own MateSolver, and so its own table, for all of them
+  vector<MateResult> results(puzzles.size());
+  atomic<size_t> nextPuzzle{0};
+  auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (int i = 0; i < threadCount; i++) {
+    threads.emplace_back([&] {
+      MateSolver solver{MATE_THREAD_TABLE_MEGABYTES};
+      MateLimits limits;
+      limits.nodes = MATE_NODE_LIMIT;
+      limits.isEveryKeyFound = true;
+      size_t index;
+      while ((index = nextPuzzle.fetch_add(1)) < puzzles.size()) {
+	Puzzle const& puzzle = puzzles[index];
+	limits.moves = (puzzle.moves > 0) ? puzzle.moves : defaultMoves;
+	results[index] = solver.solve(GameState{puzzle.fen}, limits);
+      }
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  long long milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  long long mates = 0;
+  long long unsound = 0;
+  long long nodes = 0;
+  for (size_t i = 0; i < puzzles.size(); i++) {
+    printResult(puzzles[i], results[i]);
+    mates += (results[i].status == MateFound) ? 1 : 0;
+    unsound += (puzzles[i].moves > 0 && !isSound(puzzles[i], results[i])) ?
+      1 : 0;
+    nodes += results[i].nodes;
+  }
+  cout << puzzles.size() << " problems, " << mates << " mates found, ";
+  cout << unsound << " unsound, " << nodes << " nodes in " << milliseconds;
+  cout << " ms, " << static_cast<long long>(puzzles.size()) * 60000 /
+    max(milliseconds, 1LL) << " problems per minute" << endl;
+  return (unsound > 0) ? 1 : 0;
+}
@@ -0,0 +1,322 @@
+/* This file contains the member functions of the MateSolver class. */
+
+#include "MateSolver.h"
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Player.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Proof or disproof number of a position which is known not to be a mate,
+// or to be one, respectively
+const uint32_t INFINITE_NUMBER = UINT32_MAX;
+
+/* Returns number, or INFINITE_NUMBER if it is larger. */
+static uint32_t capNumber(uint64_t number) {
+  return static_cast<uint32_t>(min<uint64_t>(number, INFINITE_NUMBER));
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+MateSolver::MateSolver(size_t tableMegabytes) {
+  // Round the number of entries down to a power of two, so that the index
+  // is the key masked
+  size_t maxCount = max<size_t>(1, tableMegabytes * 1024 * 1024 /
+				sizeof(MateEntry));
+  size_t count = 1;
+  while (count * 2 <= maxCount) {
+    count *= 2;
+  }
+  entries.assign(count, MateEntry{});
+  mask = count - 1;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+MateResult MateSolver::solve(GameState const& state, MateLimits limits) {
+  MateResult result;
+  attacker = state.getPlayer();
+  nodes = 0;
+  nodeLimit = limits.nodes;
+  isStopped = false;
+
+  int shortest = getShortestMate(state, max(1, min(limits.moves,
+						   MAX_MATE_MOVES)));
+  if (shortest > 0) {
+    result.moves = shortest;
+    getLine(state, shortest, result.line);
+    if (!result.line.empty()) {
+      result.keyMoves.push_back(result.line[0]);
+    }
+  }
+
+  // Every other first move has to be proved or disproved on its own
+  if (shortest > 0 && limits.isEveryKeyFound && !isStopped) {
+    Move moves[MAX_MOVES];
+    int moveCount = state.getLegalMoves(moves);
+    for (int i = 0; i < moveCount && !isStopped; i++) {
+      if (moves[i] == result.keyMoves[0]) {
+	continue;
+      }
+      GameState next = state;
+      next.playMove(moves[i]);
+      if (prove(next, shortest - 1) == MateFound) {
+	result.keyMoves.push_back(moves[i]);
+      }
+    }
+  }
+
+  if (isStopped) {
+    result.status = MateUnknown;
+  } else {
+    result.status = (shortest > 0) ? MateFound : NoMate;
+  }
+  result.nodes = nodes;
+  return result;
+}
+
+MateResult MateSolver::solve(ChessBoard const& board, MateLimits limits) {
+  return solve(GameState{board.getFen()}, limits);
+}
+
+void MateSolver::clearTable() {
+  fill(entries.begin(), entries.end(), MateEntry{});
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+HashKey MateSolver::getKey(GameState const& state, int moves) const {
+  // The same position is a different problem with the other attacker
+  HashKey key = state.getHash() ^ (static_cast<HashKey>(moves) *
+				   0x9E3779B97F4A7C15ULL);
+  return (attacker == Black) ? key ^ 0xD6E8FEB86659FD93ULL : key;
+}
+
+bool MateSolver::probe(GameState const& state, int moves, uint32_t& proof,
+		       uint32_t& disproof) const {
+  HashKey key = getKey(state, moves);
+  MateEntry const& slot = entries[key & mask];
+  if (slot.key != key) {
+    return false;
+  }
+  proof = slot.proof;
+  disproof = slot.disproof;
+  return true;
+}
+
+void MateSolver::store(GameState const& state, int moves, uint32_t proof,
+		       uint32_t disproof) {
+  HashKey key = getKey(state, moves);
+  MateEntry& slot = entries[key & mask];
+  slot.key = key;
+  slot.proof = proof;
+  slot.disproof = disproof;
+}
+
+void MateSolver::evaluate(GameState const& state, int moves, uint32_t& proof,
+			  uint32_t& disproof) const {
+  proof = 1;
+  disproof = 1;
+  if (state.getPlayer() == attacker) {
+    return;
+  }
+
+  // With no moves left only a check can be a mate, and finding that out
+  // does not need the defender's moves
+  bool isInCheck = state.isInCheck(state.getPlayer());
+  if (moves == 0 && !isInCheck) {
+    proof = INFINITE_NUMBER;
+    disproof = 0;
+    return;
+  }
+  Move replies[MAX_MOVES];
+  int replyCount = state.getLegalMoves(replies);
+  if (replyCount == 0 || moves == 0) {
+    bool isMate = (replyCount == 0 && isInCheck);
+    proof = (isMate) ? 0 : INFINITE_NUMBER;
+    disproof = (isMate) ? INFINITE_NUMBER : 0;
+    return;
+  }
+  proof = static_cast<uint32_t>(replyCount);
+}
+
+void MateSolver::searchPosition(GameState const& state, int moves,
+				uint32_t proofThreshold,
+				uint32_t disproofThreshold, uint32_t& proof,
+				uint32_t& disproof) {
+  nodes++;
+  if (nodeLimit > 0 && nodes >= nodeLimit) {
+    isStopped = true;
+    return;
+  }
+
+  bool isAttackerToMove = (state.getPlayer() == attacker);
+  Move legalMoves[MAX_MOVES];
+  int moveCount = state.getLegalMoves(legalMoves);
+  if (moveCount == 0 || moves == 0) {
+    bool isMate = (moveCount == 0 && !isAttackerToMove &&
+		   state.isInCheck(state.getPlayer()));
+    proof = (isMate) ? 0 : INFINITE_NUMBER;
+    disproof = (isMate) ? INFINITE_NUMBER : 0;
+    store(state, moves, proof, disproof);
+    return;
+  }
+
+  // The attacker needs one move to be a mate and the defender every move,
+  // so the attacker's numbers are the least proof number and the sum of
+  // the disproof numbers of the positions after their moves, and the other
+  // way round for the defender
+  int childMoves = (isAttackerToMove) ? moves - 1 : moves;
+  uint32_t proofs[MAX_MOVES];
+  uint32_t disproofs[MAX_MOVES];
+  for (int i = 0; i < moveCount; i++) {
+    GameState child = state;
+    child.playMove(legalMoves[i]);
+    if (!probe(child, childMoves, proofs[i], disproofs[i])) {
+      evaluate(child, childMoves, proofs[i], disproofs[i]);
+      store(child, childMoves, proofs[i], disproofs[i]);
+    }
+  }
+  uint32_t* leastNumbers = (isAttackerToMove) ? proofs : disproofs;
+  uint32_t* summedNumbers = (isAttackerToMove) ? disproofs : proofs;
+  uint32_t& least = (isAttackerToMove) ? proof : disproof;
+  uint32_t& sum = (isAttackerToMove) ? disproof : proof;
+  uint32_t leastThreshold = (isAttackerToMove) ? proofThreshold :
+    disproofThreshold;
+  uint32_t sumThreshold = (isAttackerToMove) ? disproofThreshold :
+    proofThreshold;
+
+  while (true) {
+    int best = 0;
+    uint32_t secondLeast = INFINITE_NUMBER;
+    uint64_t total = 0;
+    for (int i = 0; i < moveCount; i++) {
+      if (leastNumbers[i] < leastNumbers[best]) {
+	secondLeast = leastNumbers[best];
+	best = i;
+      } else if (i != best && leastNumbers[i] < secondLeast) {
+	secondLeast = leastNumbers[i];
+      }
+      total += summedNumbers[i];
+    }
+    least = leastNumbers[best];
+
+    // A sum is only infinite if one of the numbers is
+    bool isInfinite = any_of(summedNumbers, summedNumbers + moveCount,
+			     [](uint32_t number) {
+			       return number == INFINITE_NUMBER;
+			     });
+    sum = (isInfinite) ? INFINITE_NUMBER :
+      static_cast<uint32_t>(min<uint64_t>(total, INFINITE_NUMBER - 1));
+    if (least >= leastThreshold || sum >= sumThreshold) {
+      break;
+    }
+
+    // Search the most proving move until it is no longer the best one or
+    // the sum passes its threshold
+    uint32_t childLeastThreshold = capNumber(min<uint64_t>(
+					       leastThreshold,
+					       secondLeast + 1ULL));
+    uint32_t childSumThreshold = capNumber(
+      static_cast<uint64_t>(sumThreshold) - sum + summedNumbers[best]);
+    GameState child = state;
+    child.playMove(legalMoves[best]);
+    if (isAttackerToMove) {
+      searchPosition(child, childMoves, childLeastThreshold,
+		     childSumThreshold, proofs[best], disproofs[best]);
+    } else {
+      searchPosition(child, childMoves, childSumThreshold,
+		     childLeastThreshold, proofs[best], disproofs[best]);
+    }
+    if (isStopped) {
+      return;
+    }
+  }
+  store(state, moves, proof, disproof);
+}
+
+MateStatus MateSolver::prove(GameState const& state, int moves) {
+  uint32_t proof = 0;
+  uint32_t disproof = 0;
+  if (!probe(state, moves, proof, disproof) || (proof != 0 && disproof != 0)) {
+    searchPosition(state, moves, INFINITE_NUMBER, INFINITE_NUMBER, proof,
+		   disproof);
+  }
+  if (isStopped) {
+    return MateUnknown;
+  }
+  return (proof == 0) ? MateFound : NoMate;
+}
+
+int MateSolver::getShortestMate(GameState const& state, int maxMoves) {
+  // Most positions are not mates at all, which one search shows, so the
+  // shorter mates are only looked for once there is a mate
+  MateStatus status = prove(state, maxMoves);
+  if (status != MateFound) {
+    return (status == MateUnknown) ? -1 : 0;
+  }
+  for (int moves = maxMoves - 1; moves >= 1; moves--) {
+    status = prove(state, moves);
+    if (status == MateUnknown) {
+      return -1;
+    }
+    if (status == NoMate) {
+      return moves + 1;
+    }
+  }
+  return 1;
+}
+
+void MateSolver::getLine(GameState const& state, int moves,
+			 vector<Move>& line) {
+  // Any move which mates in the moves left is a quickest one
+  Move legalMoves[MAX_MOVES];
+  int moveCount = state.getLegalMoves(legalMoves);
+  GameState next;
+  int i = 0;
+  for (; i < moveCount; i++) {
+    next = state;
+    next.playMove(legalMoves[i]);
+    MateStatus status = prove(next, moves - 1);
+    if (status == MateUnknown) {
+      return;
+    }
+    if (status == MateFound) {
+      break;
+    }
+  }
+  if (i == moveCount) {
+    return;
+  }
+  line.push_back(legalMoves[i]);
+
+  // The defender puts the mate off for as long as they can
+  Move replies[MAX_MOVES];
+  int replyCount = next.getLegalMoves(replies);
+  int longest = 0;
+  int longestReply = 0;
+  for (int j = 0; j < replyCount; j++) {
+    GameState after = next;
+    after.playMove(replies[j]);
+    int shortest = getShortestMate(after, moves - 1);
+    if (shortest < 0) {
+      return;
+    }
+    if (shortest > longest) {
+      longest = shortest;
+      longestReply = j;
+    }
+  }
+  if (longest == 0) {
+    return;
+  }
+  line.push_back(replies[longestReply]);
+  next.playMove(replies[longestReply]);
+  getLine(next, longest, line);
+}
@@ -0,0 +1,167 @@
+#ifndef MATESOLVER_H
+#define MATESOLVER_H
+
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Player.h"
+#include "Zobrist.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Most moves of the attacker a mate can be looked for in
+const int MAX_MATE_MOVES = 32;
+
+// Size of the table of a MateSolver if none is given, in megabytes
+const std::size_t DEFAULT_MATE_TABLE_MEGABYTES = 16;
+
+/* The MateLimits struct holds what a MateSolver is asked to find.
+   moves is the most moves of the attacker, the player to move, the mate
+   may take, from 1 to MAX_MATE_MOVES.
+   nodes, if it is more than 0, is the number of positions after which the
+   MateSolver gives up.
+   isEveryKeyFound is true if every first move that mates as quickly as
+   possible is wanted, e.g. to check that a problem has only one solution,
+   rather than just one of them. */
+
+struct MateLimits {
+  int moves = 3;
+  long long nodes = 0;
+  bool isEveryKeyFound = false;
+};
+
+/* The MateStatus enumeration is the outcome of looking for a mate.
+   MateFound means the attacker can force mate within the moves asked for,
+   NoMate that they cannot, and MateUnknown that the node limit was reached
+   before everything asked for was found. */
+
+enum MateStatus { MateFound, NoMate, MateUnknown };
+
+/* The MateResult struct holds the outcome of looking for a mate.
+   moves is the number of moves of the attacker in the shortest mate, or 0
+   if none has been found.
+   line is the main line of the mate: a quickest move of the attacker after
+   each move of the defender that puts the mate off the longest, ending in
+   checkmate.
+   keyMoves holds the first move of line, and every other first move that
+   mates in as few moves if MateLimits::isEveryKeyFound was set.
+   nodes is the number of positions searched. */
+
+struct MateResult {
+  MateStatus status = NoMate;
+  int moves = 0;
+  std::vector<Move> line;
+  std::vector<Move> keyMoves;
+  long long nodes = 0;
+};
+
+/* The MateEntry struct holds what a MateSolver found out about whether one
+   position is a mate within a number of moves.
+   key is the hash of the position mixed with the number of moves and the
+   attacker, or 0 for an empty entry.
+   proof and disproof are the proof and disproof numbers of the position. */
+
+struct MateEntry {
+  HashKey key = 0;
+  uint32_t proof = 0;
+  uint32_t disproof = 0;
+};
+
+/* The MateSolver class proves or disproves that the player to move can
+   force checkmate within a number of moves, by depth-first proof-number
+   search. Instead of scores, every position has a proof number, the least
+   number of positions that would have to be shown to be mates to prove it
+   one, and a disproof number, the least number that would have to be shown
+   not to be to disprove it. The search always goes into the most proving
+   position, the one whose numbers are smallest, and only comes back up
+   when the numbers of the one above pass its thresholds, so the moves that
+   leave the defender fewest replies, such as checks, are tried first and
+   deepest.
+   Positions are GameStates, which have the same rules as ChessBoard and
+   are copied rather than taken back. The numbers are kept in a fixed size
+   hash table of MateEntry objects, keyed by the position, the number of
+   moves left and the attacker, so that a position reached by different
+   orders of moves is only searched once. A proof or disproof holds for
+   any problem with the same attacker, and the key keeps White's mates
+   apart from Black's, so the table can be kept from one problem to the
+   next.
+   The shortest mate is found by first looking for a mate in the most moves
+   allowed, which settles the positions with no mate at once, and then in
+   one move fewer at a time until there is none. As usual for mate
+   problems, draws by repetition or the fifty-move rule are not taken into
+   account. A MateSolver must only be used by one thread at a time. */
+
+class MateSolver {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a MateSolver object with a table taking up at most the input
+     number of megabytes, and at least one entry. */
+  MateSolver(std::size_t tableMegabytes = DEFAULT_MATE_TABLE_MEGABYTES);
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Looks for the shortest mate in the position of state, within limits. */
+  MateResult solve(GameState const& state, MateLimits limits);
+
+  /* Looks for the shortest mate in the position on the board, within
+     limits. */
+  MateResult solve(ChessBoard const& board, MateLimits limits);
+
+  /* Empties the table. */
+  void clearTable();
+
+private:
+  std::vector<MateEntry> entries;
+  std::size_t mask = 0;
+  Player attacker = White;
+  long long nodes = 0;
+  long long nodeLimit = 0;
+  bool isStopped = false;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Returns the key of the position of state with moves of the attacker
+     left, for the current attacker. */
+  HashKey getKey(GameState const& state, int moves) const;
+
+  /* Looks up the position of state with moves left. If it is in the table,
+     copies its numbers into proof and disproof and returns true. */
+  bool probe(GameState const& state, int moves, uint32_t& proof,
+	     uint32_t& disproof) const;
+
+  /* Stores the numbers of the position of state with moves left. */
+  void store(GameState const& state, int moves, uint32_t proof,
+	     uint32_t disproof);
+
+  /* Puts the first estimate of the numbers of the position of state with
+     moves left, which has not been searched, into proof and disproof. A
+     position with the defender to move is solved at once if the defender
+     has no legal moves or no moves are left, and otherwise gets a proof
+     number of its number of legal moves. */
+  void evaluate(GameState const& state, int moves, uint32_t& proof,
+		uint32_t& disproof) const;
+
+  /* Searches the position of state with moves left until its proof number
+     reaches proofThreshold or its disproof number reaches
+     disproofThreshold, and puts them into proof and disproof. */
+  void searchPosition(GameState const& state, int moves,
+		      uint32_t proofThreshold, uint32_t disproofThreshold,
+		      uint32_t& proof, uint32_t& disproof);
+
+  /* Proves or disproves that the position of state is a mate with moves
+     left. Returns MateUnknown if the node limit is reached. */
+  MateStatus prove(GameState const& state, int moves);
+
+  /* Returns the fewest moves, at most maxMoves, in which the attacker can
+     mate in the position of state, with the attacker to move, or 0 if they
+     cannot. Returns -1 if the node limit is reached. */
+  int getShortestMate(GameState const& state, int maxMoves);
+
+  /* Appends the main line of the mate in moves from the position of state,
+     with the attacker to move, to line. moves must be the shortest mate. */
+  void getLine(GameState const& state, int moves, std::vector<Move>& line);
+};
+
+#endif
@@ -0,0 +1,73 @@
+/* This file contains the member functions and friend functions of the Move
+   class. */
+
+#include "Move.h"
+#include "Square.h"
+#include "constants.h"
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+static_assert(sizeof(Move) == 2, "a Move must fit in 16 bits");
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Move::Move() {}
+
+Move::Move(Square source, Square destination, bool isCastle) :
+  Move(source.getIndex(), destination.getIndex(), isCastle) {}
+
+Move::Move(int sourceIndex, int destinationIndex, bool isCastle) :
+  bits(static_cast<uint16_t>(sourceIndex |
+			     (destinationIndex << MOVE_DESTINATION_SHIFT) |
+			     ((isCastle) ? MOVE_CASTLE_FLAG : 0))) {}
+
+Move::Move(uint16_t bits) : bits(bits) {}
+
+bool Move::operator==(Move const& otherMove) const {
+  return (bits == otherMove.bits);
+}
+
+ostream& operator<<(ostream& os, Move const& move) {
+  if (move.isCastle()) {
+    os << ((move.isKingsideCastle()) ? "O-O" : "O-O-O");
+  } else {
+    os << move.getSource() << move.getDestination();
+  }
+  return os;
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+Square Move::getSource() const {
+  int index = getSourceIndex();
+  return Square{index / BOARD_WIDTH, index % BOARD_WIDTH};
+}
+
+Square Move::getDestination() const {
+  int index = getDestinationIndex();
+  return Square{index / BOARD_WIDTH, index % BOARD_WIDTH};
+}
+
+int Move::getSourceIndex() const {
+  return bits & MOVE_SQUARE_MASK;
+}
+
+int Move::getDestinationIndex() const {
+  return (bits >> MOVE_DESTINATION_SHIFT) & MOVE_SQUARE_MASK;
+}
+
+uint16_t Move::getBits() const {
+  return bits;
+}
+
+// ---------- Checker functions ------------------------------------------------
+
+bool Move::isCastle() const {
+  return (bits & MOVE_CASTLE_FLAG) != 0;
+}
+
+bool Move::isKingsideCastle() const {
+  return (isCastle() && getDestinationIndex() > getSourceIndex());
+}
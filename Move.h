@@ -0,0 +1,78 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include "Square.h"
+#include <cstdint>
+#include <iostream>
+
+// Layout of the 16 bits of a Move: the source square index in bits 0-5,
+// the destination square index in bits 6-11 and the flags in bits 12-15
+const int MOVE_DESTINATION_SHIFT = 6;
+const uint16_t MOVE_SQUARE_MASK = 0x3F;
+const uint16_t MOVE_CASTLE_FLAG = 0x1000;
+
+/* The Move class describes one move of the player to move in 16 bits, so
+   that it is cheap to copy, store in the TranspositionTable and compare.
+   The source and destination squares are the squares the Piece moves from
+   and to, by their Square::getIndex() values. The flag bits say what kind
+   of move it is. Only the castle flag is used, because the rules do not
+   have promotion or en passant, and the other three bits are kept for
+   them. For a castle the source and destination are the squares the King
+   moves from and to, e.g. E1 and G1 for White castling kingside. */
+
+class Move {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a Move object from A1 to A1, which is not a move. */
+  Move();
+
+  /* Constructs a Move object from source to destination. */
+  Move(Square source, Square destination, bool isCastle = false);
+
+  /* Constructs a Move object from the square with index sourceIndex to the
+     square with index destinationIndex. The indices must be 0-63. */
+  Move(int sourceIndex, int destinationIndex, bool isCastle = false);
+
+  /* Constructs a Move object from the 16 bits returned by getBits(). */
+  explicit Move(uint16_t bits);
+
+  /* Returns true if both Move objects have the same squares and are both
+     castles or both not castles. */
+  bool operator==(Move const& otherMove) const;
+
+  /* This friend function allows the operator<< to be used with a Move object
+     to output the move to the output stream specified, e.g. "E2E4". Castles 
+     are output as "O-O" or "O-O-O". */
+  friend std::ostream& operator<<(std::ostream& os, Move const& move);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns a copy of the source square. */
+  Square getSource() const;
+
+  /* Returns a copy of the destination square. */
+  Square getDestination() const;
+
+  /* Returns the index of the source square, as Square::getIndex() does. */
+  int getSourceIndex() const;
+
+  /* Returns the index of the destination square. */
+  int getDestinationIndex() const;
+
+  /* Returns the 16 bits of the move, in the layout described above. */
+  uint16_t getBits() const;
+
+  // ---------- Checker functions ----------------------------------------------
+
+  /* Returns true if the move is a castle. */
+  bool isCastle() const;
+
+  /* Returns true if the move is a kingside castle. */
+  bool isKingsideCastle() const;
+
+private:
+  uint16_t bits = 0;
+};
+
+#endif
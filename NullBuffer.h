@@ -0,0 +1,22 @@
+#ifndef NULLBUFFER_H
+#define NULLBUFFER_H
+
+#include <streambuf>
+
+/* The NullBuffer class is a stream buffer which throws away everything
+   written to it. Putting it in place of the buffer of std::cout silences
+   the messages of ChessBoard::submitMove(), while the messages are still
+   formatted as usual, e.g. when timing it:
+   NullBuffer nullBuffer;
+   std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+   ...
+   std::cout.rdbuf(coutBuffer); */
+
+class NullBuffer : public std::streambuf {
+protected:
+  int overflow(int c) override {
+    return c;
+  }
+};
+
+#endif
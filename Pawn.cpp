@@ -4,20 +4,23 @@
 #include "Pawn.h"
 #include "Player.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
 
 // ---------- Contructors, destructors and operator overloads ------------------
 
-Pawn::Pawn(Player colour, ChessBoard& board) : Piece(colour, board, "Pawn") {}
+Pawn::Pawn(Player colour, ChessBoard& board) :
+  Piece(colour, board, PawnType) {}
 
 Pawn::Pawn(Pawn const& otherPawn, ChessBoard& board) :
-  Piece(otherPawn.colour, board, otherPawn.name) {}
+  Piece(otherPawn, board) {}
 
 Pawn::~Pawn() {}
 
@@ -25,43 +28,53 @@ Pawn::~Pawn() {}
 
 bool Pawn::isMovePossible(Square sourceSquare,
 			  Square destinationSquare) {
+  return (colour == White) ?
+    isMovePossible<White>(sourceSquare, destinationSquare) :
+    isMovePossible<Black>(sourceSquare, destinationSquare);
+}
+
+bool Pawn::isAnyLegalMovePossible(Square square) {
+  return (colour == White) ? isAnyLegalMovePossible<White>(square) :
+    isAnyLegalMovePossible<Black>(square);
+}
+
+// ---------- Other functions --------------------------------------------------
+
+Piece* Pawn::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) Pawn{*this, board});
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+template <Player Us>
+bool Pawn::isMovePossible(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(PawnMovePossibleCount);
+
+  constexpr int forward = forwardStep<Us>();
   int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
   int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
   
-  bool isOneSquareForward = (fileChange == 0 &&
-			     ((rankChange == 1 && colour == White) ||
-			      (rankChange == -1 && colour == Black)));
+  bool isOneSquareForward = (fileChange == 0 && rankChange == forward);
   
-  bool isTwoSquaresForward = (fileChange == 0 &&
-			      ((rankChange == 2 && colour == White) ||
-			       (rankChange == -2 && colour == Black)));
+  bool isTwoSquaresForward = (fileChange == 0 && rankChange == 2 * forward);
   
   bool isFirstMoveOfPawn = !(this->hasMoved);
 
+  // If Pawn moves two squares forward, check the square in between, which
+  // is on the board because the squares either side of it are
   bool pathIsClear = true;
-  
-  // If Pawn moves two squares forward, check the square in between
   if (isTwoSquaresForward) {
-    try {
-      Square squareInPath =
-	Square(sourceSquare.getRank() + (rankChange / abs(rankChange)),
-	       sourceSquare.getFile());
-      
-      pathIsClear = !(board.isPieceThere(squareInPath));
-    } catch (OffBoardError const& e) {
-      // Path is not clear if it involves moving off the board
-      pathIsClear = false;
-    }
+    Square squareInPath{sourceSquare.getRank() + forward,
+			sourceSquare.getFile()};
+    pathIsClear = !(board.isPieceThere(squareInPath));
   }
 		  
   bool destinationIsFree = !(board.isPieceThere(destinationSquare));
 
-  bool isOneAlongDiagonal = (abs(fileChange) == 1 &&
-			     ((rankChange == 1 && colour == White) ||
-			      (rankChange == -1 && colour == Black)));
+  bool isOneAlongDiagonal = (abs(fileChange) == 1 && rankChange == forward);
 
   bool isTakingOpponent = (board.isOpponentPieceThere(destinationSquare,
-						      !colour));
+						      !Us));
 
   bool isMovePossible = ((isOneSquareForward && destinationIsFree) ||
 
@@ -73,21 +86,22 @@ bool Pawn::isMovePossible(Square sourceSquare,
   return isMovePossible;
 }
 
+template <Player Us>
 bool Pawn::isAnyLegalMovePossible(Square square) {
   // Iterate over all possible moves that Pawn can make and check
   // if any are legal
 
-  int rankChange = (colour == White) ? 1 : -1; // Forward one square
+  constexpr int forward = forwardStep<Us>();
 
   // Either one left, right or straight ahead
   for (int fileChange = -1; fileChange <= 1; fileChange++) {
     
-    int destinationRank = square.getRank() + rankChange;
+    int destinationRank = square.getRank() + forward;
     int destinationFile = square.getFile() + fileChange;
 
     try {
       Square destination{destinationRank, destinationFile};
-      if (this->isMovePossible(square, destination) &&
+      if (isMovePossible<Us>(square, destination) &&
 	  board.isMoveLegal(square, destination)) {
 	return true;
       }
@@ -100,14 +114,10 @@ bool Pawn::isAnyLegalMovePossible(Square square) {
   bool isFirstMoveOfPawn = !(this->hasMoved);
 
   if (isFirstMoveOfPawn) {
-    rankChange = (colour == White) ? 2 : -2;
-    int fileChange = 0;
-
     try {
-      Square destination{square.getRank() + rankChange,
-			 square.getFile() + fileChange};
+      Square destination{square.getRank() + 2 * forward, square.getFile()};
       
-      if (this->isMovePossible(square, destination) &&
+      if (isMovePossible<Us>(square, destination) &&
 	  board.isMoveLegal(square, destination)) {
 	return true;
       }
@@ -118,9 +128,3 @@ bool Pawn::isAnyLegalMovePossible(Square square) {
   
   return false;
 }
-
-// ---------- Other functions --------------------------------------------------
-
-Piece* Pawn::copyPiece(ChessBoard& board) {
-  return (new Pawn{*this, board});
-}
@@ -14,7 +14,7 @@
    variables: 
    Player colour - contains the colour of the Pawn
    ChessBoard& board - reference to the ChessBoard object which owns the Pawn
-   std::string name - the name of the Piece, in this case "Pawn"
+   PieceType type - the kind of Piece, in this case PawnType
    bool hasMoved - false if the Pawn has not moved yet */
 
 class Pawn : public Piece {
@@ -22,7 +22,7 @@ public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
   /* Constructs a Pawn object with colour and board set to the input variables,
-     name set to "Pawn" and hasMoved set to false.*/
+     type set to PawnType and hasMoved set to false.*/
   Pawn(Player colour, ChessBoard& board);
 
   /* Constructs a Pawn object which is a copy of the input Pawn object, except
@@ -47,10 +47,21 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a Piece pointer to a copy of the Pawn object on which this function
-     is called, but with the ChessBoard reference of the new object set to the 
+  /* Constructs a copy of the Pawn object on which this function is called in
+     storage, a PieceArena slot of the board input, and returns a Piece
+     pointer to it. The ChessBoard reference of the new object is set to the
      board input. */
-  Piece* copyPiece(ChessBoard& board) override;
+  Piece* copyPiece(ChessBoard& board, void* storage) override;
+
+private:
+  // ---------- Helper functions -----------------------------------------------
+
+  /* The versions of isMovePossible() and isAnyLegalMovePossible() for a
+     Pawn of colour Us. The functions above call the one for the Pawn's
+     colour, so the direction it moves in is a constant. */
+  template <Player Us>
+  bool isMovePossible(Square sourceSquare, Square destinationSquare);
+  template <Player Us> bool isAnyLegalMovePossible(Square square);
 };
 
 #endif
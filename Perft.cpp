@@ -0,0 +1,28 @@
+/* This file contains the perft function. */
+
+#include "Perft.h"
+#include "ChessBoard.h"
+#include "Move.h"
+#include <vector>
+
+using namespace std;
+
+long long perft(ChessBoard& board, int depth) {
+  if (depth == 0) {
+    return 1;
+  }
+
+  // The last moves only need counting, not making or listing
+  if (depth == 1) {
+    return board.countLegalMoves();
+  }
+  vector<Move> moves = board.getLegalMoves();
+
+  long long count = 0;
+  for (Move const& move : moves) {
+    board.playMove(move);
+    count += perft(board, depth - 1);
+    board.takeback();
+  }
+  return count;
+}
@@ -0,0 +1,16 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "ChessBoard.h"
+
+/* Returns the number of move sequences of length depth from the position on
+   the board, i.e. the number of leaf positions of the tree of legal moves,
+   counting a position again for each way it is reached. This is the usual
+   way of checking and timing move generation. Each move is made with
+   playMove() and taken back with takeback(), so the board ends up as it
+   was. The moves of the last ply are only counted, with countLegalMoves().
+   As usual for perft, draws by repetition or the fifty-move rule are not
+   taken into account. */
+long long perft(ChessBoard& board, int depth);
+
+#endif
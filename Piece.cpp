@@ -15,14 +15,18 @@ using namespace std;
 
 // ---------- Contructors, destructors and operator overloads ------------------
 
-Piece::Piece(Player colour, ChessBoard& board, string name) :
-  colour(colour), board(board), name(name), hasMoved(false) {}
+Piece::Piece(Player colour, ChessBoard& board, PieceType type) :
+  colour(colour), board(board), type(type), hasMoved(false) {}
+
+Piece::Piece(Piece const& otherPiece, ChessBoard& board) :
+  colour(otherPiece.colour), board(board), type(otherPiece.type),
+  hasMoved(otherPiece.hasMoved) {}
 
 Piece::~Piece() {}
 
 /* Friend function */
 ostream& operator<<(ostream& os, Piece const& piece) {
-  os << piece.name;
+  os << piece.getName();
   return os;
 }
 
@@ -32,8 +36,15 @@ Player Piece::getColour() const {
   return colour;
 }
 
+PieceType Piece::getType() const {
+  return type;
+}
+
 string const& Piece::getName() const {
-  return name;
+  // One copy of each name is shared by all the Pieces
+  static const string names[PIECE_TYPE_COUNT] = {"Pawn", "Knight", "Bishop",
+						 "Rook", "Queen", "King"};
+  return names[type];
 }
 
 // ---------- Setter functions -------------------------------------------------
@@ -4,16 +4,18 @@
 #include "constants.h"
 #include "Square.h"
 #include "Player.h"
+#include "PieceType.h"
 #include <iostream>
 #include <string>
 
 class ChessBoard; // Forward declaration to avoid circular dependencies
 
-/* The Piece class contains a Player, a reference, a string and a boolean 
+/* The Piece class contains a Player, a reference, a PieceType and a boolean 
    value.
    colour contains a Player enumerator giving the colour of the Piece.
    board is a reference to the ChessBoard object which owns the Piece.
-   name is a string containing the name of the Piece.
+   type contains a PieceType enumerator giving the kind of Piece, from
+   which its name is found.
    hasMoved is a boolean which is false is the Piece has not yet been 
    moved, and true if it has. 
    Piece is an abstract base class - the derived classes are Pawn, Bishop, 
@@ -23,9 +25,14 @@ class Piece {
 public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
-  /* Constructs a Piece object with colour, board and name initialised
+  /* Constructs a Piece object with colour, board and type initialised
      to the input values and hasMoved initialised to false. */
-  Piece(Player colour, ChessBoard& board, std::string name);
+  Piece(Player colour, ChessBoard& board, PieceType type);
+
+  /* Constructs a Piece object which is a copy of otherPiece, including
+     whether it has moved, except for the board variable which is set to the
+     input board. */
+  Piece(Piece const& otherPiece, ChessBoard& board);
 
   /* Destructor. */
   virtual ~Piece();
@@ -41,7 +48,10 @@ public:
   /* Returns a copy of the colour. */
   Player getColour() const;
 
-  /* Returns a constant reference to the name. */
+  /* Returns a copy of the type. */
+  PieceType getType() const;
+
+  /* Returns a constant reference to the name, e.g. "Knight". */
   std::string const& getName() const;
 
   // ---------- Setter functions -----------------------------------------------
@@ -69,15 +79,16 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a pointer to a copy of the Piece object on which this function 
-     is called, but with the reference of the new object set to the board
-     input. */
-  virtual Piece* copyPiece(ChessBoard& board) = 0;
+  /* Constructs a copy of the Piece object on which this function is called
+     in storage, which must be a slot from the PieceArena of the board input,
+     and returns a pointer to it. The reference of the new object is set to
+     the board input. */
+  virtual Piece* copyPiece(ChessBoard& board, void* storage) = 0;
     
 protected:
   Player colour;
   ChessBoard& board;
-  std::string const name;
+  PieceType type;
   bool hasMoved = false;
 };
 
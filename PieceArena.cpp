@@ -0,0 +1,56 @@
+/* This file contains the member functions of the PieceArena class. */
+
+#include "PieceArena.h"
+#include "Piece.h"
+#include "Pawn.h"
+#include "Bishop.h"
+#include "Knight.h"
+#include "Rook.h"
+#include "Queen.h"
+#include "King.h"
+#include <new>
+
+using namespace std;
+
+static_assert(sizeof(Pawn) <= PIECE_SLOT_SIZE &&
+	      sizeof(Knight) <= PIECE_SLOT_SIZE &&
+	      sizeof(Bishop) <= PIECE_SLOT_SIZE &&
+	      sizeof(Rook) <= PIECE_SLOT_SIZE &&
+	      sizeof(Queen) <= PIECE_SLOT_SIZE &&
+	      sizeof(King) <= PIECE_SLOT_SIZE,
+	      "every Piece must fit in a PieceArena slot");
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+PieceArena::PieceArena() {}
+
+// ---------- Getter functions -------------------------------------------------
+
+int PieceArena::getPieceCount() const {
+  return usedCount - freeCount;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void* PieceArena::allocate() {
+  if (freeCount > 0) {
+    return slots[freeSlots[--freeCount]];
+  }
+  if (usedCount == PIECE_ARENA_SLOTS) {
+    throw bad_alloc{};
+  }
+  return slots[usedCount++];
+}
+
+void PieceArena::release(Piece* piece) {
+  // The slot starts at the most derived object, not at the Piece part
+  unsigned char* slot = static_cast<unsigned char*>(dynamic_cast<void*>(piece));
+  piece->~Piece();
+  freeSlots[freeCount++] = static_cast<uint8_t>((slot - slots[0]) /
+						PIECE_SLOT_SIZE);
+}
+
+void PieceArena::releaseAll() {
+  freeCount = 0;
+  usedCount = 0;
+}
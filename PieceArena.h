@@ -0,0 +1,64 @@
+#ifndef PIECEARENA_H
+#define PIECEARENA_H
+
+#include "Piece.h"
+#include <cstddef>
+#include <cstdint>
+
+// Number of Piece slots in a PieceArena, one for each square so that a
+// board can never run out
+const int PIECE_ARENA_SLOTS = 64;
+
+// Size in bytes of one slot. The derived Piece classes add no member
+// variables, which is checked in "PieceArena.cpp".
+const std::size_t PIECE_SLOT_SIZE = sizeof(Piece);
+
+/* The PieceArena class holds the storage for all the Pieces of one
+   ChessBoard, so that creating, copying and taking Pieces never calls
+   new or delete. A Piece is constructed in a slot from allocate() with
+   placement new, e.g. new (arena.allocate()) Pawn{White, board}.
+   Slots are handed out in order from the start of the array, and slots
+   given back by release() are kept on a free list and reused first.
+   releaseAll() gives back every slot at once without visiting the Pieces,
+   which is possible because a Piece owns no other memory. */
+
+class PieceArena {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs an empty PieceArena object. */
+  PieceArena();
+
+  /* The Pieces refer to the ChessBoard which owns them, so the storage is
+     never copied. A copied ChessBoard copies each Piece into its own
+     arena instead. */
+  PieceArena(PieceArena const&) = delete;
+  PieceArena& operator=(PieceArena const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of slots which are in use. */
+  int getPieceCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Returns a free slot of PIECE_SLOT_SIZE bytes, suitably aligned for any
+     Piece. If all the slots are in use it throws std::bad_alloc. */
+  void* allocate();
+
+  /* Destroys the input Piece, which must have been constructed in a slot of
+     this arena, and puts its slot on the free list. */
+  void release(Piece* piece);
+
+  /* Makes every slot free. Any Pieces still in the slots must not be used
+     afterwards. */
+  void releaseAll();
+
+private:
+  alignas(Piece) unsigned char slots[PIECE_ARENA_SLOTS][PIECE_SLOT_SIZE];
+  uint8_t freeSlots[PIECE_ARENA_SLOTS];
+  int freeCount = 0;
+  int usedCount = 0;
+};
+
+#endif
@@ -0,0 +1,19 @@
+/* This file contains the operator overloads for the PieceType enumeration. */
+
+#include "PieceType.h"
+#include <iostream>
+
+using namespace std;
+
+ostream& operator<<(ostream& os, const PieceType& type) {
+  switch (type) {
+  case PawnType: os << "Pawn"; break;
+  case KnightType: os << "Knight"; break;
+  case BishopType: os << "Bishop"; break;
+  case RookType: os << "Rook"; break;
+  case QueenType: os << "Queen"; break;
+  case KingType: os << "King"; break;
+  case NoPieceType: os << "Nothing"; break;
+  }
+  return os;
+}
@@ -0,0 +1,20 @@
+#ifndef PIECETYPE_H
+#define PIECETYPE_H
+
+#include <iostream>
+
+/* The PieceType enumeration lists the six kinds of chess Piece. It is used
+   where a Piece object would be too heavy, for example to index the 
+   Bitboards of a GameState. NoPieceType stands for an empty square. */
+
+enum PieceType { PawnType, KnightType, BishopType, RookType, QueenType,
+		 KingType, NoPieceType };
+
+const int PIECE_TYPE_COUNT = 6;
+
+/* This function allows a PieceType enumerator to be output to the output 
+   stream specified. The output is the same as the name of the matching
+   Piece class, e.g. "Knight". */
+std::ostream& operator<<(std::ostream& os, const PieceType& type);
+
+#endif
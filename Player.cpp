@@ -9,7 +9,3 @@ ostream& operator<<(ostream& os, const Player& player) {
   os << ((player == White) ? "White" : "Black");
   return os;
 }
-
-Player operator!(const Player player) {
-  return ((player == White) ? Black : White);
-}
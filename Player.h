@@ -1,6 +1,7 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include "constants.h"
 #include <iostream>
 
 /* The player enumeration represents the two sides in a chess game: Black
@@ -14,7 +15,26 @@ enum Player { White, Black };
 std::ostream& operator<<(std::ostream& os, const Player& player);
 
 /* This function returns the opposite enumerator to the input one, i.e.
-   !White returns Black and !Black returns White. */
-Player operator!(const Player player);
+   !White returns Black and !Black returns White. It can be worked out at
+   compile time, so !Us can be used as a template argument. */
+constexpr Player operator!(const Player player) {
+  return ((player == White) ? Black : White);
+}
+
+/* The functions below are for code written once for each colour, as
+   template <Player Us>, so that the colour is a constant and the
+   directions and ranks that depend on it need no branches. */
+
+/* Returns the change in rank of one step forward for player Us, i.e. 1 for
+   White and -1 for Black. */
+template <Player Us> constexpr int forwardStep() {
+  return (Us == White) ? 1 : -1;
+}
+
+/* Returns the rank which is rank ranks up the board from player Us's side,
+   so relativeRank<Us>(MIN_RANK) is the rank Us's King starts on. */
+template <Player Us> constexpr int relativeRank(int rank) {
+  return (Us == White) ? rank : MAX_RANK - rank;
+}
 
 #endif
@@ -0,0 +1,373 @@
+/* This file contains the member functions of the PositionIndex class and
+   the function which builds a position index. */
+
+#include "PositionIndex.h"
+#include "GameDatabase.h"
+#include "GameState.h"
+#include "ChessBoard.h"
+#include "Move.h"
+#include "Zobrist.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char FILE_MAGIC[] = "CHESSPI1";
+const int FILE_MAGIC_LENGTH = 8;
+
+// Number of games each thread takes at a time while the games are replayed
+const size_t GAMES_PER_CHUNK = 256;
+
+// Most directory bits an index file may have
+const int MAX_DIRECTORY_BITS = 32;
+
+/* One occurrence of a position, as it is kept while the index is built. */
+struct IndexRecord {
+  HashKey hash;
+  uint32_t game;
+  uint32_t ply;
+
+  bool operator<(IndexRecord const& other) const {
+    if (hash != other.hash) {
+      return hash < other.hash;
+    }
+    return (game != other.game) ? game < other.game : ply < other.ply;
+  }
+};
+
+/* The entries and occurrences of one part of the index. The offsets in
+   the entries start from the first occurrence of the part. */
+struct EncodedPart {
+  vector<uint8_t> entries;
+  vector<uint8_t> occurrences;
+};
+
+/* Adds value to the end of bytes, seven bits to a byte, lowest first, with
+   the top bit set in every byte but the last. */
+static void writeVarint(vector<uint8_t>& bytes, uint64_t value) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+/* Reads a number written by writeVarint() at position into value and moves
+   position past it. Returns false if the number runs past end. */
+static bool readVarint(uint8_t const*& position, uint8_t const* end,
+		       uint64_t& value) {
+  value = 0;
+  for (int shift = 0; position < end && shift < 64; shift += 7) {
+    uint8_t byte = *position++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Returns the top bits bits of hash. */
+static uint64_t getTopBits(HashKey hash, int bits) {
+  return (bits == 0) ? 0 : hash >> (64 - bits);
+}
+
+/* Runs work(thread number) on threadCount threads and waits for them all
+   to finish. If any of them throws an exception, the first one is thrown
+   again once they have all finished. */
+template <typename Work>
+static void runOnThreads(int threadCount, Work work) {
+  vector<exception_ptr> errors(threadCount);
+  vector<thread> threads;
+  for (int i = 0; i < threadCount; i++) {
+    threads.emplace_back([&, i] {
+      try {
+	work(i);
+      } catch (...) {
+	errors[i] = current_exception();
+      }
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  for (exception_ptr const& error : errors) {
+    if (error) {
+      rethrow_exception(error);
+    }
+  }
+}
+
+/* Sorts the occurrences of one part and encodes them. */
+static EncodedPart encodePart(vector<IndexRecord>& records) {
+  sort(records.begin(), records.end());
+  EncodedPart part;
+  size_t i = 0;
+  while (i < records.size()) {
+    size_t end = i;
+    while (end < records.size() && records[end].hash == records[i].hash) {
+      end++;
+    }
+
+    uint8_t entry[POSITION_INDEX_ENTRY_BYTES];
+    writeLittleEndian(entry, records[i].hash, 8);
+    writeLittleEndian(entry + 8, part.occurrences.size(), 8);
+    part.entries.insert(part.entries.end(), entry,
+			entry + POSITION_INDEX_ENTRY_BYTES);
+
+    writeVarint(part.occurrences, end - i);
+    uint32_t lastGame = 0;
+    for (; i < end; i++) {
+      writeVarint(part.occurrences, records[i].game - lastGame);
+      writeVarint(part.occurrences, records[i].ply);
+      lastGame = records[i].game;
+    }
+  }
+  return part;
+}
+
+// ---------- Functions --------------------------------------------------------
+
+void buildPositionIndex(GameDatabase const& database, string const& fileName,
+			int threadCount) {
+  if (threadCount < 1) {
+    threadCount = static_cast<int>(thread::hardware_concurrency());
+  }
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  const int partCount = 1 << POSITION_INDEX_PARTITION_BITS;
+  size_t gameCount = database.getGameCount();
+
+  // Replay the games, with each thread putting the occurrences it finds
+  // into its own list for each part
+  vector<vector<vector<IndexRecord>>> found(threadCount);
+  atomic<size_t> nextChunk{0};
+  runOnThreads(threadCount, [&](int threadNumber) {
+    vector<vector<IndexRecord>>& parts = found[threadNumber];
+    parts.resize(partCount);
+    size_t first;
+    while ((first = GAMES_PER_CHUNK * nextChunk.fetch_add(1)) < gameCount) {
+      size_t last = min(first + GAMES_PER_CHUNK, gameCount);
+      for (size_t game = first; game < last; game++) {
+	GameReplay replay{database, game};
+	Move move;
+	do {
+	  HashKey hash = replay.getState().getHash();
+	  parts[getTopBits(hash, POSITION_INDEX_PARTITION_BITS)].push_back(
+	    {hash, static_cast<uint32_t>(game),
+	     static_cast<uint32_t>(replay.getPly())});
+	} while (replay.next(move));
+      }
+    }
+  });
+
+  // Gather, sort and encode each part on whichever thread is free
+  vector<EncodedPart> encoded(partCount);
+  atomic<int> nextPart{0};
+  runOnThreads(threadCount, [&](int) {
+    int part;
+    while ((part = nextPart.fetch_add(1)) < partCount) {
+      vector<IndexRecord> records;
+      for (vector<vector<IndexRecord>>& parts : found) {
+	records.insert(records.end(), parts[part].begin(), parts[part].end());
+	vector<IndexRecord>().swap(parts[part]);
+      }
+      encoded[part] = encodePart(records);
+    }
+  });
+
+  // Give each entry the offset of its occurrences from the start of all of
+  // them, and build the directory from the hashes, which are in order
+  uint64_t positionCount = 0;
+  for (EncodedPart const& part : encoded) {
+    positionCount += part.entries.size() / POSITION_INDEX_ENTRY_BYTES;
+  }
+  int directoryBits = 0;
+  while (directoryBits < MAX_DIRECTORY_BITS &&
+	 (positionCount >> directoryBits) > POSITION_INDEX_BUCKET_SIZE) {
+    directoryBits++;
+  }
+  size_t bucketCount = static_cast<size_t>(1) << directoryBits;
+  vector<uint8_t> directory((bucketCount + 1) * 8);
+  uint64_t position = 0;
+  uint64_t bucket = 0;
+  uint64_t occurrenceBase = 0;
+  for (EncodedPart& part : encoded) {
+    for (size_t i = 0; i < part.entries.size();
+	 i += POSITION_INDEX_ENTRY_BYTES) {
+      uint8_t* entry = part.entries.data() + i;
+      writeLittleEndian(entry + 8,
+			readLittleEndian(entry + 8, 8) + occurrenceBase, 8);
+      uint64_t entryBucket = getTopBits(readLittleEndian(entry, 8),
+					directoryBits);
+      while (bucket <= entryBucket) {
+	writeLittleEndian(directory.data() + 8 * bucket++, position, 8);
+      }
+      position++;
+    }
+    occurrenceBase += part.occurrences.size();
+  }
+  while (8 * bucket < directory.size()) {
+    writeLittleEndian(directory.data() + 8 * bucket++, position, 8);
+  }
+
+  ofstream file{fileName, ios::binary | ios::trunc};
+  if (!file) {
+    throw PositionIndexError{fileName, "could not be opened"};
+  }
+  uint8_t header[POSITION_INDEX_HEADER_BYTES] = {};
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    header[i] = static_cast<uint8_t>(FILE_MAGIC[i]);
+  }
+  writeLittleEndian(header + 8, positionCount, 8);
+  writeLittleEndian(header + 16, directoryBits, 8);
+  writeLittleEndian(header + 24, POSITION_INDEX_HEADER_BYTES +
+		    directory.size() +
+		    positionCount * POSITION_INDEX_ENTRY_BYTES, 8);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(directory.data()),
+	     directory.size());
+  for (EncodedPart const& part : encoded) {
+    file.write(reinterpret_cast<const char*>(part.entries.data()),
+	       part.entries.size());
+  }
+  for (EncodedPart const& part : encoded) {
+    file.write(reinterpret_cast<const char*>(part.occurrences.data()),
+	       part.occurrences.size());
+  }
+  file.close();
+  if (!file) {
+    throw PositionIndexError{fileName, "could not be written"};
+  }
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+PositionIndex::PositionIndex(string const& fileName) : fileName(fileName) {
+  int descriptor = open(fileName.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw PositionIndexError{fileName, "could not be opened"};
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 ||
+      status.st_size < POSITION_INDEX_HEADER_BYTES) {
+    ::close(descriptor);
+    throw PositionIndexError{fileName, "is too short"};
+  }
+  fileSize = static_cast<size_t>(status.st_size);
+  void* address = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (address == MAP_FAILED) {
+    throw PositionIndexError{fileName, "could not be mapped into memory"};
+  }
+  bytes = static_cast<uint8_t const*>(address);
+
+  bool isCorrectMagic = true;
+  for (int i = 0; i < FILE_MAGIC_LENGTH; i++) {
+    isCorrectMagic = isCorrectMagic && (bytes[i] == FILE_MAGIC[i]);
+  }
+  uint64_t count = readLittleEndian(bytes + 8, 8);
+  uint64_t bits = readLittleEndian(bytes + 16, 8);
+  occurrencesOffset = readLittleEndian(bytes + 24, 8);
+  bool isValid = isCorrectMagic && bits <= MAX_DIRECTORY_BITS &&
+    count <= fileSize / POSITION_INDEX_ENTRY_BYTES;
+  if (isValid) {
+    uint64_t directoryBytes = ((static_cast<uint64_t>(1) << bits) + 1) * 8;
+    isValid = (occurrencesOffset == POSITION_INDEX_HEADER_BYTES +
+	       directoryBytes + count * POSITION_INDEX_ENTRY_BYTES &&
+	       occurrencesOffset <= fileSize);
+  }
+  if (!isValid) {
+    munmap(const_cast<uint8_t*>(bytes), fileSize);
+    throw PositionIndexError{fileName, "does not hold a position index"};
+  }
+  positionCount = static_cast<size_t>(count);
+  directoryBits = static_cast<int>(bits);
+}
+
+PositionIndex::~PositionIndex() {
+  munmap(const_cast<uint8_t*>(bytes), fileSize);
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+size_t PositionIndex::getPositionCount() const {
+  return positionCount;
+}
+
+size_t PositionIndex::getFileSize() const {
+  return fileSize;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+vector<PositionOccurrence> PositionIndex::find(HashKey hash) const {
+  // The directory gives the range of entries whose hashes share the top
+  // bits of this one, and the entry is found by a binary search of them
+  uint8_t const* directory = bytes + POSITION_INDEX_HEADER_BYTES;
+  uint64_t bucket = getTopBits(hash, directoryBits);
+  uint64_t low = readLittleEndian(directory + 8 * bucket, 8);
+  uint64_t high = readLittleEndian(directory + 8 * (bucket + 1), 8);
+  if (low > high || high > positionCount) {
+    throw PositionIndexError{fileName, "has a corrupt directory"};
+  }
+  uint8_t const* entries = directory + ((static_cast<uint64_t>(1) <<
+					 directoryBits) + 1) * 8;
+  while (low < high) {
+    uint64_t middle = low + (high - low) / 2;
+    if (readLittleEndian(entries + middle * POSITION_INDEX_ENTRY_BYTES, 8) <
+	hash) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  vector<PositionOccurrence> occurrences;
+  uint8_t const* entry = entries + low * POSITION_INDEX_ENTRY_BYTES;
+  if (low == positionCount || readLittleEndian(entry, 8) != hash) {
+    return occurrences;
+  }
+
+  uint8_t const* end = bytes + fileSize;
+  uint64_t offset = readLittleEndian(entry + 8, 8);
+  uint8_t const* position = bytes + occurrencesOffset;
+  if (offset >= fileSize - occurrencesOffset) {
+    throw PositionIndexError{fileName, "has corrupt occurrences"};
+  }
+  position += offset;
+  uint64_t count = 0;
+  if (!readVarint(position, end, count) ||
+      count > static_cast<uint64_t>(end - position)) {
+    throw PositionIndexError{fileName, "has corrupt occurrences"};
+  }
+  occurrences.resize(count);
+  uint64_t game = 0;
+  for (PositionOccurrence& occurrence : occurrences) {
+    uint64_t gameDifference, ply;
+    if (!readVarint(position, end, gameDifference) ||
+	!readVarint(position, end, ply)) {
+      throw PositionIndexError{fileName, "has corrupt occurrences"};
+    }
+    game += gameDifference;
+    occurrence.game = static_cast<uint32_t>(game);
+    occurrence.ply = static_cast<uint32_t>(ply);
+  }
+  return occurrences;
+}
+
+vector<PositionOccurrence> PositionIndex::find(ChessBoard const& board) const {
+  return find(board.getHash());
+}
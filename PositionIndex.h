@@ -0,0 +1,119 @@
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include "GameDatabase.h"
+#include "Zobrist.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ChessBoard; // Forward declaration to avoid circular dependencies
+
+// Number of bytes in the header at the start of a position index file, and
+// in the entry of each position in it
+const int POSITION_INDEX_HEADER_BYTES = 32;
+const int POSITION_INDEX_ENTRY_BYTES = 16;
+
+// Number of parts the positions are split into by the top bits of their
+// hash while the index is built, so that each part can be sorted by a
+// different thread
+const int POSITION_INDEX_PARTITION_BITS = 8;
+
+// Average number of positions in each bucket of the directory of an index
+// file. A bucket of this many entries fits in one page.
+const int POSITION_INDEX_BUCKET_SIZE = 32;
+
+/* The PositionOccurrence struct is one time a position was reached in a
+   game of a GameDatabase.
+   game is the number of the game.
+   ply is the number of moves made before the position was reached, so the
+   starting position is at ply 0. */
+
+struct PositionOccurrence {
+  uint32_t game = 0;
+  uint32_t ply = 0;
+};
+
+/* Builds a position index of every position reached in every game of
+   database and writes it to the file with the input name. The games are
+   shared out between threadCount threads, which replay them, and the
+   positions are then sorted and encoded in parts, also on every thread.
+   If threadCount is less than 1, one thread is used for every core. Every
+   occurrence is held in memory while the index is built. Throws the
+   PositionIndexError exception defined in "errors.h" if the file cannot be
+   written, or GameDatabaseError if a game cannot be decoded. */
+void buildPositionIndex(GameDatabase const& database,
+			std::string const& fileName, int threadCount = 0);
+
+/* A position index file maps the Zobrist hash of each position to the
+   games which reach it, in four parts, with every number stored
+   little-endian:
+   - a header of POSITION_INDEX_HEADER_BYTES bytes: the eight characters
+     "CHESSPI1", the number of positions, the number of directory bits b
+     and the offset of the occurrences, each number taking eight bytes,
+   - a directory of 2^b + 1 eight byte numbers. Entry i is the number of
+     the first position whose hash has i as its top b bits, and the last
+     entry is the number of positions,
+   - an entry of POSITION_INDEX_ENTRY_BYTES bytes for each position, in
+     order of hash: the hash, then the offset of its occurrences from the
+     start of the occurrences, each in eight bytes,
+   - the occurrences of each position, sorted by game and then by ply: how
+     many there are, then for each one the difference between its game and
+     the one before (or its game, for the first) and its ply. Each number
+     is written seven bits to a byte, lowest first, with the top bit set in
+     every byte but the last, so most of them take one byte.
+   b is chosen so that there are about POSITION_INDEX_BUCKET_SIZE positions
+   for each directory entry, so a lookup reads one directory entry, one or
+   two pages of entries and the occurrences it returns.
+
+   The PositionIndex class reads a position index file, which is mapped
+   into memory like a GameDatabase. Nothing in it is changed after it is
+   opened, so any number of threads can look positions up at once. */
+
+class PositionIndex {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a PositionIndex object and maps the file with the input name
+     into memory. Throws the PositionIndexError exception defined in
+     "errors.h" if the file cannot be opened or mapped, or does not hold a
+     position index. */
+  PositionIndex(std::string const& fileName);
+
+  /* Destructor. Unmaps the file. */
+  ~PositionIndex();
+
+  PositionIndex(PositionIndex const&) = delete;
+  PositionIndex& operator=(PositionIndex const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of different positions in the index. */
+  std::size_t getPositionCount() const;
+
+  /* Returns the size of the file in bytes. */
+  std::size_t getFileSize() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Returns every occurrence of the position with the input hash, sorted by
+     game and then by ply, or nothing if no game reaches it. A different
+     position with the same hash would be returned as well, but with 64 bit
+     hashes that is very unlikely. Throws PositionIndexError if the
+     occurrences run past the end of the file. */
+  std::vector<PositionOccurrence> find(HashKey hash) const;
+
+  /* Returns every occurrence of the position on board. */
+  std::vector<PositionOccurrence> find(ChessBoard const& board) const;
+
+private:
+  std::string fileName;
+  uint8_t const* bytes = nullptr;
+  std::size_t fileSize = 0;
+  std::size_t positionCount = 0;
+  int directoryBits = 0;
+  uint64_t occurrencesOffset = 0;
+};
+
+#endif
@@ -3,11 +3,14 @@
 #include "Queen.h"
 #include "Piece.h"
 #include "Player.h"
+#include "Bitboard.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
@@ -15,65 +18,34 @@ using namespace std;
 // ---------- Contructors, destructors and operator overloads ------------------
 
 Queen::Queen(Player colour, ChessBoard& board) :
-  Piece(colour, board, "Queen") {}
+  Piece(colour, board, QueenType) {}
 
 Queen::Queen(Queen const& otherQueen, ChessBoard& board) :
-  Piece(otherQueen.colour, board, otherQueen.name) {}
+  Piece(otherQueen, board) {}
 
 Queen::~Queen() {}
 
 // ---------- Checker functions ------------------------------------------------
 
 bool Queen::isMovePossible(Square sourceSquare, Square destinationSquare) {
-  int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
-  int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
-
-  bool isAlongDiagonal = (abs(rankChange) == abs(fileChange) &&
-			  !(rankChange == 0 && fileChange == 0));
-
-  bool isAlongRankOrFile = (((abs(rankChange) == 0) ||
-			     (abs(fileChange) == 0)) &&
-			    !(rankChange == 0 && fileChange == 0));
-  
-  bool pathIsClear = true;
-
-  int pathSteps;
-  if (isAlongDiagonal) {
-    // Set the number of squares in the path to be the absolute change in rank
-    // (could equally be set to absolute change in file since they are equal).
-    pathSteps = abs(rankChange);
-  } else if (isAlongRankOrFile) {
-    // Set it to the number of squares moved in the direction that it moved
-    // (summing rankChange and fileChange is fine because one is always 0).
-    pathSteps = abs(rankChange + fileChange);
-  } else {
-    // Don't bother checking if neither isAlongDiagonal nor isAlongRankOrFile
-    // are true because the move is not possible.
-    pathSteps = 0;
-    pathIsClear = false;
-  }
+  STATS_COUNT(QueenMovePossibleCount);
 
-  try {
-    for (int i = 1; i < pathSteps; i++) {
-      int rankStep = (rankChange == 0) ? 0 : i * rankChange / abs(rankChange);
-      int fileStep = (fileChange == 0) ? 0 : i * fileChange / abs(fileChange);
-      
-      Square squareInPath = Square(sourceSquare.getRank() + rankStep,
-				   sourceSquare.getFile() + fileStep);
-      
-      pathIsClear = (pathIsClear && !board.isPieceThere(squareInPath));    
-    }
-  } catch (OffBoardError const& e) {
-    // Path is not clear if move goes off board
-    pathIsClear = false;
-  }
+  // The Queen moves along any rank, file or diagonal, which are exactly
+  // the lines in the line tables
+  bool isAlongLine = (lineThrough(sourceSquare.getIndex(),
+				  destinationSquare.getIndex()) !=
+		      EMPTY_BITBOARD);
+
+  // The squares in between must be empty. If the move is not along a line
+  // then it is not possible anyway, so the path is not checked.
+  bool pathIsClear = (isAlongLine &&
+		      board.isPathClear(sourceSquare, destinationSquare));
 
   bool destinationIsFree = !board.isPieceThere(destinationSquare);
 
   bool isTakingOpponent = board.isOpponentPieceThere(destinationSquare, !colour);
 
-  return ((isAlongDiagonal || isAlongRankOrFile) && pathIsClear &&
-	  (destinationIsFree || isTakingOpponent));
+  return (pathIsClear && (destinationIsFree || isTakingOpponent));
 }
 
 bool Queen::isAnyLegalMovePossible(Square square) {
@@ -119,6 +91,6 @@ bool Queen::isAnyLegalMovePossible(Square square) {
 
 // ---------- Other functions --------------------------------------------------
 
-Piece* Queen::copyPiece(ChessBoard& board) {
-  return (new Queen{*this, board});
+Piece* Queen::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) Queen{*this, board});
 }
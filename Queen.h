@@ -14,7 +14,7 @@
    variables: 
    Player colour - contains the colour of the Queen
    ChessBoard& board - reference to the ChessBoard object which owns the Queen
-   std::string name - the name of the Piece, in this case "Queen"
+   PieceType type - the kind of Piece, in this case QueenType
    bool hasMoved - false if the Queen has not moved yet */
 
 class Queen : public Piece {
@@ -22,7 +22,7 @@ public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
   /* Constructs a Queen object with colour and board set to the input variables,
-     name set to "Queen" and hasMoved set to false.*/
+     type set to QueenType and hasMoved set to false.*/
   Queen(Player colour, ChessBoard& board);
 
   /* Constructs a Queen object which is a copy of the input Queen object, except
@@ -47,10 +47,11 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a Piece pointer to a copy of the Queen object on which this 
-     function is called, but with the ChessBoard reference of the new object set 
-     to the board input. */
-  Piece* copyPiece(ChessBoard& board) override;
+  /* Constructs a copy of the Queen object on which this function is called in
+     storage, a PieceArena slot of the board input, and returns a Piece
+     pointer to it. The ChessBoard reference of the new object is set to the
+     board input. */
+  Piece* copyPiece(ChessBoard& board, void* storage) override;
 };
 
 #endif
@@ -4,10 +4,12 @@
 #include "Piece.h"
 #include "Player.h"
 #include "ChessBoard.h"
+#include "Stats.h"
 #include "constants.h"
 #include "errors.h"
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
 using namespace std;
@@ -15,16 +17,18 @@ using namespace std;
 // ---------- Contructors, destructors and operator overloads ------------------
 
 Rook::Rook(Player colour, ChessBoard& board) :
-  Piece(colour, board, "Rook") {}
+  Piece(colour, board, RookType) {}
 
 Rook::Rook(Rook const& otherRook, ChessBoard& board) :
-  Piece(otherRook.colour, board, otherRook.name) {}
+  Piece(otherRook, board) {}
 
 Rook::~Rook() {}
 
 // ---------- Checker functions ------------------------------------------------
 
 bool Rook::isMovePossible(Square sourceSquare, Square destinationSquare) {
+  STATS_COUNT(RookMovePossibleCount);
+
   int rankChange = destinationSquare.getRank() - sourceSquare.getRank();
   int fileChange = destinationSquare.getFile() - sourceSquare.getFile();
 
@@ -32,29 +36,10 @@ bool Rook::isMovePossible(Square sourceSquare, Square destinationSquare) {
 			     (abs(fileChange) == 0)) &&
 			    !(rankChange == 0 && fileChange == 0));
   
-  bool pathIsClear = true;
-
-  // If the move is along a rank or file, set the number of squares in the
-  // path to the number of squares the Rook moves (summing rankChange and
-  // fileChange is fine because one of them will be always 0). Don't bother
-  // checking path if isAlongRankOrFile is false because the move is not
-  // allowed.
-  int pathSteps = (isAlongRankOrFile) ? abs(rankChange + fileChange) : 0;
-
-  try {
-    for (int i = 1; i < pathSteps; i++) {
-      int rankStep = (rankChange == 0) ? 0 : i * rankChange / abs(rankChange);
-      int fileStep = (fileChange == 0) ? 0 : i * fileChange / abs(fileChange);
-      
-      Square squareInPath = Square(sourceSquare.getRank() + rankStep,
-				   sourceSquare.getFile() + fileStep);
-      
-      pathIsClear = (pathIsClear && !board.isPieceThere(squareInPath));    
-    }
-  } catch (OffBoardError const& e) {
-    // Path is not clear if move goes off board
-    pathIsClear = false;
-  }
+  // The squares in between must be empty. If the move is not along a rank
+  // or file then it is not possible anyway, so the path is not checked.
+  bool pathIsClear = (isAlongRankOrFile &&
+		      board.isPathClear(sourceSquare, destinationSquare));
 
   bool destinationIsFree = !board.isPieceThere(destinationSquare);
 
@@ -106,6 +91,6 @@ bool Rook::isAnyLegalMovePossible(Square square) {
 
 // ---------- Other functions --------------------------------------------------
 
-Piece* Rook::copyPiece(ChessBoard& board) {
-  return (new Rook{*this, board});
+Piece* Rook::copyPiece(ChessBoard& board, void* storage) {
+  return (new (storage) Rook{*this, board});
 }
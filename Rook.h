@@ -14,7 +14,7 @@
    variables: 
    Player colour - contains the colour of the Rook
    ChessBoard& board - reference to the ChessBoard object which owns the Rook
-   std::string name - the name of the Piece, in this case "Rook"
+   PieceType type - the kind of Piece, in this case RookType
    bool hasMoved - false if the Rook has not moved yet */
 
 class Rook : public Piece {
@@ -22,7 +22,7 @@ public:
   // ---------- Contructors, destructors and operator overloads ----------------
 
   /* Constructs a Rook object with colour and board set to the input variables,
-     name set to "Rook" and hasMoved set to false.*/
+     type set to RookType and hasMoved set to false.*/
   Rook(Player colour, ChessBoard& board);
 
   /* Constructs a Rook object which is a copy of the input Rook object, except
@@ -47,10 +47,11 @@ public:
 
   // ---------- Other functions ------------------------------------------------
 
-  /* Returns a Piece pointer to a copy of the Rook object on which this function
-     is called, but with the ChessBoard reference of the new object set to the 
+  /* Constructs a copy of the Rook object on which this function is called in
+     storage, a PieceArena slot of the board input, and returns a Piece
+     pointer to it. The ChessBoard reference of the new object is set to the
      board input. */
-  Piece* copyPiece(ChessBoard& board) override;
+  Piece* copyPiece(ChessBoard& board, void* storage) override;
 };
 
 #endif
@@ -0,0 +1,250 @@
+/* This file contains the member functions of the SanPosition class and the
+   functions which write and read whole lines of moves in SAN. */
+
+#include "San.h"
+#include "GameState.h"
+#include "Bitboard.h"
+#include "PieceType.h"
+#include "Move.h"
+#include "errors.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Letters of the PieceTypes in SAN. Pawns have no letter.
+const char SAN_LETTERS[] = " NBRQK";
+
+const string KINGSIDE_CASTLE_SAN = "O-O";
+const string QUEENSIDE_CASTLE_SAN = "O-O-O";
+
+/* Adds the square with the input index to san, e.g. "e4". */
+static void appendSquare(string& san, int squareIndex) {
+  san += static_cast<char>('a' + fileOf(squareIndex));
+  san += static_cast<char>('1' + rankOf(squareIndex));
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+SanPosition::SanPosition(GameState const& state) : state(state) {
+  moveCount = state.getLegalMoves(moves);
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+GameState const& SanPosition::getState() const {
+  return state;
+}
+
+int SanPosition::getMoveCount() const {
+  return moveCount;
+}
+
+Move const* SanPosition::getMoves() const {
+  return moves;
+}
+
+string SanPosition::toSan(Move move) const {
+  GameState next = state;
+  next.playMove(move);
+  bool isCheck = next.isInCheck(next.getPlayer());
+  Move nextMoves[MAX_MOVES];
+  bool isMate = (isCheck && next.getLegalMoves(nextMoves) == 0);
+  return write(move, isCheck, isMate);
+}
+
+string SanPosition::toSan(Move move, SanPosition const& next) const {
+  bool isCheck = next.state.isInCheck(next.state.getPlayer());
+  return write(move, isCheck, isCheck && next.moveCount == 0);
+}
+
+Move SanPosition::parseSan(string const& san) const {
+  // Leave out the check, checkmate and annotation marks
+  size_t length = san.size();
+  while (length > 0 && string{"+#!?"}.find(san[length - 1]) != string::npos) {
+    length--;
+  }
+  string text = san.substr(0, length);
+  for (char& c : text) {
+    if (c == '0') {
+      c = 'O';
+    }
+  }
+
+  if (text == KINGSIDE_CASTLE_SAN || text == QUEENSIDE_CASTLE_SAN) {
+    bool isKingside = (text == KINGSIDE_CASTLE_SAN);
+    for (int i = 0; i < moveCount; i++) {
+      if (moves[i].isCastle() && moves[i].isKingsideCastle() == isKingside) {
+	return moves[i];
+      }
+    }
+    throw SanError{san, "the player cannot castle that way"};
+  }
+
+  // The form is [Piece letter][source file][source rank][x]destination
+  PieceType type = PawnType;
+  size_t i = 0;
+  size_t letter = (length > 0) ? string{SAN_LETTERS}.find(text[0]) :
+    string::npos;
+  if (letter != string::npos && letter > 0) {
+    type = static_cast<PieceType>(letter);
+    i++;
+  }
+  if (length < i + 2) {
+    throw SanError{san, "there is no destination square"};
+  }
+  char destinationFile = text[length - 2];
+  char destinationRank = text[length - 1];
+  if (destinationFile < 'a' || destinationFile > 'h' ||
+      destinationRank < '1' || destinationRank > '8') {
+    throw SanError{san, "there is no destination square"};
+  }
+  int destination = squareAt(destinationRank - '1', destinationFile - 'a');
+
+  int sourceFile = -1;
+  int sourceRank = -1;
+  bool isCapture = false;
+  for (; i < length - 2; i++) {
+    char c = text[i];
+    if (c >= 'a' && c <= 'h' && sourceFile < 0 && !isCapture) {
+      sourceFile = c - 'a';
+    } else if (c >= '1' && c <= '8' && sourceRank < 0 && !isCapture) {
+      sourceRank = c - '1';
+    } else if (c == 'x' && !isCapture) {
+      isCapture = true;
+    } else {
+      throw SanError{san, "it is not written in SAN"};
+    }
+  }
+
+  // A Pawn only leaves its file when it takes, and then the file it came
+  // from is always written
+  if (type == PawnType && sourceFile < 0) {
+    sourceFile = fileOf(destination);
+  }
+
+  int matchCount = 0;
+  Move match;
+  for (int j = 0; j < moveCount; j++) {
+    int source = moves[j].getSourceIndex();
+    if (moves[j].isCastle() || moves[j].getDestinationIndex() != destination ||
+	(sourceFile >= 0 && fileOf(source) != sourceFile) ||
+	(sourceRank >= 0 && rankOf(source) != sourceRank) ||
+	state.getPieceType(source) != type) {
+      continue;
+    }
+    match = moves[j];
+    matchCount++;
+  }
+  if (matchCount == 0) {
+    throw SanError{san, "no Piece can make it"};
+  }
+  if (matchCount > 1) {
+    throw SanError{san, "more than one Piece can make it"};
+  }
+  return match;
+}
+
+// ---------- Checker functions ------------------------------------------------
+
+bool SanPosition::isLegal(Move move) const {
+  for (int i = 0; i < moveCount; i++) {
+    if (moves[i] == move) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void SanPosition::playMove(Move move) {
+  state.playMove(move);
+  moveCount = state.getLegalMoves(moves);
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+string SanPosition::write(Move move, bool isCheck, bool isMate) const {
+  string san;
+  if (move.isCastle()) {
+    san = (move.isKingsideCastle()) ? KINGSIDE_CASTLE_SAN :
+      QUEENSIDE_CASTLE_SAN;
+  } else {
+    int source = move.getSourceIndex();
+    int destination = move.getDestinationIndex();
+    PieceType type = state.getPieceType(source);
+    bool isCapture = (state.getOccupied() & squareBit(destination)) != 0;
+
+    if (type == PawnType) {
+      if (isCapture) {
+	san += static_cast<char>('a' + fileOf(source));
+      }
+    } else {
+      san += SAN_LETTERS[type];
+
+      // If another Piece of the same type can reach the destination, add
+      // the file the Piece comes from, or the rank if that is the same, or
+      // both if each of them is shared with another Piece
+      bool isAmbiguous = false;
+      bool isFileShared = false;
+      bool isRankShared = false;
+      for (int i = 0; i < moveCount; i++) {
+	int otherSource = moves[i].getSourceIndex();
+	if (moves[i].getDestinationIndex() != destination ||
+	    otherSource == source || moves[i].isCastle() ||
+	    state.getPieceType(otherSource) != type) {
+	  continue;
+	}
+	isAmbiguous = true;
+	isFileShared = isFileShared || fileOf(otherSource) == fileOf(source);
+	isRankShared = isRankShared || rankOf(otherSource) == rankOf(source);
+      }
+      if (isAmbiguous && (!isFileShared || isRankShared)) {
+	san += static_cast<char>('a' + fileOf(source));
+      }
+      if (isAmbiguous && isFileShared) {
+	san += static_cast<char>('1' + rankOf(source));
+      }
+    }
+
+    if (isCapture) {
+      san += 'x';
+    }
+    appendSquare(san, destination);
+  }
+
+  if (isMate) {
+    san += '#';
+  } else if (isCheck) {
+    san += '+';
+  }
+  return san;
+}
+
+// ---------- Functions --------------------------------------------------------
+
+vector<string> toSanLine(GameState const& state, vector<Move> const& moves) {
+  vector<string> sans;
+  sans.reserve(moves.size());
+  SanPosition position{state};
+  for (Move const& move : moves) {
+    SanPosition next = position;
+    next.playMove(move);
+    sans.push_back(position.toSan(move, next));
+    position = next;
+  }
+  return sans;
+}
+
+vector<Move> parseSanLine(GameState const& state, vector<string> const& sans) {
+  vector<Move> moves;
+  moves.reserve(sans.size());
+  SanPosition position{state};
+  for (string const& san : sans) {
+    Move move = position.parseSan(san);
+    moves.push_back(move);
+    position.playMove(move);
+  }
+  return moves;
+}
@@ -0,0 +1,87 @@
+#ifndef SAN_H
+#define SAN_H
+
+#include "GameState.h"
+#include "Move.h"
+#include <string>
+#include <vector>
+
+/* The SanPosition class holds a GameState together with its legal moves,
+   so that moves can be written in and read from Standard Algebraic
+   Notation (SAN), e.g. "e4", "Nf3", "exd5", "Rad1", "O-O" or "Qh5#". The
+   legal moves are generated once, when the position is set, and every
+   move written or read in the position uses that one list, both to find
+   the move and to see whether another Piece of the same type could also
+   reach the destination. The rules have no promotion or en passant, so
+   SAN for them is never written and is refused when read. */
+
+class SanPosition {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a SanPosition object for the input position and generates
+     its legal moves. */
+  SanPosition(GameState const& state);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the position. */
+  GameState const& getState() const;
+
+  /* Returns the number of legal moves in the position. */
+  int getMoveCount() const;
+
+  /* Returns the legal moves, in the order of GameState::getLegalMoves(). */
+  Move const* getMoves() const;
+
+  /* Returns move, which must be one of the legal moves, in SAN. The "+" or
+     "#" suffix is worked out by making the move on a copy of the position.
+     The legal moves after it are only generated if the move gives check,
+     to tell check from checkmate. */
+  std::string toSan(Move move) const;
+
+  /* Returns move in SAN, as above, where next is the position after the
+     move. Its list of legal moves gives the suffix, so nothing is
+     generated. This is the version to use when writing a whole game. */
+  std::string toSan(Move move, SanPosition const& next) const;
+
+  /* Returns the legal move written as san. Either "O" or "0" can be used
+     for castles, and any "+", "#", "!" or "?" at the end is ignored. If san
+     is not the SAN of exactly one legal move, the function throws the
+     SanError exception defined in the "errors.h" file. */
+  Move parseSan(std::string const& san) const;
+
+  // ---------- Checker functions ----------------------------------------------
+
+  /* Checks if move is one of the legal moves. */
+  bool isLegal(Move move) const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Makes move, which must be one of the legal moves, and generates the
+     legal moves of the new position. */
+  void playMove(Move move);
+
+private:
+  GameState state;
+  Move moves[MAX_MOVES];
+  int moveCount = 0;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Returns move in SAN, with the suffix for isCheck and isMate. */
+  std::string write(Move move, bool isCheck, bool isMate) const;
+};
+
+/* Returns the SAN of each of moves, played in order from state. The legal
+   moves of each position are generated once, for both the disambiguation
+   of the move made from it and the suffix of the move made into it. */
+std::vector<std::string> toSanLine(GameState const& state,
+				   std::vector<Move> const& moves);
+
+/* Returns the moves written in sans, read in order from state. Throws the
+   SanError exception if one of them is not the SAN of a legal move. */
+std::vector<Move> parseSanLine(GameState const& state,
+			       std::vector<std::string> const& sans);
+
+#endif
@@ -0,0 +1,289 @@
+/* This file contains the member functions of the Search class. */
+
+#include "Search.h"
+#include "ChessBoard.h"
+#include "Move.h"
+#include "Player.h"
+#include "TranspositionTable.h"
+#include "TimeManager.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/* Mate scores count plies from the root, but the TranspositionTable holds
+   them counted from the position itself, so that they are right wherever
+   the position is reached. These functions convert between the two. */
+
+static int scoreToTable(int score, int ply) {
+  if (score > MATE_SCORE - MAX_DEPTH) {
+    return score + ply;
+  }
+  if (score < -MATE_SCORE + MAX_DEPTH) {
+    return score - ply;
+  }
+  return score;
+}
+
+static int scoreFromTable(int score, int ply) {
+  if (score > MATE_SCORE - MAX_DEPTH) {
+    return score - ply;
+  }
+  if (score < -MATE_SCORE + MAX_DEPTH) {
+    return score + ply;
+  }
+  return score;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Search::Search(size_t tableMegabytes) : table(tableMegabytes) {}
+
+Search::~Search() {}
+
+// ---------- Getter functions -------------------------------------------------
+
+int Search::getHashfull() const {
+  return table.getHashfull();
+}
+
+// ---------- Setter functions -------------------------------------------------
+
+void Search::setCallback(SearchCallback callback) {
+  this->callback = callback;
+}
+
+void Search::setTableSize(size_t megabytes) {
+  table.resize(megabytes);
+}
+
+// ---------- Other functions --------------------------------------------------
+
+SearchResult Search::run(ChessBoard const& board, SearchLimits limits) {
+  timer.start(limits.clock);
+  SearchResult result;
+  nodes = 0;
+  nodeLimit = limits.nodes;
+  stopFlag = limits.stopFlag;
+  isStopped = false;
+
+  // Moves are made and taken back on one copy of the board
+  ChessBoard root{board};
+  vector<Move> moves = root.getLegalMoves();
+  if (moves.empty()) {
+    result.score = (root.isInCheck()) ? -MATE_SCORE : 0;
+    return result;
+  }
+  TableEntry entry;
+  bool isInTable = table.probe(root.getHash(), entry);
+  orderMoves(root, moves, entry.move, isInTable && entry.hasMove);
+
+  int lineCount = max(1, min(limits.multiPv, static_cast<int>(moves.size())));
+  for (int depth = 1; depth <= min(limits.depth, MAX_DEPTH); depth++) {
+    int beta = MATE_SCORE + 1;
+
+    // The best lineCount moves found so far at this depth with their
+    // scores, best first. A move only needs an exact score if it would be
+    // one of them, so the last of their scores is the lower bound.
+    vector<pair<int, Move>> best;
+    for (Move const& move : moves) {
+      int alpha = (static_cast<int>(best.size()) < lineCount) ?
+	-MATE_SCORE - 1 : best.back().first;
+      root.playMove(move);
+      int score = -searchPosition(root, depth - 1, -beta, -alpha, 1);
+      root.takeback();
+      if (isStopped) {
+	break;
+      }
+      if (score > alpha) {
+	auto place = find_if(best.begin(), best.end(),
+			     [score](pair<int, Move> const& line) {
+			       return line.first < score;
+			     });
+	best.insert(place, {score, move});
+	if (static_cast<int>(best.size()) > lineCount) {
+	  best.pop_back();
+	}
+      }
+    }
+    Move bestMove = (best.empty()) ? moves[0] : best[0].second;
+    int bestScore = (best.empty()) ? -MATE_SCORE - 1 : best[0].first;
+
+    // Only use the result of a search that was not cut short, unless
+    // there is no result yet
+    if (isStopped && result.hasBestMove) {
+      break;
+    }
+    result.bestMove = bestMove;
+    result.hasBestMove = true;
+    result.score = bestScore;
+    result.depth = (isStopped) ? depth - 1 : depth;
+    if (isStopped) {
+      result.principalVariation = {bestMove};
+      result.lines = {SearchLine{bestScore, {bestMove}}};
+      for (size_t i = 1; i < best.size(); i++) {
+	result.lines.push_back({best[i].first, {best[i].second}});
+      }
+      break;
+    }
+
+    table.store(root.getHash(), bestMove, true, scoreToTable(bestScore, 0),
+		depth, ExactScore);
+    result.lines = getLines(root, best, depth);
+    result.principalVariation = result.lines[0].moves;
+    result.nodes = nodes;
+    result.milliseconds = timer.getElapsed();
+    if (callback) {
+      callback(result);
+    }
+
+    timer.update(depth > 1 && !(bestMove == moves[0]));
+    if (timer.isSoftDeadlinePassed()) {
+      break;
+    }
+
+    // Search the best moves first at the next depth, in order
+    for (auto line = best.rbegin(); line != best.rend(); line++) {
+      auto found = find(moves.begin(), moves.end(), line->second);
+      rotate(moves.begin(), found, found + 1);
+    }
+  }
+
+  result.nodes = nodes;
+  result.milliseconds = timer.getElapsed();
+  return result;
+}
+
+void Search::clearTable() {
+  table.clear();
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+int Search::searchPosition(ChessBoard& board, int depth, int alpha, int beta,
+			   int ply) {
+  nodes++;
+  if ((nodeLimit > 0 && nodes >= nodeLimit) ||
+      (stopFlag != nullptr && stopFlag->load(memory_order_relaxed)) ||
+      timer.isHardDeadlinePassed(nodes)) {
+    isStopped = true;
+    return 0;
+  }
+
+  // A position that has occurred before is scored as a draw, since the
+  // side that is better off would not have let it repeat
+  if (board.isRepetition()) {
+    return 0;
+  }
+
+  // Use the score from the table if the position has already been searched
+  // deep enough
+  HashKey key = board.getHash();
+  TableEntry entry;
+  bool isInTable = table.probe(key, entry);
+  if (isInTable && entry.depth >= depth) {
+    int score = scoreFromTable(entry.score, ply);
+    if (entry.bound == ExactScore ||
+	(entry.bound == LowerBound && score >= beta) ||
+	(entry.bound == UpperBound && score <= alpha)) {
+      return score;
+    }
+  }
+
+  vector<Move> moves = board.getLegalMoves();
+  if (moves.empty()) {
+    return (board.isInCheck()) ? -MATE_SCORE + ply : 0;
+  }
+  if (board.isFiftyMoveRuleDraw()) {
+    return 0;
+  }
+  if (depth <= 0) {
+    return evaluate(board);
+  }
+  orderMoves(board, moves, entry.move, isInTable && entry.hasMove);
+
+  int originalAlpha = alpha;
+  Move bestMove = moves[0];
+  for (Move const& move : moves) {
+    board.playMove(move);
+    int score = -searchPosition(board, depth - 1, -beta, -alpha, ply + 1);
+    board.takeback();
+    if (isStopped) {
+      return 0;
+    }
+    if (score >= beta) {
+      table.store(key, move, true, scoreToTable(beta, ply), depth, LowerBound);
+      return beta;
+    }
+    if (score > alpha) {
+      alpha = score;
+      bestMove = move;
+    }
+  }
+
+  // If no move reached alpha then none of them is known to be best
+  bool isExact = (alpha > originalAlpha);
+  table.store(key, bestMove, isExact, scoreToTable(alpha, ply), depth,
+	      (isExact) ? ExactScore : UpperBound);
+  return alpha;
+}
+
+int Search::evaluate(ChessBoard const& board) const {
+  Player player = board.getPlayer();
+  return board.getMaterial(player) - board.getMaterial(!player);
+}
+
+void Search::orderMoves(ChessBoard const& board, vector<Move>& moves,
+			Move hashMove, bool hasHashMove) const {
+  stable_partition(moves.begin(), moves.end(), [&](Move const& move) {
+    return !move.isCastle() && board.isPieceThere(move.getDestination());
+  });
+  if (hasHashMove) {
+    auto found = find(moves.begin(), moves.end(), hashMove);
+    if (found != moves.end()) {
+      rotate(moves.begin(), found, found + 1);
+    }
+  }
+}
+
+vector<SearchLine> Search::getLines(ChessBoard& board,
+				    vector<pair<int, Move>> const& best,
+				    int depth) const {
+  vector<SearchLine> lines;
+  for (pair<int, Move> const& line : best) {
+    board.playMove(line.second);
+    vector<Move> moves = {line.second};
+    if (!board.isRepetition()) {
+      vector<Move> rest = getPrincipalVariation(board, depth - 1);
+      moves.insert(moves.end(), rest.begin(), rest.end());
+    }
+    board.takeback();
+    lines.push_back({line.first, moves});
+  }
+  return lines;
+}
+
+vector<Move> Search::getPrincipalVariation(ChessBoard& board,
+					   int depth) const {
+  vector<Move> line;
+  TableEntry entry;
+  while (static_cast<int>(line.size()) < depth &&
+	 table.probe(board.getHash(), entry) && entry.hasMove) {
+    // A different position with the same hash could have left a move that
+    // is not legal here
+    vector<Move> moves = board.getLegalMoves();
+    if (find(moves.begin(), moves.end(), entry.move) == moves.end()) {
+      break;
+    }
+    line.push_back(entry.move);
+    board.playMove(entry.move);
+    if (board.isRepetition()) {
+      break;
+    }
+  }
+  for (size_t i = 0; i < line.size(); i++) {
+    board.takeback();
+  }
+  return line;
+}
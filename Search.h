@@ -0,0 +1,171 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "ChessBoard.h"
+#include "Move.h"
+#include "TranspositionTable.h"
+#include "TimeManager.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Score of a checkmate, in centipawns. Checkmates found further from the 
+// root score one less for each extra ply.
+const int MATE_SCORE = 100000;
+
+// Deepest a Search can go. Scores within MAX_DEPTH of MATE_SCORE are
+// checkmates.
+const int MAX_DEPTH = 64;
+
+// Default size of the TranspositionTable of a Search, in megabytes
+const std::size_t DEFAULT_TABLE_MEGABYTES = 16;
+
+/* The SearchLimits struct tells a Search when to stop.
+   depth is the number of plies to search to.
+   nodes is the most positions the Search may visit, or 0 for no limit.
+   clock is the time the Search may take, worked out by a TimeManager. If
+   it has a clock the Search still stops at the depth limit, which should
+   be set to MAX_DEPTH to only stop on time.
+   stopFlag, if it is not null, points to a flag that another thread can
+   set to stop the Search as soon as possible. It is owned by the caller and
+   must outlive the Search.
+   multiPv is the number of best moves to find at the root, each with its
+   own score and line of best play. */
+
+struct SearchLimits {
+  int depth = 3;
+  long long nodes = 0;
+  TimeControl clock;
+  std::atomic<bool> const* stopFlag = nullptr;
+  int multiPv = 1;
+};
+
+/* The SearchLine struct holds one of the best moves found at the root.
+   score is its value in centipawns for the player to move.
+   moves is the line of best play found, starting with the move. */
+
+struct SearchLine {
+  int score = 0;
+  std::vector<Move> moves;
+};
+
+/* The SearchResult struct holds the outcome of a Search.
+   bestMove is the best move found, and is only set if hasBestMove is true,
+   i.e. if the player to move has a legal move.
+   score is the value of the position in centipawns for the player to move.
+   depth is the depth of the last search which was completed.
+   nodes is the number of positions visited.
+   milliseconds is the time the Search has taken so far.
+   principalVariation is the line of best play found, starting with 
+   bestMove.
+   lines holds the best SearchLimits::multiPv moves, or every move if there
+   are fewer, best first. The first is bestMove, with score and
+   principalVariation. */
+
+struct SearchResult {
+  Move bestMove;
+  bool hasBestMove = false;
+  int score = 0;
+  int depth = 0;
+  long long nodes = 0;
+  long long milliseconds = 0;
+  std::vector<Move> principalVariation;
+  std::vector<SearchLine> lines;
+};
+
+/* The SearchCallback type is a function called by a Search each time it
+   finishes a depth, with the result so far. */
+typedef std::function<void(SearchResult const&)> SearchCallback;
+
+/* The Search class finds the best move in a position with an alpha-beta 
+   search. It searches to depth 1, then depth 2, and so on until it reaches
+   the depth limit, the node limit or a deadline of its TimeManager, or is
+   stopped. Positions are scored by the difference in material, and
+   repeated positions and fifty-move rule draws score 0. With a multiPv of
+   k, each depth searches every root move once, with the k-th best score
+   found so far as its lower bound, so only moves which could be among the
+   best k get an exact score, and the rest are cut off as with one line.
+   What is found about each position is kept in a TranspositionTable,
+   which is reused by later searches, so that positions reached again are
+   not searched again and the best move found before is tried first. A
+   Search object can be reused for any number of positions but must only be
+   used by one thread at a time. */
+
+class Search {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a Search object with a TranspositionTable of at most the 
+     input number of megabytes. */
+  Search(std::size_t tableMegabytes = DEFAULT_TABLE_MEGABYTES);
+
+  /* Destructor. */
+  ~Search();
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns how full the TranspositionTable is, in entries per thousand. */
+  int getHashfull() const;
+
+  // ---------- Setter functions -----------------------------------------------
+
+  /* Sets the function called after each depth is finished. */
+  void setCallback(SearchCallback callback);
+
+  /* Empties the TranspositionTable and changes its size to at most the 
+     input number of megabytes. */
+  void setTableSize(std::size_t megabytes);
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Searches the position on the board, which is not changed, and returns
+     the best move found within the limits. */
+  SearchResult run(ChessBoard const& board, SearchLimits limits);
+
+  /* Empties the TranspositionTable, e.g. before a new game. */
+  void clearTable();
+
+private:
+  TranspositionTable table;
+  TimeManager timer;
+  SearchCallback callback;
+  long long nodes = 0;
+  long long nodeLimit = 0;
+  std::atomic<bool> const* stopFlag = nullptr;
+  bool isStopped = false;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Returns the score of the position on the board for the player to move,
+     searched to the input depth. ply is the distance from the root. Sets 
+     isStopped and returns 0 if the node limit or the hard deadline is
+     reached or the stop flag is set. Each move is made on the board and
+     taken back, so the board ends up as it was. */
+  int searchPosition(ChessBoard& board, int depth, int alpha, int beta,
+		     int ply);
+
+  /* Returns the score of the position without searching any further. */
+  int evaluate(ChessBoard const& board) const;
+
+  /* Puts hashMove, if hasHashMove is true, at the front of moves, followed
+     by the captures, because they are the most likely to cause a cutoff. */
+  void orderMoves(ChessBoard const& board, std::vector<Move>& moves,
+		  Move hashMove, bool hasHashMove) const;
+
+  /* Returns the SearchLine of each move in best, which holds the best moves
+     of a finished depth and their scores, best first. Each line is its move
+     followed by the line of best play after it. The board ends up as it
+     was. */
+  std::vector<SearchLine> getLines(
+    ChessBoard& board, std::vector<std::pair<int, Move>> const& best,
+    int depth) const;
+
+  /* Returns the line of best play from the position on the board, following
+     the best moves in the TranspositionTable for at most depth moves. The
+     board ends up as it was. */
+  std::vector<Move> getPrincipalVariation(ChessBoard& board, int depth) const;
+};
+
+#endif
@@ -0,0 +1,206 @@
+/* This file contains the member functions of the SelfPlay class, and the
+   functions which read openings and work out Elo differences. */
+
+#include "SelfPlay.h"
+#include "ChessBoard.h"
+#include "Search.h"
+#include "GameStatus.h"
+#include "Player.h"
+#include "constants.h"
+#include "errors.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Number of standard errors either side of the score which the 95%
+// confidence interval covers
+static const double CONFIDENCE_Z = 1.96;
+
+// ---------- Functions --------------------------------------------------------
+
+double getEloDifference(double score) {
+  if (score <= 0.0) {
+    return -numeric_limits<double>::infinity();
+  }
+  if (score >= 1.0) {
+    return numeric_limits<double>::infinity();
+  }
+  // Written so that an even score gives 0 rather than -0
+  return 400.0 * log10(score / (1.0 - score));
+}
+
+double getEloErrorMargin(TournamentResult const& result) {
+  int gameCount = result.wins + result.draws + result.losses;
+  if (gameCount == 0) {
+    return numeric_limits<double>::infinity();
+  }
+  // Every game was won or every game was lost, so the difference could be
+  // any size
+  double score = getScore(result);
+  if (score <= 0.0 || score >= 1.0) {
+    return numeric_limits<double>::infinity();
+  }
+  double variance = 0.0;
+  for (SelfPlayGame const& game : result.games) {
+    variance += (game.score - score) * (game.score - score);
+  }
+
+  // Likewise if every game was drawn: the games show no spread, which
+  // says nothing about how wide the interval really is
+  if (variance == 0.0) {
+    return numeric_limits<double>::infinity();
+  }
+  double standardError = sqrt(variance / gameCount / gameCount);
+  return (getEloDifference(score + CONFIDENCE_Z * standardError) -
+	  getEloDifference(score - CONFIDENCE_Z * standardError)) / 2.0;
+}
+
+double getScore(TournamentResult const& result) {
+  int gameCount = result.wins + result.draws + result.losses;
+  if (gameCount == 0) {
+    return 0.5;
+  }
+  return (result.wins + 0.5 * result.draws) / gameCount;
+}
+
+vector<string> readOpenings(string const& fileName) {
+  ifstream file{fileName};
+  if (!file) {
+    throw OpeningsError{fileName, "could not be opened"};
+  }
+
+  vector<string> openings;
+  ChessBoard board{START_FEN};
+  string line;
+  int lineNumber = 0;
+  while (getline(file, line)) {
+    lineNumber++;
+    istringstream fields{line};
+    string placement, side, castling, enPassant;
+    if (!(fields >> placement) || placement[0] == '#') {
+      continue;
+    }
+    fields >> side >> castling >> enPassant;
+
+    // The halfmove clock is not part of an EPD position, so it starts at 0
+    string fen = placement + " " + side + " " + castling + " " + enPassant;
+    try {
+      board.setPosition(fen);
+    } catch (FenError const& e) {
+      throw OpeningsError{fileName, "line " + to_string(lineNumber) + ": " +
+			  e.what()};
+    }
+    openings.push_back(fen);
+  }
+  if (openings.empty()) {
+    throw OpeningsError{fileName, "has no positions in it"};
+  }
+  return openings;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+SelfPlay::SelfPlay(vector<string> const& openings, SearchLimits first,
+		   SearchLimits second, int threadCount)
+  : openings(openings), limits{first, second}, threadCount(threadCount) {
+  if (this->threadCount < 1) {
+    this->threadCount = static_cast<int>(thread::hardware_concurrency());
+  }
+  if (this->threadCount < 1) {
+    this->threadCount = 1;
+  }
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+int SelfPlay::getThreadCount() const {
+  return threadCount;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+TournamentResult SelfPlay::play(int gameCount) {
+  TournamentResult result;
+  if (gameCount < 1 || openings.empty()) {
+    return result;
+  }
+  result.games.resize(gameCount);
+
+  // The only thing the threads share is the index of the next game, and
+  // each one writes the outcome of its games to their own elements
+  atomic<int> nextGame{0};
+  auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (int i = 0; i < threadCount && i < gameCount; i++) {
+    threads.emplace_back([&] {
+      ChessBoard board{START_FEN};
+      Search searches[2] = {Search{SELFPLAY_TABLE_MEGABYTES},
+			    Search{SELFPLAY_TABLE_MEGABYTES}};
+      int index;
+      while ((index = nextGame.fetch_add(1)) < gameCount) {
+	result.games[index] = playGame(index, board, searches);
+      }
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  result.milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  for (SelfPlayGame const& game : result.games) {
+    if (game.score == 1.0) {
+      result.wins++;
+    } else if (game.score == 0.0) {
+      result.losses++;
+    } else {
+      result.draws++;
+    }
+    result.nodes += game.nodes;
+  }
+  return result;
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+SelfPlayGame SelfPlay::playGame(int index, ChessBoard& board,
+				Search searches[2]) const {
+  SelfPlayGame game;
+  game.opening = (index / 2) % static_cast<int>(openings.size());
+  game.isFirstWhite = (index % 2 == 0);
+  board.setPosition(openings[game.opening]);
+  searches[0].clearTable();
+  searches[1].clearTable();
+
+  while (true) {
+    game.ending = board.getStatus();
+    if (isGameOver(game.ending)) {
+      break;
+    }
+    if (game.plies == SELFPLAY_MAX_PLIES) {
+      game.ending = InProgress;
+      break;
+    }
+    int engine = ((board.getPlayer() == White) == game.isFirstWhite) ? 0 : 1;
+    SearchResult search = searches[engine].run(board, limits[engine]);
+    game.nodes += search.nodes;
+    board.playMove(search.bestMove);
+    game.plies++;
+  }
+
+  // The player to move has lost if they are checkmated, and every other
+  // ending is a draw
+  if (game.ending == Checkmate) {
+    bool isFirstToMove = ((board.getPlayer() == White) == game.isFirstWhite);
+    game.score = (isFirstToMove) ? 0.0 : 1.0;
+  }
+  return game;
+}
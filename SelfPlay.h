@@ -0,0 +1,123 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "ChessBoard.h"
+#include "Search.h"
+#include "GameStatus.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Size of the TranspositionTable of each engine in each game, in megabytes.
+// It is kept small because every thread has two of them.
+const std::size_t SELFPLAY_TABLE_MEGABYTES = 2;
+
+// Most plies a game may last. A game which is still going after this many
+// is scored as a draw.
+const int SELFPLAY_MAX_PLIES = 400;
+
+/* The SelfPlayGame struct holds the outcome of one game of a tournament.
+   opening is the index of the opening it was started from.
+   isFirstWhite is true if the first engine had the White pieces.
+   score is the first engine's score: 1 for a win, 0.5 for a draw and 0 for
+   a loss.
+   ending is the status the game finished with, or InProgress if it was
+   still going after SELFPLAY_MAX_PLIES plies.
+   plies is the number of moves made by both engines.
+   nodes is the number of positions both engines visited. */
+
+struct SelfPlayGame {
+  int opening = 0;
+  bool isFirstWhite = true;
+  double score = 0.5;
+  GameStatus ending = InProgress;
+  int plies = 0;
+  long long nodes = 0;
+};
+
+/* The TournamentResult struct holds the outcome of a tournament.
+   wins, draws and losses are counted for the first engine.
+   nodes is the number of positions visited in every game.
+   milliseconds is the time the whole tournament took, so nodes per
+   millisecond is the throughput of all the threads together.
+   games holds every game, in the order they were handed out. */
+
+struct TournamentResult {
+  int wins = 0;
+  int draws = 0;
+  int losses = 0;
+  long long nodes = 0;
+  long long milliseconds = 0;
+  std::vector<SelfPlayGame> games;
+};
+
+/* Returns the Elo difference between the first engine and the second that
+   the input score, as a fraction of the points available, corresponds to.
+   A score of 0 or 1 gives minus or plus infinity. */
+double getEloDifference(double score);
+
+/* Returns the half width of the 95% confidence interval of the Elo
+   difference of the result, worked out from the spread of the scores of
+   its games. If every game had the same result, e.g. every game was drawn,
+   there is no spread to work from and infinity is returned. */
+double getEloErrorMargin(TournamentResult const& result);
+
+/* Returns the first engine's score in the result, as a fraction of the
+   points available. */
+double getScore(TournamentResult const& result);
+
+/* Reads the openings in the Extended Position Description file with the
+   input name, one position per line. Only the first four fields of a line,
+   i.e. the pieces, the player to move, the castling rights and the en
+   passant square, are used, and any operations after them are skipped, as
+   are empty lines and lines starting with '#'. Throws the OpeningsError
+   exception defined in "errors.h" if the file cannot be read, if a line is
+   not a valid position or if there are no positions in it. */
+std::vector<std::string> readOpenings(std::string const& fileName);
+
+/* The SelfPlay class plays a tournament between two engines, which are the
+   same Search with different SearchLimits, e.g. a fixed number of nodes or
+   a fixed time for each move. Each opening is played twice, once with each
+   engine as White, so that the openings do not favour either engine.
+   The games are shared out between a pool of threads. Each thread has its
+   own ChessBoard and its own Search for each engine, whose tables are
+   emptied before every game, so the games share nothing which changes and
+   the throughput grows with the number of cores. */
+
+class SelfPlay {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a SelfPlay object which plays games from openings, which are
+     in Forsyth-Edwards Notation, between an engine searching within first
+     and one searching within second, with threadCount threads. If
+     threadCount is less than 1, one thread is used for every core. */
+  SelfPlay(std::vector<std::string> const& openings, SearchLimits first,
+	   SearchLimits second, int threadCount = 0);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of threads the games are played on. */
+  int getThreadCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Plays gameCount games and returns their outcome. Game i starts from
+     opening i / 2, going round the openings again if there are not enough
+     of them, and the first engine is White in the even numbered games. */
+  TournamentResult play(int gameCount);
+
+private:
+  std::vector<std::string> openings;
+  SearchLimits limits[2];
+  int threadCount;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Plays game number index on board, with searches[0] for the first engine
+     and searches[1] for the second, and returns its outcome. */
+  SelfPlayGame playGame(int index, ChessBoard& board,
+			Search searches[2]) const;
+};
+
+#endif
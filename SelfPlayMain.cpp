@@ -0,0 +1,117 @@
+/* This file contains the main function of the selfplay tool, which plays a
+   tournament between two settings of the engine and prints the score of
+   the first against the second. Usage:
+   >> selfplay openings.epd 200 nodes=20000 nodes=10000
+   >> selfplay openings.epd 100 movetime=50 movetime=50 8
+   The inputs are the file of openings, in Extended Position Description,
+   the number of games, the limit of each engine, as "nodes=<n>" for a
+   fixed number of positions per move or "movetime=<ms>" for a fixed time
+   per move, and the number of threads. If the number of threads is left
+   out, one thread is used for every core. */
+
+#include "SelfPlay.h"
+#include "Search.h"
+#include "errors.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Reads the limit of an engine from input, which is "nodes=<n>" or
+   "movetime=<ms>", into limits. Returns false if input is neither. */
+static bool readLimits(string const& input, SearchLimits& limits) {
+  size_t equals = input.find('=');
+  if (equals == string::npos) {
+    return false;
+  }
+  string name = input.substr(0, equals);
+  long long value = 0;
+  try {
+    value = stoll(input.substr(equals + 1));
+  } catch (exception const& e) {
+    return false;
+  }
+  if (value < 1) {
+    return false;
+  }
+
+  limits.depth = MAX_DEPTH;
+  if (name == "nodes") {
+    limits.nodes = value;
+  } else if (name == "movetime") {
+    limits.clock.moveTime = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 5 || argc > 6) {
+    cerr << "Usage: selfplay <openings file> <games> <first limit> ";
+    cerr << "<second limit> [threads]" << endl;
+    cerr << "A limit is nodes=<n> or movetime=<ms>" << endl;
+    return 1;
+  }
+
+  vector<string> openings;
+  try {
+    openings = readOpenings(argv[1]);
+  } catch (OpeningsError const& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  int gameCount = 0;
+  try {
+    gameCount = stoi(argv[2]);
+  } catch (exception const& e) {
+    gameCount = 0;
+  }
+  if (gameCount < 1) {
+    cerr << "The number of games must be a positive number!" << endl;
+    return 1;
+  }
+
+  SearchLimits limits[2];
+  for (int i = 0; i < 2; i++) {
+    if (!readLimits(argv[3 + i], limits[i])) {
+      cerr << argv[3 + i] << " is not nodes=<n> or movetime=<ms>!" << endl;
+      return 1;
+    }
+  }
+
+  int threadCount = 0;
+  if (argc == 6) {
+    try {
+      threadCount = stoi(argv[5]);
+    } catch (exception const& e) {
+      threadCount = 0;
+    }
+    if (threadCount < 1) {
+      cerr << "The number of threads must be a positive number!" << endl;
+      return 1;
+    }
+  }
+
+  SelfPlay selfPlay{openings, limits[0], limits[1], threadCount};
+  cout << "Playing " << gameCount << " games of " << argv[3] << " against ";
+  cout << argv[4] << " from " << openings.size() << " openings with ";
+  cout << selfPlay.getThreadCount() << " thread(s)" << endl;
+
+  TournamentResult result = selfPlay.play(gameCount);
+  double seconds = max(result.milliseconds, 1LL) / 1000.0;
+  cout << "Wins: " << result.wins << ", Draws: " << result.draws;
+  cout << ", Losses: " << result.losses << endl;
+  cout << fixed << setprecision(1) << "Score: " << 100 * getScore(result);
+  cout << "%, Elo difference: " << getEloDifference(getScore(result));
+  cout << " +/- " << getEloErrorMargin(result) << endl;
+  cout << result.nodes << " nodes in " << result.milliseconds << " ms, ";
+  cout << setprecision(0) << result.nodes / seconds << " nodes per second, ";
+  cout << setprecision(1) << gameCount / seconds << " games per second";
+  cout << endl;
+  return 0;
+}
@@ -0,0 +1,87 @@
+/* This file contains the member functions of the SessionStore class. */
+
+#include "SessionStore.h"
+#include "GameState.h"
+#include "errors.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+using namespace std;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+SessionStore::SessionStore() {}
+
+SessionStore::~SessionStore() {}
+
+// ---------- Getter functions -------------------------------------------------
+
+GameState& SessionStore::getGame(SessionId id) {
+  // Slabs are never freed or moved while the store exists, so once a slab
+  // has been counted it can be read without taking the lock
+  size_t slab = id / SLAB_SIZE;
+  if (slab >= slabCount.load(memory_order_acquire) ||
+      !isInUse[slab][id % SLAB_SIZE].load(memory_order_acquire)) {
+    throw SessionError{id};
+  }
+  return slabs[slab][id % SLAB_SIZE];
+}
+
+size_t SessionStore::getGameCount() const {
+  lock_guard<std::mutex> lock{mutex};
+  return gameCount;
+}
+
+size_t SessionStore::getCapacity() const {
+  return slabCount.load() * SLAB_SIZE;
+}
+
+size_t SessionStore::getMemoryUsage() const {
+  lock_guard<std::mutex> lock{mutex};
+  return getCapacity() * (sizeof(GameState) + sizeof(atomic<bool>)) +
+    freeIds.capacity() * sizeof(SessionId);
+}
+
+// ---------- Other functions --------------------------------------------------
+
+SessionId SessionStore::createGame() {
+  return createGame(GameState{});
+}
+
+SessionId SessionStore::createGame(GameState const& state) {
+  lock_guard<std::mutex> lock{mutex};
+  if (freeIds.empty()) {
+    size_t slab = slabCount.load();
+    if (slab == MAX_SLABS) {
+      throw bad_alloc{};
+    }
+    slabs[slab].reset(new GameState[SLAB_SIZE]);
+    isInUse[slab].reset(new atomic<bool>[SLAB_SIZE]());
+
+    // Hand out the lowest ids first
+    for (int i = SLAB_SIZE - 1; i >= 0; i--) {
+      freeIds.push_back(static_cast<SessionId>(slab * SLAB_SIZE + i));
+    }
+    slabCount.store(slab + 1, memory_order_release);
+  }
+
+  SessionId id = freeIds.back();
+  freeIds.pop_back();
+  slabs[id / SLAB_SIZE][id % SLAB_SIZE] = state;
+  isInUse[id / SLAB_SIZE][id % SLAB_SIZE].store(true, memory_order_release);
+  gameCount++;
+  return id;
+}
+
+void SessionStore::endGame(SessionId id) {
+  lock_guard<std::mutex> lock{mutex};
+  size_t slab = id / SLAB_SIZE;
+  if (slab >= slabCount.load() || !isInUse[slab][id % SLAB_SIZE].load()) {
+    throw SessionError{id};
+  }
+  isInUse[slab][id % SLAB_SIZE].store(false);
+  freeIds.push_back(id);
+  gameCount--;
+}
@@ -0,0 +1,86 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include "GameState.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* A SessionId identifies one game in a SessionStore. */
+typedef uint32_t SessionId;
+
+// Number of GameState objects in each slab, and the most slabs a
+// SessionStore can have (about 67 million games)
+const int SLAB_SIZE = 4096;
+const int MAX_SLABS = 16384;
+
+/* The SessionStore class holds a large number of games, each one a 72 byte
+   GameState. The GameStates are allocated SLAB_SIZE at a time in contiguous
+   slabs, so there is no allocation per game and no pointer per game. The 
+   slots of ended games are reused for new games.
+   Games can be created and ended from any thread. getGame() takes no lock,
+   so many threads can work on different games at once, but each game must
+   only be changed by one thread at a time. */
+
+class SessionStore {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs an empty SessionStore object. No slabs are allocated until
+     the first game is created. */
+  SessionStore();
+
+  /* Destructor. Frees all of the slabs. */
+  ~SessionStore();
+
+  SessionStore(SessionStore const&) = delete;
+  SessionStore& operator=(SessionStore const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns a reference to the game with the input id. If id is not a game
+     which is in progress, because it has never been given out by
+     createGame() or the game has been ended, then the function throws the
+     SessionError exception defined in the "errors.h" file. The reference
+     stays valid until the game is ended. */
+  GameState& getGame(SessionId id);
+
+  /* Returns the number of games which have been created and not ended. */
+  std::size_t getGameCount() const;
+
+  /* Returns the number of games the allocated slabs have room for. */
+  std::size_t getCapacity() const;
+
+  /* Returns the number of bytes allocated for the games: the slabs, the
+     in-use flag of each slot and the list of free ids. */
+  std::size_t getMemoryUsage() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Creates a new game, set up in the starting position, and returns its id.
+     If every slab is full, a new slab is allocated. */
+  SessionId createGame();
+
+  /* Creates a new game which is a copy of the input state, and returns its
+     id. */
+  SessionId createGame(GameState const& state);
+
+  /* Ends the game with the input id, so that its slot can be reused. Throws
+     the SessionError exception if id is not a game which is in progress. */
+  void endGame(SessionId id);
+
+private:
+  std::unique_ptr<GameState[]> slabs[MAX_SLABS];
+  std::atomic<std::size_t> slabCount{0};
+  // Whether each slot of each slab holds a game in progress. They are
+  // atomic so that getGame() can check them without the lock.
+  std::unique_ptr<std::atomic<bool>[]> isInUse[MAX_SLABS];
+  std::vector<SessionId> freeIds;
+  std::size_t gameCount = 0;
+  mutable std::mutex mutex;
+};
+
+#endif
@@ -0,0 +1,177 @@
+/* This file contains the main function of the sessions tool, which hosts a
+   large number of games in a SessionStore, checks that it keeps them apart
+   and reuses their ids, and compares its memory use with ChessBoard's.
+   Usage:
+   >> sessions
+   >> sessions 1000000 40 8
+   The inputs are the number of games, 20000 if it is left out, the number
+   of random moves played in each game, 40 if it is left out, and the
+   number of threads. If the number of threads is left out, one thread is
+   used for every core. The games are played on all the threads at once.
+   Then every other game is ended, and as many new games are created, which
+   must take the ids of the ended games. The program returns 1 if any check
+   fails. */
+
+#include "SessionStore.h"
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "Move.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* Plays up to plyCount random legal moves in the game with the input id,
+   through GameState::submitMove(), so that every move is checked. Returns
+   the number of moves played, or -1 if a legal move is not accepted. */
+static int playGame(SessionStore& store, SessionId id, int plyCount) {
+  mt19937 random{id};
+  GameState& game = store.getGame(id);
+  Move moves[MAX_MOVES];
+  int ply = 0;
+  for (; ply < plyCount; ply++) {
+    int moveCount = game.getLegalMoves(moves);
+    if (moveCount == 0 || isGameOver(game.getStatus())) {
+      break;
+    }
+    if (game.submitMove(moves[random() % moveCount]) != MoveAccepted) {
+      return -1;
+    }
+  }
+  return ply;
+}
+
+/* Returns whether getGame() rejects the input id. */
+static bool isRejected(SessionStore& store, SessionId id) {
+  try {
+    store.getGame(id);
+  } catch (SessionError const& e) {
+    return true;
+  }
+  return false;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 4) {
+    cerr << "Usage: sessions [games] [moves] [threads]" << endl;
+    return 1;
+  }
+
+  int gameCount = 20000;
+  int plyCount = 40;
+  int threadCount = 0;
+  try {
+    gameCount = (argc >= 2) ? stoi(argv[1]) : gameCount;
+    plyCount = (argc >= 3) ? stoi(argv[2]) : plyCount;
+    threadCount = (argc == 4) ? stoi(argv[3]) : 0;
+  } catch (exception const& e) {
+    cerr << "The games, moves and threads must be numbers!" << endl;
+    return 1;
+  }
+  if (gameCount < 2 || plyCount < 0) {
+    cerr << "There must be at least 2 games and no fewer than 0 moves!";
+    cerr << endl;
+    return 1;
+  }
+  if (threadCount < 1) {
+    threadCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+
+  SessionStore store;
+  vector<SessionId> ids(gameCount);
+  for (SessionId& id : ids) {
+    id = store.createGame();
+  }
+
+  // Each thread plays its own share of the games, reading them from the
+  // store without taking its lock
+  cout << "Playing " << gameCount << " games of " << plyCount;
+  cout << " moves with " << threadCount << " thread(s)" << endl;
+  atomic<bool> isRejectedMove{false};
+  atomic<long long> totalPlies{0};
+  auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (int t = 0; t < threadCount; t++) {
+    threads.emplace_back([&, t] {
+      long long plies = 0;
+      for (int i = t; i < gameCount; i += threadCount) {
+	int played = playGame(store, ids[i], plyCount);
+	if (played < 0) {
+	  isRejectedMove = true;
+	}
+	plies += max(played, 0);
+      }
+      totalPlies += plies;
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  long long milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+  bool isPassed = !isRejectedMove;
+  if (isRejectedMove) {
+    cout << "A legal move was not accepted" << endl;
+  }
+
+  // Measure before ending any games, while every slot is in use
+  size_t capacity = store.getCapacity();
+  size_t storeBytes = store.getMemoryUsage();
+
+  // End every other game. Their ids must be rejected from then on, and be
+  // the ones given to the next games, without any new slab.
+  vector<SessionId> endedIds;
+  for (int i = 0; i < gameCount; i += 2) {
+    store.endGame(ids[i]);
+    endedIds.push_back(ids[i]);
+  }
+  for (SessionId id : endedIds) {
+    if (!isRejected(store, id)) {
+      cout << "Game " << id << " was ended but is still given out" << endl;
+      isPassed = false;
+      break;
+    }
+  }
+  if (store.getGameCount() != ids.size() - endedIds.size()) {
+    cout << "The store counts " << store.getGameCount() << " games" << endl;
+    isPassed = false;
+  }
+  vector<SessionId> newIds;
+  for (size_t i = 0; i < endedIds.size(); i++) {
+    newIds.push_back(store.createGame());
+  }
+  sort(endedIds.begin(), endedIds.end());
+  sort(newIds.begin(), newIds.end());
+  if (newIds != endedIds || store.getCapacity() != capacity) {
+    cout << "The ids of the ended games were not reused" << endl;
+    isPassed = false;
+  }
+  if (isRejected(store, newIds[0]) ||
+      store.getGame(newIds[0]).getFen() != GameState{}.getFen()) {
+    cout << "A new game does not start from the starting position" << endl;
+    isPassed = false;
+  }
+
+  // A ChessBoard has its Pieces in its own arena and keeps a HistoryEntry
+  // for every move, in a vector which may have room for more
+  double boardGameBytes = sizeof(ChessBoard) +
+    static_cast<double>(totalPlies) * sizeof(HistoryEntry) / gameCount;
+  double storeGameBytes = static_cast<double>(storeBytes) / gameCount;
+  cout << fixed << setprecision(1);
+  cout << "SessionStore: " << storeBytes << " bytes, " << storeGameBytes;
+  cout << " bytes per game" << endl;
+  cout << "ChessBoard: at least " << boardGameBytes << " bytes per game, ";
+  cout << boardGameBytes / storeGameBytes << " times as much" << endl;
+  cout << gameCount << " games played in " << milliseconds << " ms, ";
+  cout << ((isPassed) ? "every check passed" : "a check FAILED") << endl;
+  return (isPassed) ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/* This file contains the member functions of the SnapshotPublisher
+   class. */
+
+#include "SnapshotPublisher.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+SnapshotPublisher::SnapshotPublisher() {
+  for (atomic<uint64_t>& word : words) {
+    word.store(0, memory_order_relaxed);
+  }
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+uint64_t SnapshotPublisher::getVersion() const {
+  return sequence.load(memory_order_acquire) / 2;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void SnapshotPublisher::publish(BoardSnapshot const& snapshot) {
+  uint64_t buffer[SNAPSHOT_WORD_COUNT] = {};
+  memcpy(buffer, &snapshot, sizeof(snapshot));
+
+  // The fence keeps the words from being written before readers can see
+  // that the sequence number is odd
+  uint64_t start = sequence.load(memory_order_relaxed);
+  sequence.store(start + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  for (int i = 0; i < SNAPSHOT_WORD_COUNT; i++) {
+    words[i].store(buffer[i], memory_order_relaxed);
+  }
+  sequence.store(start + 2, memory_order_release);
+}
+
+BoardSnapshot SnapshotPublisher::read() const {
+  BoardSnapshot snapshot;
+  read(snapshot);
+  return snapshot;
+}
+
+uint64_t SnapshotPublisher::read(BoardSnapshot& snapshot) const {
+  uint64_t buffer[SNAPSHOT_WORD_COUNT];
+  while (true) {
+    uint64_t before = sequence.load(memory_order_acquire);
+    if (before % 2 != 0) {
+      continue;
+    }
+    for (int i = 0; i < SNAPSHOT_WORD_COUNT; i++) {
+      buffer[i] = words[i].load(memory_order_relaxed);
+    }
+
+    // The fence keeps the words from being read after the sequence number
+    // is checked again
+    atomic_thread_fence(memory_order_acquire);
+    if (sequence.load(memory_order_relaxed) == before) {
+      memcpy(&snapshot, buffer, sizeof(snapshot));
+      return before / 2;
+    }
+  }
+}
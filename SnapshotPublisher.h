@@ -0,0 +1,83 @@
+#ifndef SNAPSHOTPUBLISHER_H
+#define SNAPSHOTPUBLISHER_H
+
+#include "ChessBoard.h"
+#include "GameStatus.h"
+#include "Move.h"
+#include "Zobrist.h"
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/* The BoardSnapshot struct is what a ChessBoard publishes after each
+   change, for readers on other threads.
+   position is the Pieces, which have moved and the player to move.
+   status is the state of the game for the player to move.
+   moveCount is the number of moves made, and lastMove is the last of them
+   if moveCount is not 0.
+   hash is the Zobrist hash of the position. */
+
+struct BoardSnapshot {
+  Snapshot position;
+  GameStatus status;
+  uint32_t moveCount;
+  Move lastMove;
+  HashKey hash;
+};
+
+static_assert(std::is_trivially_copyable<BoardSnapshot>::value,
+	      "a BoardSnapshot must be copyable with memcpy");
+
+// Number of 64 bit words a BoardSnapshot is stored in
+const int SNAPSHOT_WORD_COUNT = (sizeof(BoardSnapshot) + 7) / 8;
+
+/* The SnapshotPublisher class passes BoardSnapshots from the one thread
+   which changes a ChessBoard to any number of threads which read it,
+   without locks. It is a sequence lock: the writer makes the sequence
+   number odd, writes the snapshot and makes it even again, and a reader
+   copies the snapshot out between two reads of the sequence number, and
+   copies it again if the number was odd or has changed, which only happens
+   if it overlapped a write. Readers never write to the publisher, so they
+   do not slow each other down, and a read allocates nothing. The snapshot
+   is kept in atomic words so that a read which overlaps a write is not a
+   data race, only a wasted copy.
+   Only one thread may publish at a time. A ChessBoard publishes to the
+   SnapshotPublisher given to ChessBoard::setPublisher(). */
+
+class alignas(64) SnapshotPublisher {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a SnapshotPublisher object holding a BoardSnapshot of an
+     empty board, with version 0. */
+  SnapshotPublisher();
+
+  SnapshotPublisher(SnapshotPublisher const&) = delete;
+  SnapshotPublisher& operator=(SnapshotPublisher const&) = delete;
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of snapshots published so far, so that a reader can
+     see whether there is a new one without reading it. */
+  uint64_t getVersion() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Replaces the snapshot with the input one. Must only be called by one
+     thread at a time. */
+  void publish(BoardSnapshot const& snapshot);
+
+  /* Returns the latest snapshot. Can be called from any number of threads
+     at once, while another thread publishes. */
+  BoardSnapshot read() const;
+
+  /* Copies the latest snapshot into snapshot and returns its version. */
+  uint64_t read(BoardSnapshot& snapshot) const;
+
+private:
+  // Twice the version, plus one while a snapshot is being written
+  std::atomic<uint64_t> sequence{0};
+  std::atomic<uint64_t> words[SNAPSHOT_WORD_COUNT];
+};
+
+#endif
@@ -2,6 +2,7 @@
    Square class. */
 
 #include "Square.h"
+#include "Stats.h"
 #include "constants.h"
 #include <string>
 #include "errors.h"
@@ -14,6 +15,7 @@ Square::Square() {}
 
 Square::Square(string rankAndFile) {
   if (!isOnBoard(rankAndFile)) {
+    STATS_COUNT(SquareErrorCount);
     throw OffBoardError{rankAndFile};
   }
   rankIndex = static_cast<int>(rankAndFile[RANK_INDEX] - ASCII_ONE);
@@ -23,6 +25,7 @@ Square::Square(string rankAndFile) {
 Square::Square(int rankIndex, int fileIndex) : rankIndex(rankIndex),
 					       fileIndex(fileIndex) {
   if (!this->isOnBoard()) {
+    STATS_COUNT(SquareErrorCount);
     throw OffBoardError{};
   }
 }
@@ -51,6 +54,10 @@ int Square::getFile() const {
   return fileIndex;
 }
 
+int Square::getIndex() const {
+  return rankIndex * BOARD_WIDTH + fileIndex;
+}
+
 // ---------- Checker functions ----------------------------------------------
 
 bool Square::isOnBoard() const {
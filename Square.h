@@ -54,6 +54,10 @@ public:
   /* Returns a copy of the fileIndex. */
   int getFile() const;
 
+  /* Returns the index of the square in the range 0-63, counting along each
+     rank from A1, i.e. rankIndex * 8 + fileIndex. A1 is 0 and H8 is 63. */
+  int getIndex() const;
+
 private:
   int rankIndex;
   int fileIndex;
@@ -0,0 +1,136 @@
+/* This file contains the functions which read and reset the counters kept
+   about the rules engine, and the member functions of the ThreadStats
+   class. */
+
+#include "Stats.h"
+#include "PieceType.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+ostream& operator<<(ostream& os, const EngineStats& stats) {
+  os << "Board copies: " << stats.boardCopies << endl;
+  os << "isMoveLegal calls: " << stats.moveLegalCalls << endl;
+  for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+    os << "isMovePossible calls (" << static_cast<PieceType>(type) << "): ";
+    os << stats.movePossibleCalls[type] << endl;
+  }
+  os << "Square errors: " << stats.squareErrors << endl;
+  os << "Check detection: " << stats.checkNanoseconds / 1000 << " us" << endl;
+  os << "Checkmate detection: " << stats.checkmateNanoseconds / 1000;
+  os << " us" << endl;
+  os << "Stalemate detection: " << stats.stalemateNanoseconds / 1000;
+  os << " us" << endl;
+  return os;
+}
+
+#ifdef CHESS_STATS
+
+// The ThreadStats of every running thread, and the counts of the threads
+// which have finished, both guarded by registryMutex
+static mutex registryMutex;
+static vector<ThreadStats*> registry;
+static long long finishedValues[STATS_COUNTER_COUNT];
+
+thread_local ThreadStats threadStats;
+
+/* Copies the counter values into an EngineStats object. */
+static EngineStats toEngineStats(long long const* values) {
+  EngineStats stats;
+  stats.boardCopies = values[BoardCopyCount];
+  stats.moveLegalCalls = values[MoveLegalCount];
+  for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+    stats.movePossibleCalls[type] = values[PawnMovePossibleCount + type];
+  }
+  stats.squareErrors = values[SquareErrorCount];
+  stats.checkNanoseconds = values[CheckTime];
+  stats.checkmateNanoseconds = values[CheckmateTime];
+  stats.stalemateNanoseconds = values[StalemateTime];
+  return stats;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+ThreadStats::ThreadStats() {
+  for (atomic<long long>& value : values) {
+    value.store(0, memory_order_relaxed);
+  }
+  lock_guard<mutex> lock{registryMutex};
+  registry.push_back(this);
+}
+
+ThreadStats::~ThreadStats() {
+  lock_guard<mutex> lock{registryMutex};
+  for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+    finishedValues[i] += values[i].load(memory_order_relaxed);
+  }
+  registry.erase(find(registry.begin(), registry.end(), this));
+}
+
+// ---------- Functions --------------------------------------------------------
+
+bool isStatsEnabled() {
+  return true;
+}
+
+EngineStats getThreadStats() {
+  long long values[STATS_COUNTER_COUNT];
+  for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+    values[i] = threadStats.values[i].load(memory_order_relaxed);
+  }
+  return toEngineStats(values);
+}
+
+EngineStats getStats() {
+  long long values[STATS_COUNTER_COUNT];
+  lock_guard<mutex> lock{registryMutex};
+  for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+    values[i] = finishedValues[i];
+    for (ThreadStats const* stats : registry) {
+      values[i] += stats->values[i].load(memory_order_relaxed);
+    }
+  }
+  return toEngineStats(values);
+}
+
+void resetThreadStats() {
+  for (atomic<long long>& value : threadStats.values) {
+    value.store(0, memory_order_relaxed);
+  }
+}
+
+void resetStats() {
+  lock_guard<mutex> lock{registryMutex};
+  for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+    finishedValues[i] = 0;
+    for (ThreadStats* stats : registry) {
+      stats->values[i].store(0, memory_order_relaxed);
+    }
+  }
+}
+
+#else
+
+// ---------- Functions --------------------------------------------------------
+
+bool isStatsEnabled() {
+  return false;
+}
+
+EngineStats getThreadStats() {
+  return EngineStats{};
+}
+
+EngineStats getStats() {
+  return EngineStats{};
+}
+
+void resetThreadStats() {}
+
+void resetStats() {}
+
+#endif
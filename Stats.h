@@ -0,0 +1,150 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "PieceType.h"
+#include "Latency.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+/* The StatsCounter enumeration lists the counters kept about the rules
+   engine when it is built with CHESS_STATS defined. The MovePossible
+   counters are in the same order as the PieceType enumeration. The Time
+   counters are in nanoseconds. */
+
+enum StatsCounter { BoardCopyCount, MoveLegalCount, PawnMovePossibleCount,
+		    KnightMovePossibleCount, BishopMovePossibleCount,
+		    RookMovePossibleCount, QueenMovePossibleCount,
+		    KingMovePossibleCount, SquareErrorCount, CheckTime,
+		    CheckmateTime, StalemateTime };
+
+const int STATS_COUNTER_COUNT = 12;
+
+/* The EngineStats struct holds the counters, read at one moment.
+   boardCopies is the number of ChessBoards copied.
+   moveLegalCalls is the number of calls to ChessBoard::isMoveLegal().
+   movePossibleCalls is the number of calls to Piece::isMovePossible() for
+   each PieceType.
+   squareErrors is the number of OffBoardError exceptions thrown by the
+   Square constructors.
+   checkNanoseconds, checkmateNanoseconds and stalemateNanoseconds are the
+   time spent working out whether a player is in check, checkmate or
+   stalemate. The checkmate and stalemate tests look for check themselves,
+   so their time includes some of the check time. */
+
+struct EngineStats {
+  long long boardCopies = 0;
+  long long moveLegalCalls = 0;
+  long long movePossibleCalls[PIECE_TYPE_COUNT] = {};
+  long long squareErrors = 0;
+  long long checkNanoseconds = 0;
+  long long checkmateNanoseconds = 0;
+  long long stalemateNanoseconds = 0;
+};
+
+/* This function allows an EngineStats object to be output to the output
+   stream specified, one counter per line. */
+std::ostream& operator<<(std::ostream& os, const EngineStats& stats);
+
+/* Checks if the counters are kept, i.e. if the engine was built with
+   CHESS_STATS defined. If not, every EngineStats read is all zeros. */
+bool isStatsEnabled();
+
+/* Returns the counters of the calling thread. */
+EngineStats getThreadStats();
+
+/* Returns the counters of every thread added together, including threads
+   which have finished. */
+EngineStats getStats();
+
+/* Sets the counters of the calling thread to zero. */
+void resetThreadStats();
+
+/* Sets the counters of every thread to zero. Counts made by other threads
+   while this runs may be lost, so it is best called while they are idle. */
+void resetStats();
+
+#ifdef CHESS_STATS
+
+/* The ThreadStats class holds the counters of one thread. Each thread has
+   its own, so counting never waits for or shares a cache line with
+   another thread. Only the owning thread writes them, but any thread can
+   read them, so they are atomic and written with relaxed loads and stores,
+   which cost the same as plain ones. Each ThreadStats object adds itself to
+   a list when it is constructed, so that getStats() can find it, and adds
+   its counts to a total for finished threads when it is destroyed. */
+
+class ThreadStats {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a ThreadStats object with every counter at zero and adds it
+     to the list of threads. */
+  ThreadStats();
+
+  /* Destructor. Adds the counters to the total for finished threads and
+     takes the object off the list. */
+  ~ThreadStats();
+
+  ThreadStats(ThreadStats const&) = delete;
+  ThreadStats& operator=(ThreadStats const&) = delete;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Adds amount to the input counter. */
+  void add(StatsCounter counter, long long amount) {
+    std::atomic<long long>& value = values[counter];
+    value.store(value.load(std::memory_order_relaxed) + amount,
+		std::memory_order_relaxed);
+  }
+
+  std::atomic<long long> values[STATS_COUNTER_COUNT];
+};
+
+/* The counters of the calling thread. */
+extern thread_local ThreadStats threadStats;
+
+/* The StatsTimer class adds the time from its construction to its
+   destruction to a Time counter, and records it in the latency histogram
+   of a LatencyOperation, so it times the rest of the scope it is declared
+   in. The clock is read once at each end for both. */
+
+class StatsTimer {
+public:
+  /* Starts timing for the input counter and operation. */
+  StatsTimer(StatsCounter counter, LatencyOperation operation) :
+    counter(counter), operation(operation),
+    start(std::chrono::steady_clock::now()) {}
+
+  /* Stops timing and adds the time taken to the counter and the
+     histogram. */
+  ~StatsTimer() {
+    long long nanoseconds = std::chrono::duration_cast<
+      std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+				start).count();
+    threadStats.add(counter, nanoseconds);
+    threadLatencies.record(operation, nanoseconds);
+  }
+
+private:
+  StatsCounter counter;
+  LatencyOperation operation;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Adds one to the input counter of the calling thread
+#define STATS_COUNT(counter) threadStats.add(counter, 1)
+
+// Adds the time until the end of the scope to the input Time counter and
+// records it for the input LatencyOperation
+#define STATS_TIME(counter, operation) StatsTimer statsTimer{counter, operation}
+
+#else
+
+// Without CHESS_STATS the counters are not kept and cost nothing
+#define STATS_COUNT(counter)
+#define STATS_TIME(counter, operation)
+
+#endif
+
+#endif
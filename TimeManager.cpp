@@ -0,0 +1,84 @@
+/* This file contains the member functions of the TimeManager class. */
+
+#include "TimeManager.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+TimeManager::TimeManager() : startTime(chrono::steady_clock::now()) {}
+
+// ---------- Getter functions -------------------------------------------------
+
+long long TimeManager::getElapsed() const {
+  return chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - startTime).count();
+}
+
+long long TimeManager::getSoftDeadline() const {
+  if (!isTimed()) {
+    return 0;
+  }
+  // While the best move keeps changing, up to MAX_TIME_STRETCH times as
+  // much time is spent on the move
+  double stretch = min(1.0 + instability, MAX_TIME_STRETCH);
+  return min(static_cast<long long>(softDeadline * stretch), hardDeadline);
+}
+
+long long TimeManager::getHardDeadline() const {
+  return hardDeadline;
+}
+
+// ---------- Checker functions ------------------------------------------------
+
+bool TimeManager::isTimed() const {
+  return hardDeadline > 0;
+}
+
+bool TimeManager::isSoftDeadlinePassed() const {
+  return isTimed() && getElapsed() >= getSoftDeadline();
+}
+
+bool TimeManager::isHardDeadlinePassed(long long nodes) const {
+  return isTimed() && (nodes & (TIME_CHECK_NODES - 1)) == 0 &&
+    getElapsed() >= hardDeadline;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void TimeManager::start(TimeControl const& control) {
+  startTime = chrono::steady_clock::now();
+  instability = 0.0;
+  softDeadline = 0;
+  hardDeadline = 0;
+
+  if (control.moveTime > 0) {
+    softDeadline = max(control.moveTime - MOVE_OVERHEAD_MILLISECONDS, 1LL);
+    hardDeadline = softDeadline;
+    return;
+  }
+  if (control.time <= 0) {
+    return;
+  }
+
+  long long available = max(control.time - MOVE_OVERHEAD_MILLISECONDS, 1LL);
+  int movesToGo = (control.movesToGo > 0) ?
+    min(control.movesToGo, DEFAULT_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+
+  // Share the time left between the moves to go, and spend most of the
+  // increment now since it comes back after the move
+  softDeadline = available / movesToGo + control.increment * 3 / 4;
+
+  // Never use more than half of the time left on one move, unless it is
+  // the last move before the time control
+  long long limit = (movesToGo == 1) ? available : available / 2;
+  hardDeadline = max(min(softDeadline * HARD_DEADLINE_FACTOR, limit), 1LL);
+  softDeadline = max(min(softDeadline, hardDeadline), 1LL);
+}
+
+void TimeManager::update(bool isBestMoveChanged) {
+  // Older changes count for half as much after each depth
+  instability = instability / 2 + ((isBestMoveChanged) ? 1.0 : 0.0);
+}
@@ -0,0 +1,102 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <chrono>
+
+// Time kept back from every move for the delay in sending it, in
+// milliseconds
+const long long MOVE_OVERHEAD_MILLISECONDS = 30;
+
+// Number of moves the remaining time is shared between when the number of
+// moves to the next time control is not known
+const int DEFAULT_MOVES_TO_GO = 30;
+
+// Most times the soft deadline can be stretched by when the best move
+// keeps changing, and the most of the soft deadline the hard deadline can
+// be
+const double MAX_TIME_STRETCH = 3.0;
+const int HARD_DEADLINE_FACTOR = 5;
+
+// Number of positions a Search visits between two looks at the clock. It
+// must be a power of two.
+const long long TIME_CHECK_NODES = 256;
+
+/* The TimeControl struct holds the clock of the player to move, in
+   milliseconds.
+   time is the time left on the clock, or 0 if there is no clock.
+   increment is the time added to the clock after each move.
+   movesToGo is the number of moves to the next time control, or 0 if the
+   rest of the game must be played in time.
+   moveTime is the exact time to spend on this move, or 0 if it is worked
+   out from the clock. */
+
+struct TimeControl {
+  long long time = 0;
+  long long increment = 0;
+  int movesToGo = 0;
+  long long moveTime = 0;
+};
+
+/* The TimeManager class decides how long a Search may spend on a move. It
+   sets two deadlines when the move starts. The soft deadline is the time
+   the move should take, and is only checked between depths, so that a
+   depth is not started without the time to finish it. It is stretched
+   while the best move is still changing from one depth to the next, since
+   the Search has not made up its mind yet. The hard deadline can never be
+   passed, and the Search stops in the middle of a depth when it is reached.
+   Reading the clock is much slower than visiting a position, so the hard
+   deadline is only checked every TIME_CHECK_NODES positions. */
+
+class TimeManager {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a TimeManager object with no deadlines, started now. */
+  TimeManager();
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of milliseconds since the move was started. */
+  long long getElapsed() const;
+
+  /* Returns the soft deadline in milliseconds from the start of the move,
+     including any stretch, or 0 if there are no deadlines. */
+  long long getSoftDeadline() const;
+
+  /* Returns the hard deadline in milliseconds from the start of the move,
+     or 0 if there are no deadlines. */
+  long long getHardDeadline() const;
+
+  // ---------- Checker functions ----------------------------------------------
+
+  /* Checks if the move has deadlines, i.e. if it is played on a clock. */
+  bool isTimed() const;
+
+  /* Checks if the soft deadline has passed, i.e. if no further depth
+     should be started. */
+  bool isSoftDeadlinePassed() const;
+
+  /* Checks if the hard deadline has passed. nodes is the number of positions
+     visited so far, and the clock is only read when it is a multiple of
+     TIME_CHECK_NODES. */
+  bool isHardDeadlinePassed(long long nodes) const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Starts timing a move now, with deadlines worked out from the input
+     TimeControl. */
+  void start(TimeControl const& control);
+
+  /* Tells the TimeManager that a depth has been finished, and whether its
+     best move differs from the one of the depth before. The soft deadline
+     is stretched more the more often the best move has changed lately. */
+  void update(bool isBestMoveChanged);
+
+private:
+  std::chrono::steady_clock::time_point startTime;
+  long long softDeadline = 0;
+  long long hardDeadline = 0;
+  double instability = 0.0;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/* This file contains the main function of the train tool, which runs a
+   fixed workload through the rules engine and the search. It is the
+   training run of the profile-guided build ("make pgo-gen" runs it), so it
+   is meant to use the engine the way the other programs do:
+   - perft on a few positions, which spends its time in move generation,
+     i.e. isMovePossible(), isMoveLegal() and playMove()/takeback(),
+   - replays of two famous games and of TRAIN_RANDOM_GAMES random games
+     through submitMove(), with an illegal move tried now and then, as a
+     server would see them,
+   - a short Search of each perft position.
+   The messages of submitMove() are thrown away. Usage:
+   >> train */
+
+#include "ChessBoard.h"
+#include "Move.h"
+#include "NullBuffer.h"
+#include "Perft.h"
+#include "Player.h"
+#include "Search.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Number of random games replayed, the most moves each one may last, and
+// the seed they are drawn from, so that every training run is the same
+const int TRAIN_RANDOM_GAMES = 100;
+const int TRAIN_MAX_PLIES = 200;
+const unsigned TRAIN_SEED = 2024;
+
+// Depth of the Search of each perft position
+const int TRAIN_SEARCH_DEPTH = 3;
+
+/* The positions for perft, in Forsyth-Edwards Notation, with the depth to
+   count to. */
+static const vector<pair<string, int>> PERFT_POSITIONS = {
+  {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4},
+  {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3},
+  {"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4", 3},
+  {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4},
+  {"6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1", 4}
+};
+
+/* Two games, as the inputs of submitMove(): the "Opera Game", Morphy
+   against the Duke of Brunswick and Count Isouard, Paris 1858, and the
+   "Immortal Game", Anderssen against Kieseritzky, London 1851. */
+static const vector<vector<pair<string, string>>> FAMOUS_GAMES = {
+  {{"E2", "E4"}, {"E7", "E5"}, {"G1", "F3"}, {"D7", "D6"}, {"D2", "D4"},
+   {"C8", "G4"}, {"D4", "E5"}, {"G4", "F3"}, {"D1", "F3"}, {"D6", "E5"},
+   {"F1", "C4"}, {"G8", "F6"}, {"F3", "B3"}, {"D8", "E7"}, {"B1", "C3"},
+   {"C7", "C6"}, {"C1", "G5"}, {"B7", "B5"}, {"C3", "B5"}, {"C6", "B5"},
+   {"C4", "B5"}, {"B8", "D7"}, {"W", "O-O-O"}, {"A8", "D8"}, {"D1", "D7"},
+   {"D8", "D7"}, {"H1", "D1"}, {"E7", "E6"}, {"B5", "D7"}, {"F6", "D7"},
+   {"B3", "B8"}, {"D7", "B8"}, {"D1", "D8"}},
+  {{"E2", "E4"}, {"E7", "E5"}, {"F2", "F4"}, {"E5", "F4"}, {"F1", "C4"},
+   {"D8", "H4"}, {"E1", "F1"}, {"B7", "B5"}, {"C4", "B5"}, {"G8", "F6"},
+   {"G1", "F3"}, {"H4", "H6"}, {"D2", "D3"}, {"F6", "H5"}, {"F3", "H4"},
+   {"H6", "G5"}, {"H4", "F5"}, {"C7", "C6"}, {"G2", "G4"}, {"H5", "F6"},
+   {"H1", "G1"}, {"C6", "B5"}, {"H2", "H4"}, {"G5", "G6"}, {"H4", "H5"},
+   {"G6", "G5"}, {"D1", "F3"}, {"F6", "G8"}, {"C1", "F4"}, {"G5", "F6"},
+   {"B1", "C3"}, {"F8", "C5"}, {"C3", "D5"}, {"F6", "B2"}, {"F4", "D6"},
+   {"C5", "G1"}, {"E4", "E5"}, {"B2", "A1"}, {"F1", "E2"}, {"B8", "A6"},
+   {"F5", "G7"}, {"E8", "D8"}, {"F3", "F6"}, {"G8", "F6"}, {"D6", "E7"}}
+};
+
+/* Returns the inputs of submitMove() for move, made by player. */
+static pair<string, string> getInputs(Move const& move, Player player) {
+  if (move.isCastle()) {
+    return {(player == White) ? "W" : "B",
+	    (move.isKingsideCastle()) ? "O-O" : "O-O-O"};
+  }
+  ostringstream source, destination;
+  source << move.getSource();
+  destination << move.getDestination();
+  return {source.str(), destination.str()};
+}
+
+/* Returns the number of milliseconds since start. */
+static long long getMilliseconds(chrono::steady_clock::time_point start) {
+  return chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  // Perft
+  auto start = chrono::steady_clock::now();
+  long long nodes = 0;
+  for (auto const& position : PERFT_POSITIONS) {
+    ChessBoard board{position.first};
+    nodes += perft(board, position.second);
+  }
+  cout << "Perft: " << nodes << " nodes in " << getMilliseconds(start);
+  cout << " ms" << endl;
+
+  // Replays, with the messages of submitMove() thrown away
+  start = chrono::steady_clock::now();
+  NullBuffer nullBuffer;
+  streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+  streambuf* cerrBuffer = cerr.rdbuf(&nullBuffer);
+
+  long long plies = 0;
+  for (auto const& game : FAMOUS_GAMES) {
+    ChessBoard board;
+    for (auto const& inputs : game) {
+      board.submitMove(inputs.first, inputs.second);
+      plies++;
+    }
+  }
+
+  mt19937 random{TRAIN_SEED};
+  for (int i = 0; i < TRAIN_RANDOM_GAMES; i++) {
+    ChessBoard board;
+    for (int ply = 0; ply < TRAIN_MAX_PLIES; ply++) {
+      // Every so often try a move which is most likely not allowed
+      if (random() % 8 == 0) {
+	string source{static_cast<char>('A' + random() % 8),
+		      static_cast<char>('1' + random() % 8)};
+	string destination{static_cast<char>('A' + random() % 8),
+			   static_cast<char>('1' + random() % 8)};
+	board.submitMove(source, destination);
+	continue;
+      }
+      vector<Move> moves = board.getLegalMoves();
+      Move move = moves[random() % moves.size()];
+      Player player = board.getPlayer();
+      pair<string, string> inputs = getInputs(move, player);
+      board.submitMove(inputs.first, inputs.second);
+      plies++;
+
+      // The player is only swapped over if the game goes on
+      if (board.getPlayer() == player) {
+	break;
+      }
+    }
+  }
+
+  cout.rdbuf(coutBuffer);
+  cerr.rdbuf(cerrBuffer);
+  cout << "Replay: " << plies << " moves in " << getMilliseconds(start);
+  cout << " ms" << endl;
+
+  // Search
+  start = chrono::steady_clock::now();
+  nodes = 0;
+  Search search;
+  for (auto const& position : PERFT_POSITIONS) {
+    ChessBoard board{position.first};
+    SearchLimits limits;
+    limits.depth = TRAIN_SEARCH_DEPTH;
+    nodes += search.run(board, limits).nodes;
+  }
+  cout << "Search: " << nodes << " nodes in " << getMilliseconds(start);
+  cout << " ms" << endl;
+  return 0;
+}
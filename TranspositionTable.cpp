@@ -0,0 +1,80 @@
+/* This file contains the member functions of the TranspositionTable 
+   class. */
+
+#include "TranspositionTable.h"
+#include "Move.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Number of entries looked at by getHashfull()
+const size_t HASHFULL_SAMPLE = 1000;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+  resize(megabytes);
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+size_t TranspositionTable::getEntryCount() const {
+  return entries.size();
+}
+
+int TranspositionTable::getHashfull() const {
+  size_t sample = min(HASHFULL_SAMPLE, entries.size());
+  size_t used = 0;
+  for (size_t i = 0; i < sample; i++) {
+    if (entries[i].key != 0) {
+      used++;
+    }
+  }
+  return static_cast<int>(used * 1000 / sample);
+}
+
+// ---------- Other functions --------------------------------------------------
+
+bool TranspositionTable::probe(HashKey key, TableEntry& entry) const {
+  TableEntry const& slot = entries[key & mask];
+  if (slot.key != key) {
+    return false;
+  }
+  entry = slot;
+  return true;
+}
+
+void TranspositionTable::store(HashKey key, Move move, bool hasMove, int score,
+			       int depth, ScoreBound bound) {
+  TableEntry& slot = entries[key & mask];
+  if (slot.key == key && slot.depth > depth) {
+    return;
+  }
+  slot.key = key;
+  slot.move = move;
+  slot.hasMove = hasMove;
+  slot.score = score;
+  slot.depth = depth;
+  slot.bound = bound;
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+  // Round the number of entries down to a power of two, so that the index
+  // is the hash masked
+  size_t maxCount = max<size_t>(1, megabytes * 1024 * 1024 /
+				sizeof(TableEntry));
+  size_t count = 1;
+  while (count * 2 <= maxCount) {
+    count *= 2;
+  }
+  entries.assign(count, TableEntry{});
+  entries.shrink_to_fit();
+  mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+  fill(entries.begin(), entries.end(), TableEntry{});
+}
@@ -0,0 +1,80 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "Move.h"
+#include "Zobrist.h"
+#include <cstddef>
+#include <vector>
+
+/* The ScoreBound enumeration says how a score in the TranspositionTable
+   relates to the true value of the position: ExactScore if it is the value,
+   LowerBound if the value is at least the score (the search was cut off)
+   and UpperBound if the value is at most the score (no move reached
+   alpha). */
+
+enum ScoreBound { ExactScore, LowerBound, UpperBound };
+
+/* The TableEntry struct holds what a Search found out about one position.
+   key is the hash of the position, or 0 for an empty entry.
+   move is the best move found, and is only set if hasMove is true.
+   score is the score found, with mate scores counted from this position.
+   depth is the depth the position was searched to.
+   bound is the kind of score. */
+
+struct TableEntry {
+  HashKey key = 0;
+  Move move;
+  bool hasMove = false;
+  int score = 0;
+  int depth = 0;
+  ScoreBound bound = ExactScore;
+};
+
+/* The TranspositionTable class is a fixed size hash table of TableEntry
+   objects, indexed by the low bits of the hash of the position. When two
+   positions share an index the newer one replaces the older one, unless the
+   older one is the same position searched deeper. The number of entries is
+   always a power of two. A table must only be used by one thread at a 
+   time. */
+
+class TranspositionTable {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a TranspositionTable object taking up at most the input
+     number of megabytes, and at least one entry. */
+  TranspositionTable(std::size_t megabytes);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of entries. */
+  std::size_t getEntryCount() const;
+
+  /* Returns how full the table is, in entries per thousand, as used by the
+     "hashfull" of the UCI protocol. Only the first thousand entries are 
+     looked at. */
+  int getHashfull() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Looks up the position with hash key. If it is in the table, copies its
+     entry into entry and returns true. */
+  bool probe(HashKey key, TableEntry& entry) const;
+
+  /* Stores what was found out about the position with hash key. */
+  void store(HashKey key, Move move, bool hasMove, int score, int depth,
+	     ScoreBound bound);
+
+  /* Empties the table and changes its size to at most the input number of
+     megabytes. */
+  void resize(std::size_t megabytes);
+
+  /* Empties the table. */
+  void clear();
+
+private:
+  std::vector<TableEntry> entries;
+  std::size_t mask = 0;
+};
+
+#endif
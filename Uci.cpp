@@ -0,0 +1,306 @@
+/* This file contains the member functions of the Uci class. */
+
+#include "Uci.h"
+#include "ChessBoard.h"
+#include "Search.h"
+#include "Move.h"
+#include "Player.h"
+#include "Square.h"
+#include "constants.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Depth searched by a "go" command which gives no limit
+const int UCI_DEFAULT_DEPTH = 5;
+
+// Limits of the "Hash" option, in megabytes
+const size_t MIN_HASH_MEGABYTES = 1;
+const size_t MAX_HASH_MEGABYTES = 4096;
+
+// Most lines the "MultiPV" option can ask for
+const int MAX_MULTI_PV = 64;
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Uci::Uci(istream& input, ostream& output) : input(input), output(output) {
+  search.setCallback([this](SearchResult const& result) {
+    sendInfo(result);
+  });
+}
+
+Uci::~Uci() {
+  stopSearch();
+}
+
+// ---------- Other functions --------------------------------------------------
+
+void Uci::run() {
+  string line;
+  while (getline(input, line)) {
+    if (!handleCommand(line)) {
+      break;
+    }
+  }
+  stopSearch();
+}
+
+bool Uci::handleCommand(string const& line) {
+  istringstream tokens{line};
+  string command;
+  tokens >> command;
+
+  if (command == "uci") {
+    send("id name Chess");
+    send("id author Chess contributors");
+    send("option name Hash type spin default " +
+	 to_string(DEFAULT_TABLE_MEGABYTES) + " min " +
+	 to_string(MIN_HASH_MEGABYTES) + " max " +
+	 to_string(MAX_HASH_MEGABYTES));
+    send("option name Clear Hash type button");
+    send("option name MultiPV type spin default 1 min 1 max " +
+	 to_string(MAX_MULTI_PV));
+    send("uciok");
+  } else if (command == "isready") {
+    send("readyok");
+  } else if (command == "ucinewgame") {
+    stopSearch();
+    search.clearTable();
+    board.setPosition(START_FEN);
+  } else if (command == "setoption") {
+    stopSearch();
+    setOption(tokens);
+  } else if (command == "position") {
+    stopSearch();
+    setPosition(tokens);
+  } else if (command == "go") {
+    stopSearch();
+    startSearch(tokens);
+  } else if (command == "stop") {
+    stopSearch();
+  } else if (command == "quit") {
+    stopSearch();
+    return false;
+  }
+  return true;
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+void Uci::send(string const& line) {
+  lock_guard<mutex> lock{outputMutex};
+  output << line << endl;
+}
+
+void Uci::setPosition(istringstream& tokens) {
+  string token;
+  tokens >> token;
+  string fen = START_FEN;
+  if (token == "fen") {
+    fen.clear();
+    while (tokens >> token && token != "moves") {
+      fen += (fen.empty()) ? token : " " + token;
+    }
+  } else if (token == "startpos") {
+    tokens >> token;
+  } else {
+    return;
+  }
+
+  try {
+    board.setPosition(fen);
+  } catch (FenError const& e) {
+    send(string{"info string "} + e.what());
+    board.setPosition(START_FEN);
+    return;
+  }
+
+  // The moves are played so that they are in the history, where the Search
+  // finds repetitions. They are played on a copy first, so that if one of
+  // them is not legal the board is left in the position given rather than
+  // part of the way through the moves.
+  if (token != "moves") {
+    return;
+  }
+  ChessBoard next = board;
+  while (tokens >> token) {
+    Move move;
+    if (!findMove(next, token, move)) {
+      send("info string " + token + " is not a legal move");
+      return;
+    }
+    next.playMove(move);
+  }
+  board = next;
+}
+
+void Uci::startSearch(istringstream& tokens) {
+  SearchLimits limits;
+  limits.depth = UCI_DEFAULT_DEPTH;
+  limits.stopFlag = &stopFlag;
+  limits.multiPv = multiPv;
+  Player player = board.getPlayer();
+  bool isDepthGiven = false;
+  bool isInfinite = false;
+  string token;
+  while (tokens >> token) {
+    if (token == "depth") {
+      tokens >> limits.depth;
+      isDepthGiven = true;
+    } else if (token == "nodes") {
+      tokens >> limits.nodes;
+    } else if (token == "infinite") {
+      limits.depth = MAX_DEPTH;
+      isInfinite = true;
+    } else if (token == "movetime") {
+      tokens >> limits.clock.moveTime;
+    } else if (token == "movestogo") {
+      tokens >> limits.clock.movesToGo;
+    } else if (token == (player == White ? "wtime" : "btime")) {
+      tokens >> limits.clock.time;
+    } else if (token == (player == White ? "winc" : "binc")) {
+      tokens >> limits.clock.increment;
+    }
+  }
+  // On a clock the TimeManager decides when to stop, unless a depth was
+  // also given
+  if ((limits.clock.time > 0 || limits.clock.moveTime > 0) &&
+      !isDepthGiven) {
+    limits.depth = MAX_DEPTH;
+  }
+
+  stopFlag = false;
+  searchThread = thread{[this, limits, isInfinite] {
+    SearchResult result = search.run(board, limits);
+
+    // An infinite search may end by itself, e.g. on finding a mate, but
+    // the protocol only allows "bestmove" after "stop"
+    if (isInfinite) {
+      unique_lock<mutex> lock{stopMutex};
+      stopped.wait(lock, [this] { return stopFlag.load(); });
+    }
+    send("bestmove " +
+	 ((result.hasBestMove) ? formatMove(result.bestMove) : "0000"));
+  }};
+}
+
+void Uci::stopSearch() {
+  if (searchThread.joinable()) {
+    {
+      lock_guard<mutex> lock{stopMutex};
+      stopFlag = true;
+    }
+    stopped.notify_all();
+    searchThread.join();
+  }
+}
+
+void Uci::setOption(istringstream& tokens) {
+  // Option names can have spaces in them, e.g. "Clear Hash"
+  string token, name, value;
+  tokens >> token;
+  if (token != "name") {
+    return;
+  }
+  while (tokens >> token && token != "value") {
+    name += (name.empty()) ? token : " " + token;
+  }
+  tokens >> value;
+
+  if (name == "Hash") {
+    size_t megabytes = 0;
+    try {
+      megabytes = stoul(value);
+    } catch (exception const& e) {
+      send("info string the Hash value must be a number");
+      return;
+    }
+    megabytes = max(MIN_HASH_MEGABYTES, min(megabytes, MAX_HASH_MEGABYTES));
+    search.setTableSize(megabytes);
+  } else if (name == "Clear Hash") {
+    search.clearTable();
+  } else if (name == "MultiPV") {
+    try {
+      multiPv = max(1, min(stoi(value), MAX_MULTI_PV));
+    } catch (exception const& e) {
+      send("info string the MultiPV value must be a number");
+    }
+  } else {
+    send("info string there is no option " + name);
+  }
+}
+
+void Uci::sendInfo(SearchResult const& result) {
+  long long nps = result.nodes * 1000 / max(result.milliseconds, 1LL);
+  for (size_t i = 0; i < result.lines.size(); i++) {
+    SearchLine const& line = result.lines[i];
+    ostringstream info;
+    info << "info depth " << result.depth;
+    if (multiPv > 1) {
+      info << " multipv " << i + 1;
+    }
+    info << " score ";
+    if (line.score > MATE_SCORE - MAX_DEPTH) {
+      info << "mate " << (MATE_SCORE - line.score + 1) / 2;
+    } else if (line.score < -MATE_SCORE + MAX_DEPTH) {
+      info << "mate -" << (MATE_SCORE + line.score) / 2;
+    } else {
+      info << "cp " << line.score;
+    }
+    info << " nodes " << result.nodes << " nps " << nps;
+    info << " time " << result.milliseconds;
+    info << " hashfull " << search.getHashfull() << " pv";
+    for (Move const& move : line.moves) {
+      info << " " << formatMove(move);
+    }
+    send(info.str());
+  }
+}
+
+bool Uci::findMove(ChessBoard& position, string const& text, Move& move) {
+  if (text.size() != 4) {
+    return false;
+  }
+  int sourceFile = text[0] - 'a';
+  int sourceRank = text[1] - '1';
+  int destinationFile = text[2] - 'a';
+  int destinationRank = text[3] - '1';
+  for (int index : {sourceFile, sourceRank, destinationFile,
+		    destinationRank}) {
+    if (index < 0 || index >= BOARD_WIDTH) {
+      return false;
+    }
+  }
+
+  Square source{sourceRank, sourceFile};
+  Square destination{destinationRank, destinationFile};
+  for (Move const& legalMove : position.getLegalMoves()) {
+    if (legalMove.getSource() == source &&
+	legalMove.getDestination() == destination) {
+      move = legalMove;
+      return true;
+    }
+  }
+  return false;
+}
+
+string Uci::formatMove(Move move) {
+  Square source = move.getSource();
+  Square destination = move.getDestination();
+  string text;
+  text += static_cast<char>('a' + source.getFile());
+  text += static_cast<char>('1' + source.getRank());
+  text += static_cast<char>('a' + destination.getFile());
+  text += static_cast<char>('1' + destination.getRank());
+  return text;
+}
@@ -0,0 +1,108 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include "ChessBoard.h"
+#include "Search.h"
+#include "Move.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/* The Uci class lets the engine be used by any chess program that speaks
+   the Universal Chess Interface protocol. Commands are read one line at a
+   time from the input stream and the replies are written to the output
+   stream. The supported commands are "uci", "isready", "ucinewgame",
+   "setoption", "position", "go", "stop" and "quit".
+   Each "go" starts a Search on its own thread, so the commands keep being
+   answered while it runs. The Search reports each finished depth with an
+   "info" line and ends with a "bestmove" line. "stop" sets the flag the
+   Search checks at every node, so the "bestmove" reply follows at once.
+   After "go infinite", "bestmove" is only sent once "stop" has been
+   received, even if the Search finishes before then.
+   "go" takes the limits "depth", "nodes" and "infinite", and the clock
+   limits "wtime", "btime", "winc", "binc", "movestogo" and "movetime",
+   which are handed to the TimeManager of the Search.
+   The options are "Hash", "Clear Hash" and "MultiPV". With a MultiPV of
+   more than 1, each depth is reported with one "info" line for each of the
+   best moves, numbered by "multipv".
+   Moves are written in the UCI form, e.g. "e2e4", with castles written as
+   the move of the King, e.g. "e1g1". */
+
+class Uci {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a Uci object reading commands from input and writing replies
+     to output, with the board in the starting position. */
+  Uci(std::istream& input, std::ostream& output);
+
+  /* Destructor. Stops any Search that is running. */
+  ~Uci();
+
+  Uci(Uci const&) = delete;
+  Uci& operator=(Uci const&) = delete;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Reads and carries out commands until "quit" or the end of the input. */
+  void run();
+
+  /* Carries out the command line input. Returns false if the command was
+     "quit", and true otherwise. Unknown commands are ignored, as the 
+     protocol asks. */
+  bool handleCommand(std::string const& line);
+
+private:
+  std::istream& input;
+  std::ostream& output;
+  std::mutex outputMutex;
+  ChessBoard board{START_FEN};
+  Search search;
+  std::thread searchThread;
+  std::atomic<bool> stopFlag{false};
+
+  // Lets a thread which has finished an infinite search wait for "stop"
+  std::mutex stopMutex;
+  std::condition_variable stopped;
+  int multiPv = 1;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Writes line to the output, followed by a newline, and flushes it. Used
+     by both threads, so only one line is written at a time. */
+  void send(std::string const& line);
+
+  /* Sets up the position of a "position" command, whose arguments are read
+     from tokens. If one of its moves is not legal, none of them are played
+     and the board is left in the position the moves start from. */
+  void setPosition(std::istringstream& tokens);
+
+  /* Starts a Search for a "go" command, whose arguments are read from
+     tokens. */
+  void startSearch(std::istringstream& tokens);
+
+  /* Stops the Search if one is running, and waits for its thread to 
+     finish. */
+  void stopSearch();
+
+  /* Carries out a "setoption" command, whose arguments are read from
+     tokens. */
+  void setOption(std::istringstream& tokens);
+
+  /* Writes the "info" lines for a finished depth of the Search. */
+  void sendInfo(SearchResult const& result);
+
+  /* Finds the legal move in position written as text in UCI form, e.g.
+     "e2e4", and puts it in move. Returns false if text is not a legal
+     move. */
+  bool findMove(ChessBoard& position, std::string const& text, Move& move);
+
+  /* Returns move written in UCI form, e.g. "e2e4". */
+  static std::string formatMove(Move move);
+};
+
+#endif
@@ -0,0 +1,19 @@
+/* This file contains the main function of the uci executable, which lets
+   the engine be used by chess programs that speak the Universal Chess
+   Interface protocol over the standard input and output. For example:
+   >> uci
+   << id name Chess
+   ...
+   >> position startpos moves e2e4
+   >> go depth 4 */
+
+#include "Uci.h"
+#include <iostream>
+
+using namespace std;
+
+int main() {
+  Uci uci{cin, cout};
+  uci.run();
+  return 0;
+}
@@ -0,0 +1,108 @@
+/* This file contains the main function of the validate tool, which plays
+   games on the fast rules engine, GameState, and the reference one,
+   ChessBoard, at once and stops at the first position where they
+   disagree. Usage:
+   >> validate random 1000000
+   >> validate random 1000000000 8 42
+   >> validate corpus games.gdb 8
+   random plays the input number of games of random moves, in batches of
+   VALIDATE_BATCH_GAMES with a line of progress after each, from the seed
+   given last, or VALIDATE_DEFAULT_SEED. corpus replays every game of a
+   game database. The number after the games or the file is the number of
+   threads. If it is left out, one thread is used for every core. The exit
+   code is 1 if the engines disagree. */
+
+#include "Validator.h"
+#include "GameDatabase.h"
+#include "Move.h"
+#include "errors.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Number of random games played between lines of progress
+const long long VALIDATE_BATCH_GAMES = 100000;
+
+// Seed of the random games if none is given
+const uint64_t VALIDATE_DEFAULT_SEED = 1;
+
+/* Outputs the totals of result, which took milliseconds altogether. */
+static void printTotals(ValidationResult const& result,
+			long long milliseconds) {
+  cout << result.games << " games, " << result.positions << " positions in ";
+  cout << milliseconds << " ms, " << result.positions * 1000 /
+    max(milliseconds, 1LL) << " positions per second" << endl;
+}
+
+/* Outputs the mismatch of result. Returns the exit code of the program. */
+static int printMismatch(ValidationResult const& result) {
+  ValidationMismatch const& mismatch = result.mismatch;
+  cout << "Mismatch in game " << mismatch.game << " after ";
+  cout << mismatch.line.size() << " plies:" << endl << mismatch.difference;
+  cout << "Position: " << mismatch.fen << endl;
+  cout << ((mismatch.isReproducedFromFen) ? "The position alone shows it" :
+	   "The position alone does not show it, play the moves") << endl;
+  cout << "Moves:";
+  for (Move const& move : mismatch.line) {
+    cout << " " << move;
+  }
+  cout << endl;
+  return 1;
+}
+
+int main(int argc, char* argv[]) {
+  string command = (argc > 1) ? argv[1] : "";
+  if (!((command == "random" && argc >= 3 && argc <= 5) ||
+	(command == "corpus" && argc >= 3 && argc <= 4))) {
+    cerr << "Usage: validate random <games> [threads] [seed]" << endl;
+    cerr << "       validate corpus <database file> [threads]" << endl;
+    return 1;
+  }
+
+  int threadCount = 0;
+  long long gameCount = 0;
+  uint64_t seed = VALIDATE_DEFAULT_SEED;
+  try {
+    threadCount = (argc >= 4) ? stoi(argv[3]) : 0;
+    if (command == "random") {
+      gameCount = stoll(argv[2]);
+      seed = (argc == 5) ? stoull(argv[4]) : seed;
+    }
+  } catch (exception const& e) {
+    cerr << "The games, threads and seed must be numbers!" << endl;
+    return 1;
+  }
+
+  Validator validator{threadCount};
+  cout << "Validating with " << validator.getThreadCount() << " thread(s)";
+  cout << endl;
+  if (command == "corpus") {
+    try {
+      GameDatabase database{argv[2]};
+      ValidationResult result = validator.replayGames(database);
+      printTotals(result, result.milliseconds);
+      return (result.isMismatchFound) ? printMismatch(result) : 0;
+    } catch (GameDatabaseError const& e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+  }
+
+  ValidationResult total;
+  for (long long first = 0; first < gameCount;
+       first += VALIDATE_BATCH_GAMES) {
+    long long batch = min(VALIDATE_BATCH_GAMES, gameCount - first);
+    ValidationResult result = validator.playRandomGames(first, batch, seed);
+    total.games += result.games;
+    total.positions += result.positions;
+    total.milliseconds += result.milliseconds;
+    printTotals(total, total.milliseconds);
+    if (result.isMismatchFound) {
+      return printMismatch(result);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,294 @@
+/* This file contains the member functions of the Validator class. */
+
+#include "Validator.h"
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "GameDatabase.h"
+#include "GameStatus.h"
+#include "Move.h"
+#include "Player.h"
+#include "constants.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* Returns a well mixed 64 bit number made from the input one, by the
+   finaliser of the SplitMix64 generator. */
+static uint64_t mix(uint64_t value) {
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+/* Puts moves in order of their bits, so that two lists can be compared. */
+static void sortMoves(Move* first, Move* last) {
+  sort(first, last, [](Move a, Move b) { return a.getBits() < b.getBits(); });
+}
+
+/* Outputs the moves in [first, last) which are not in [otherFirst,
+   otherLast) to os, each after a space. Both must be sorted. Returns false
+   if there are none. */
+static bool printMissing(ostream& os, Move const* first, Move const* last,
+			 Move const* otherFirst, Move const* otherLast) {
+  bool isAny = false;
+  while (first != last) {
+    while (otherFirst != otherLast &&
+	   otherFirst->getBits() < first->getBits()) {
+      otherFirst++;
+    }
+    if (otherFirst == otherLast || !(*otherFirst == *first)) {
+      os << " " << *first;
+      isAny = true;
+    }
+    first++;
+  }
+  return isAny;
+}
+
+// ---------- Contructors, destructors and operator overloads ------------------
+
+Validator::Validator(int threadCount) : threadCount(threadCount) {
+  if (this->threadCount < 1) {
+    this->threadCount = static_cast<int>(thread::hardware_concurrency());
+  }
+  if (this->threadCount < 1) {
+    this->threadCount = 1;
+  }
+}
+
+// ---------- Getter functions -------------------------------------------------
+
+int Validator::getThreadCount() const {
+  return threadCount;
+}
+
+// ---------- Other functions --------------------------------------------------
+
+ValidationResult Validator::playRandomGames(long long firstGame,
+					    long long gameCount,
+					    uint64_t seed) {
+  return run(firstGame, gameCount, [seed](long long game, int ply,
+					   GameState const& state, Move& move) {
+    if (ply >= VALIDATE_MAX_PLIES || isGameOver(state.getStatus())) {
+      return false;
+    }
+    Move moves[MAX_MOVES];
+    int moveCount = state.getLegalMoves(moves);
+    if (moveCount == 0) {
+      return false;
+    }
+
+    // The move depends only on the seed, the game and the ply
+    uint64_t random = mix(mix(seed ^ static_cast<uint64_t>(game)) ^
+			  static_cast<uint64_t>(ply));
+    move = moves[random % static_cast<uint64_t>(moveCount)];
+    return true;
+  });
+}
+
+ValidationResult Validator::replayGames(GameDatabase const& database) {
+  long long gameCount = static_cast<long long>(database.getGameCount());
+  return run(0, gameCount, [&database](long long game, int ply,
+				       GameState const& state, Move& move) {
+    int plyCount = 0;
+    uint8_t const* indices = database.getMoveIndices(game, plyCount);
+    if (ply >= plyCount || isGameOver(state.getStatus())) {
+      return false;
+    }
+    Move moves[MAX_MOVES];
+    int moveCount = state.getLegalMoves(moves);
+    if (indices[ply] >= moveCount) {
+      throw GameDatabaseError{database.getFileName(), "has a move of game " +
+			      to_string(game) + " which is not legal"};
+    }
+    move = moves[indices[ply]];
+    return true;
+  });
+}
+
+string Validator::compare(ChessBoard& board, GameState const& state) {
+  ostringstream difference;
+  if (board.getHash() != state.getHash()) {
+    difference << "The positions differ: ChessBoard has " << board.getFen();
+    difference << " and GameState has " << state.getFen() << endl;
+    return difference.str();
+  }
+
+  // Moves
+  vector<Move> referenceMoves = board.getLegalMoves();
+  Move fastMoves[MAX_MOVES];
+  int fastMoveCount = state.getLegalMoves(fastMoves);
+  sortMoves(referenceMoves.data(),
+	    referenceMoves.data() + referenceMoves.size());
+  sortMoves(fastMoves, fastMoves + fastMoveCount);
+  ostringstream missing;
+  if (printMissing(missing, referenceMoves.data(),
+		   referenceMoves.data() + referenceMoves.size(), fastMoves,
+		   fastMoves + fastMoveCount)) {
+    difference << "Legal for ChessBoard only:" << missing.str() << endl;
+  }
+  missing.str("");
+  if (printMissing(missing, fastMoves, fastMoves + fastMoveCount,
+		   referenceMoves.data(),
+		   referenceMoves.data() + referenceMoves.size())) {
+    difference << "Legal for GameState only:" << missing.str() << endl;
+  }
+
+  int referenceCount = board.countLegalMoves();
+  if (referenceCount != static_cast<int>(referenceMoves.size())) {
+    difference << "ChessBoard counts " << referenceCount << " legal moves ";
+    difference << "but lists " << referenceMoves.size() << endl;
+  }
+
+  // Check and status
+  Player player = board.getPlayer();
+  bool isReferenceCheck = board.isPlayerInCheck(player);
+  if (isReferenceCheck != state.isInCheck(player)) {
+    difference << "Only " << ((isReferenceCheck) ? "ChessBoard" : "GameState");
+    difference << " finds " << player << " in check" << endl;
+  }
+  GameStatus referenceStatus = getReferenceStatus(board);
+  if (referenceStatus != state.getStatus()) {
+    difference << "ChessBoard finds " << referenceStatus << " but GameState ";
+    difference << "finds " << state.getStatus() << endl;
+  }
+  bool isNoMoveStatus = (referenceStatus == Checkmate ||
+			 referenceStatus == Stalemate);
+  if (isNoMoveStatus != referenceMoves.empty()) {
+    difference << "ChessBoard finds " << referenceStatus << " with ";
+    difference << referenceMoves.size() << " legal moves" << endl;
+  }
+  return difference.str();
+}
+
+// ---------- Helper functions -------------------------------------------------
+
+template <typename GetMove>
+ValidationResult Validator::run(long long firstGame, long long gameCount,
+				GetMove const& getMove) {
+  ValidationResult result;
+
+  // Games are handed out in order and a thread only stops between games,
+  // so every game before the one a mismatch is found in is finished, and
+  // the mismatch kept is the one in the first game with any
+  atomic<long long> nextGame{0};
+  atomic<bool> isStopped{false};
+  mutex resultMutex;
+  exception_ptr error;
+  auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (int i = 0; i < threadCount && i < gameCount; i++) {
+    threads.emplace_back([&] {
+      ChessBoard board{START_FEN};
+      GameState state;
+      vector<Move> line;
+      long long games = 0;
+      long long positions = 0;
+      try {
+	long long index;
+	while (!isStopped.load(memory_order_relaxed) &&
+	       (index = nextGame.fetch_add(1)) < gameCount) {
+	  long long game = firstGame + index;
+	  board.setPosition(START_FEN);
+	  state = GameState{};
+	  line.clear();
+	  for (int ply = 0; ; ply++) {
+	    string difference = compare(board, state);
+	    positions++;
+	    Move move;
+	    if (difference.empty()) {
+	      if (!getMove(game, ply, state, move)) {
+		games++;
+		break;
+	      }
+	      MoveResult moveResult = state.submitMove(move);
+	      if (moveResult == MoveAccepted) {
+		board.playMove(move);
+		line.push_back(move);
+
+		// A GameState does not swap the player over after a move
+		// which ends the game, so the last position is set up again
+		// with the opponent to move, as it is on board
+		if (isGameOver(state.getStatus())) {
+		  state = GameState{board.getFen()};
+		}
+		continue;
+	      }
+	      ostringstream refusal;
+	      refusal << "GameState refuses its own legal move " << move;
+	      refusal << ": " << moveResult << endl;
+	      difference = refusal.str();
+	    }
+
+	    lock_guard<mutex> lock{resultMutex};
+	    if (!result.isMismatchFound || game < result.mismatch.game) {
+	      result.isMismatchFound = true;
+	      result.mismatch.game = game;
+	      result.mismatch.line = line;
+	      result.mismatch.fen = board.getFen();
+	      result.mismatch.difference = difference;
+	    }
+	    isStopped = true;
+	    break;
+	  }
+	}
+      } catch (...) {
+	lock_guard<mutex> lock{resultMutex};
+	if (!error) {
+	  error = current_exception();
+	}
+	isStopped = true;
+      }
+      lock_guard<mutex> lock{resultMutex};
+      result.games += games;
+      result.positions += positions;
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  if (error) {
+    rethrow_exception(error);
+  }
+  result.milliseconds = chrono::duration_cast<chrono::milliseconds>(
+    chrono::steady_clock::now() - start).count();
+
+  // The history of the game is lost in the FEN, e.g. which Pawns have
+  // moved, so check whether the position alone shows the mismatch
+  if (result.isMismatchFound) {
+    try {
+      ChessBoard board{result.mismatch.fen};
+      GameState state{result.mismatch.fen};
+      result.mismatch.isReproducedFromFen = !compare(board, state).empty();
+    } catch (FenError const& e) {
+      result.mismatch.isReproducedFromFen = false;
+    }
+  }
+  return result;
+}
+
+GameStatus Validator::getReferenceStatus(ChessBoard& board) {
+  Player player = board.getPlayer();
+  bool isCheck = board.isPlayerInCheck(player);
+  if (isCheck && board.isPlayerInCheckmate(player)) {
+    return Checkmate;
+  }
+  if (!isCheck && board.isPlayerInStalemate(player)) {
+    return Stalemate;
+  }
+  if (board.isFiftyMoveRuleDraw()) {
+    return FiftyMoveRule;
+  }
+  return (isCheck) ? Check : InProgress;
+}
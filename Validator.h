@@ -0,0 +1,117 @@
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include "ChessBoard.h"
+#include "GameState.h"
+#include "GameDatabase.h"
+#include "Move.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Most plies a random game may last before the next one is started
+const int VALIDATE_MAX_PLIES = 400;
+
+/* The ValidationMismatch struct describes the first position found where
+   the two rules engines disagree.
+   game is the number of the game it was found in.
+   line is the moves of that game from the starting position to it.
+   fen is the position, in Forsyth-Edwards Notation.
+   difference describes what the engines disagree about, one thing per
+   line.
+   isReproducedFromFen is true if the engines also disagree when the
+   position is set up from fen alone, so that fen is enough to reproduce
+   it. Otherwise the line must be played to reach it. */
+
+struct ValidationMismatch {
+  long long game = 0;
+  std::vector<Move> line;
+  std::string fen;
+  std::string difference;
+  bool isReproducedFromFen = false;
+};
+
+/* The ValidationResult struct holds the outcome of a validation run.
+   games and positions are the numbers of games played and of positions
+   compared, counting only games which were finished.
+   milliseconds is the time the run took.
+   isMismatchFound is true if the engines disagreed, in which case the run
+   was stopped and mismatch is the first position they disagreed on. */
+
+struct ValidationResult {
+  long long games = 0;
+  long long positions = 0;
+  long long milliseconds = 0;
+  bool isMismatchFound = false;
+  ValidationMismatch mismatch;
+};
+
+/* The Validator class checks that the fast rules engine, GameState, which
+   generates moves with Bitboards, agrees with the reference one, ChessBoard,
+   whose moves are the ones Piece::isMovePossible() allows and its
+   isMoveLegal() keeps. It plays games on both at once and compares them at
+   every position: the Zobrist hash, the set of legal moves, whether the
+   player to move is in check, and the GameStatus, with ChessBoard's found
+   by its own check, checkmate and stalemate tests. It also checks that
+   ChessBoard's checkmate and stalemate tests, which look for a move that
+   gets out of check or count the moves rather than generating every move,
+   and ChessBoard::countLegalMoves() agree with its own list of legal
+   moves.
+   The games are shared out between a pool of threads, each with its own
+   ChessBoard and GameState, and every thread stops as soon as one of them
+   finds a mismatch. */
+
+class Validator {
+public:
+  // ---------- Contructors, destructors and operator overloads ----------------
+
+  /* Constructs a Validator object which plays games on threadCount threads.
+     If threadCount is less than 1, one thread is used for every core. */
+  Validator(int threadCount = 0);
+
+  // ---------- Getter functions -----------------------------------------------
+
+  /* Returns the number of threads the games are played on. */
+  int getThreadCount() const;
+
+  // ---------- Other functions ------------------------------------------------
+
+  /* Plays gameCount games of random legal moves from the starting position,
+     numbered from firstGame, and compares the engines at every position.
+     The moves of game i depend only on seed and i, so a game can be played
+     again on its own, whatever the number of threads. A game ends when it
+     is over or after VALIDATE_MAX_PLIES plies. */
+  ValidationResult playRandomGames(long long firstGame, long long gameCount,
+				   uint64_t seed);
+
+  /* Replays every game of database and compares the engines at every
+     position. Throws the GameDatabaseError exception defined in "errors.h"
+     if a game cannot be decoded. */
+  ValidationResult replayGames(GameDatabase const& database);
+
+  /* Compares the engines in the position of board and state, which must be
+     the same one. Returns a description of each thing they disagree about,
+     one per line, or an empty string if they agree. */
+  static std::string compare(ChessBoard& board, GameState const& state);
+
+private:
+  int threadCount;
+
+  // ---------- Helper functions -----------------------------------------------
+
+  /* Plays gameCount games numbered from firstGame on the pool of threads.
+     getMove(game, ply, state, move) is called at each position where the
+     engines agree, and puts the next move of the game into move, or
+     returns false to end the game there. */
+  template <typename GetMove>
+  ValidationResult run(long long firstGame, long long gameCount,
+		       GetMove const& getMove);
+
+  /* Returns the GameStatus of the player to move on board, worked out by
+     ChessBoard's check, checkmate and stalemate tests and the fifty-move
+     rule. Repetitions are not looked for, as GameState does not keep the
+     positions it needs to find them. */
+  static GameStatus getReferenceStatus(ChessBoard& board);
+};
+
+#endif
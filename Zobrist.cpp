@@ -0,0 +1,64 @@
+/* This file contains the Zobrist keys and the functions declared in 
+   "Zobrist.h". */
+
+#include "Zobrist.h"
+#include "Player.h"
+#include "PieceType.h"
+#include "Bitboard.h"
+
+using namespace std;
+
+// ---------- Keys -------------------------------------------------------------
+
+/* The keys are made at compile time, so they are ready before any
+   ChessBoard is constructed, and they are the same in every build. */
+
+struct ZobristKeys {
+  HashKey pieces[2][PIECE_TYPE_COUNT][NUMBER_OF_SQUARES];
+  HashKey castling[16];
+  HashKey blackToMove;
+};
+
+/* Returns the next number of the SplitMix64 generator whose state is 
+   state. */
+static constexpr HashKey nextRandom(HashKey& state) {
+  state += 0x9E3779B97F4A7C15ULL;
+  HashKey z = state;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static constexpr ZobristKeys makeKeys() {
+  ZobristKeys keys{};
+  HashKey state = 0x5EED;
+  for (int c = 0; c < 2; c++) {
+    for (int t = 0; t < PIECE_TYPE_COUNT; t++) {
+      for (int s = 0; s < NUMBER_OF_SQUARES; s++) {
+	keys.pieces[c][t][s] = nextRandom(state);
+      }
+    }
+  }
+  // No castling rights leaves the hash unchanged
+  for (int i = 1; i < 16; i++) {
+    keys.castling[i] = nextRandom(state);
+  }
+  keys.blackToMove = nextRandom(state);
+  return keys;
+}
+
+static constexpr ZobristKeys zobristKeys = makeKeys();
+
+// ---------- Key functions ----------------------------------------------------
+
+HashKey pieceKey(Player colour, PieceType type, int squareIndex) {
+  return zobristKeys.pieces[colour][type][squareIndex];
+}
+
+HashKey castlingKey(int castlingRights) {
+  return zobristKeys.castling[castlingRights];
+}
+
+HashKey blackToMoveKey() {
+  return zobristKeys.blackToMove;
+}
@@ -0,0 +1,36 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Player.h"
+#include "PieceType.h"
+#include <cstdint>
+
+/* A HashKey is a 64 bit Zobrist hash of a position. Each Piece on each
+   square, each set of castling rights and the player to move has its own
+   random key, and the hash of a position is the XOR of the keys of 
+   everything in it. Making a move only changes a few keys, so the hash can
+   be updated as the move is made instead of being worked out again.
+   ChessBoard and GameState use the same keys, so the same position has the
+   same hash in both. */
+
+typedef uint64_t HashKey;
+
+// Bits of a set of castling rights, in the same order as the castling
+// field of Forsyth-Edwards Notation ("KQkq")
+const int WHITE_KINGSIDE_CASTLE = 1;
+const int WHITE_QUEENSIDE_CASTLE = 2;
+const int BLACK_KINGSIDE_CASTLE = 4;
+const int BLACK_QUEENSIDE_CASTLE = 8;
+
+/* Returns the key of a Piece of the input colour and type on the square
+   with the input index. */
+HashKey pieceKey(Player colour, PieceType type, int squareIndex);
+
+/* Returns the key of the input set of castling rights, made of the bits
+   above. */
+HashKey castlingKey(int castlingRights);
+
+/* Returns the key which is in the hash when Black is to move. */
+HashKey blackToMoveKey();
+
+#endif
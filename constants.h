@@ -25,6 +25,11 @@ const int FILE_INDEX = 0;
 const int RANK_TWO = 1;
 const int RANK_SEVEN = 6;
 
+// Files the King and the Rooks start on
+const int KING_START_FILE = 4;
+const int KINGSIDE_ROOK_START_FILE = 7;
+const int QUEENSIDE_ROOK_START_FILE = 0;
+
 /* Starting positions for pieces on board*/
 const std::string WHITE_KING_START_SQUARE = "E1";
 const std::string BLACK_KING_START_SQUARE = "E8";
@@ -47,4 +52,19 @@ const std::string WHITE_QUEEN_BISHOP = "C1";
 const std::string BLACK_KING_BISHOP = "F8";
 const std::string BLACK_QUEEN_BISHOP = "C8";
 
+// FEN (Forsyth-Edwards Notation) of the starting position
+const std::string START_FEN =
+  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/* Values of the Pieces in centipawns, used to evaluate positions */
+const int PAWN_VALUE = 100;
+const int KNIGHT_VALUE = 300;
+const int BISHOP_VALUE = 300;
+const int ROOK_VALUE = 500;
+const int QUEEN_VALUE = 900;
+
+// Number of halfmoves without a capture or a Pawn move after which the game
+// is drawn by the fifty-move rule
+const int FIFTY_MOVE_HALFMOVES = 100;
+
 #endif
@@ -1,5 +1,5 @@
 /* This file contains the member function definitions for the derived exception 
-   class OffBoardError in "errors.h". */
+   classes in "errors.h". */
 
 #include "errors.h"
 #include <exception>
@@ -18,3 +18,104 @@ OffBoardError::OffBoardError(string const& square) noexcept {
 const char* OffBoardError::what() const noexcept {
   return explanation.c_str();
 }
+
+// ---------- BitbaseError -----------------------------------------------------
+
+BitbaseError::BitbaseError() noexcept {}
+
+BitbaseError::BitbaseError(string const& fileName,
+			   string const& problem) noexcept {
+  explanation = "Bitbase file " + fileName + " " + problem;
+}
+
+const char* BitbaseError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- FenError ---------------------------------------------------------
+
+FenError::FenError() noexcept {}
+
+FenError::FenError(string const& fen, string const& problem) noexcept {
+  explanation = "\"" + fen + "\" is not a valid position, " + problem;
+}
+
+const char* FenError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- SessionError -----------------------------------------------------
+
+SessionError::SessionError() noexcept {}
+
+SessionError::SessionError(unsigned id) noexcept {
+  explanation = "Game " + to_string(id) + " does not exist";
+}
+
+const char* SessionError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- SanError ---------------------------------------------------------
+
+SanError::SanError() noexcept {}
+
+SanError::SanError(string const& san, string const& problem) noexcept {
+  explanation = "\"" + san + "\" is not a legal move, " + problem;
+}
+
+const char* SanError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- OpeningsError ----------------------------------------------------
+
+OpeningsError::OpeningsError() noexcept {}
+
+OpeningsError::OpeningsError(string const& fileName,
+			     string const& problem) noexcept {
+  explanation = "Openings file " + fileName + " " + problem;
+}
+
+const char* OpeningsError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- PuzzleError ------------------------------------------------------
+
+PuzzleError::PuzzleError() noexcept {}
+
+PuzzleError::PuzzleError(string const& fileName,
+			 string const& problem) noexcept {
+  explanation = "Puzzle file " + fileName + " " + problem;
+}
+
+const char* PuzzleError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- GameDatabaseError ------------------------------------------------
+
+GameDatabaseError::GameDatabaseError() noexcept {}
+
+GameDatabaseError::GameDatabaseError(string const& fileName,
+				     string const& problem) noexcept {
+  explanation = "Game database " + fileName + " " + problem;
+}
+
+const char* GameDatabaseError::what() const noexcept {
+  return explanation.c_str();
+}
+
+// ---------- PositionIndexError -----------------------------------------------
+
+PositionIndexError::PositionIndexError() noexcept {}
+
+PositionIndexError::PositionIndexError(string const& fileName,
+				       string const& problem) noexcept {
+  explanation = "Position index " + fileName + " " + problem;
+}
+
+const char* PositionIndexError::what() const noexcept {
+  return explanation.c_str();
+}
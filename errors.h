@@ -21,4 +21,154 @@ private:
   std::string explanation;
 };
 
+// ---------- BitbaseError -----------------------------------------------------
+
+class BitbaseError : public std::exception {
+public:
+  /* Constructs BitbaseError object with an uninitialised explanation string */
+  BitbaseError() noexcept;
+
+  /* Constructs BitbaseError object with the explanation string initialised
+     to: "Bitbase file " + fileName + " " + problem. For example: 
+     "Bitbase file KPK.bb could not be opened". */
+  BitbaseError(std::string const& fileName,
+	       std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- FenError ---------------------------------------------------------
+
+class FenError : public std::exception {
+public:
+  /* Constructs FenError object with an uninitialised explanation string */
+  FenError() noexcept;
+
+  /* Constructs FenError object with the explanation string initialised
+     to: "\"" + fen + "\" is not a valid position, " + problem. */
+  FenError(std::string const& fen, std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- SessionError -----------------------------------------------------
+
+class SessionError : public std::exception {
+public:
+  /* Constructs SessionError object with an uninitialised explanation string */
+  SessionError() noexcept;
+
+  /* Constructs SessionError object with the explanation string initialised
+     to: "Game " + id + " does not exist". */
+  SessionError(unsigned id) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- SanError ---------------------------------------------------------
+
+class SanError : public std::exception {
+public:
+  /* Constructs SanError object with an uninitialised explanation string */
+  SanError() noexcept;
+
+  /* Constructs SanError object with the explanation string initialised
+     to: "\"" + san + "\" is not a legal move, " + problem. */
+  SanError(std::string const& san, std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- OpeningsError ----------------------------------------------------
+
+class OpeningsError : public std::exception {
+public:
+  /* Constructs OpeningsError object with an uninitialised explanation
+     string */
+  OpeningsError() noexcept;
+
+  /* Constructs OpeningsError object with the explanation string initialised
+     to: "Openings file " + fileName + " " + problem. For example:
+     "Openings file book.epd could not be opened". */
+  OpeningsError(std::string const& fileName,
+		std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- PuzzleError ------------------------------------------------------
+
+class PuzzleError : public std::exception {
+public:
+  /* Constructs PuzzleError object with an uninitialised explanation
+     string */
+  PuzzleError() noexcept;
+
+  /* Constructs PuzzleError object with the explanation string initialised
+     to: "Puzzle file " + fileName + " " + problem. For example:
+     "Puzzle file mates.epd could not be opened". */
+  PuzzleError(std::string const& fileName,
+	      std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- GameDatabaseError ------------------------------------------------
+
+class GameDatabaseError : public std::exception {
+public:
+  /* Constructs GameDatabaseError object with an uninitialised explanation
+     string */
+  GameDatabaseError() noexcept;
+
+  /* Constructs GameDatabaseError object with the explanation string
+     initialised to: "Game database " + fileName + " " + problem. For
+     example: "Game database games.gdb could not be opened". */
+  GameDatabaseError(std::string const& fileName,
+		    std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
+// ---------- PositionIndexError -----------------------------------------------
+
+class PositionIndexError : public std::exception {
+public:
+  /* Constructs PositionIndexError object with an uninitialised explanation
+     string */
+  PositionIndexError() noexcept;
+
+  /* Constructs PositionIndexError object with the explanation string
+     initialised to: "Position index " + fileName + " " + problem. For
+     example: "Position index games.gdx could not be opened". */
+  PositionIndexError(std::string const& fileName,
+		     std::string const& problem) noexcept;
+
+  /* Returns a pointer to a c string containing the explanation message. */
+  const char* what() const noexcept override;
+private:
+  std::string explanation;
+};
+
 #endif